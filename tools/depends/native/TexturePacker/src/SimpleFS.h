@@ -71,6 +71,11 @@ public:
     return 0;
   }
   
+  static bool Delete(const std::string &file)
+  {
+    return remove(file.c_str()) == 0;
+  }
+
   FILE *getFP()
   {
     return m_file;
@@ -49,6 +49,7 @@
 using namespace std;
 
 #define FLAGS_USE_LZO     1
+#define FLAGS_USE_LZ4     2
 
 #define DIR_SEPARATOR "/"
 
@@ -139,7 +140,26 @@ CXBTFFrame appendContent(CXBTFWriter &writer, int width, int height, unsigned ch
   CXBTFFrame frame;
   lzo_uint packedSize = size;
 
-  if ((flags & FLAGS_USE_LZO) == FLAGS_USE_LZO)
+  if ((flags & FLAGS_USE_LZ4) == FLAGS_USE_LZ4)
+  {
+    // packs a little worse than lzo, but unpacks several times faster when the skin loads
+    size_t bound = CXBTFLZ4::CompressBound(size);
+    unsigned char *packed = new unsigned char[bound];
+    packedSize = CXBTFLZ4::Compress(data, size, packed, bound);
+    if (packedSize == 0 || packedSize >= size)
+    {
+      // compressed size is bigger than uncompressed, so store as uncompressed
+      packedSize = size;
+      writer.AppendContent(data, size);
+    }
+    else
+    {
+      writer.AppendContent(packed, packedSize);
+      format |= XB_FMT_LZ4;
+    }
+    delete[] packed;
+  }
+  else if ((flags & FLAGS_USE_LZO) == FLAGS_USE_LZO)
   {
     // grab a temporary buffer for unpacking into
     packedSize = size + size / 16 + 64 + 3; // see simple.c in lzo
@@ -219,6 +239,7 @@ void Usage()
   puts("  -input <dir>     Input directory. Default: current dir");
   puts("  -output <dir>    Output directory/filename. Default: Textures.xbt");
   puts("  -dupecheck       Enable duplicate file detection. Reduces output file size. Default: off");
+  puts("  -lz4             Pack with LZ4 rather than LZO. Faster skin loading, larger file. Default: off");
 }
 
 static bool checkDupe(struct MD5Context* ctx,
@@ -381,6 +402,10 @@ int main(int argc, char* argv[])
     {
       dupecheck = true;
     }
+    else if (!platform_stricmp(args[i], "-lz4"))
+    {
+      flags = FLAGS_USE_LZ4;
+    }
     else if (!platform_stricmp(args[i], "-output") || !platform_stricmp(args[i], "-o"))
     {
       OutputFilename = args[++i];
@@ -2071,6 +2071,7 @@ void CApplication::Render()
   }
 
   g_graphicsContext.Flip(hasRendered, m_pPlayer->IsRenderingVideoLayer());
+  m_pPlayer->FrameFinish();
 
   CTimeUtils::UpdateFrameTime(hasRendered);
 }
@@ -4667,6 +4668,11 @@ void CApplication::Process()
   // update sound
   m_pPlayer->DoAudioWork();
 
+  // evict unused textures early rather than on their timeout when over the texture memory budget,
+  // freeing the GL textures they leave behind
+  if (CTextureBudget::GetInstance().Enforce())
+    g_TextureManager.FreeUnusedTextures(5000);
+
   // do any processing that isn't needed on each run
   if( m_slowTimer.GetElapsedMilliseconds() > 500 )
   {
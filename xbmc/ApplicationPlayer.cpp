@@ -748,6 +748,13 @@ void CApplicationPlayer::Render(bool clear, uint32_t alpha, bool gui)
     player->Render(clear, alpha, gui);
 }
 
+void CApplicationPlayer::FrameFinish()
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    player->FrameFinish();
+}
+
 void CApplicationPlayer::FlushRenderer()
 {
   std::shared_ptr<IPlayer> player = GetInternal();
@@ -873,6 +880,15 @@ bool CApplicationPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned
     return false;
 }
 
+bool CApplicationPlayer::GetFramePacing(CVariant &pacing)
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    return player->GetFramePacing(pacing);
+  else
+    return false;
+}
+
 bool CApplicationPlayer::IsExternalPlaying()
 {
   std::shared_ptr<IPlayer> player = GetInternal();
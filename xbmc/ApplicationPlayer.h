@@ -45,6 +45,7 @@ namespace PVR
 class CAction;
 class CPlayerOptions;
 class CStreamDetails;
+class CVariant;
 
 struct SPlayerAudioStreamInfo;
 struct SPlayerVideoStreamInfo;
@@ -84,6 +85,7 @@ public:
 
   void FrameMove();
   void Render(bool clear, uint32_t alpha = 255, bool gui = true);
+  void FrameFinish();
   void FlushRenderer();
   void SetRenderViewMode(int mode);
   float GetRenderAspectRatio();
@@ -99,6 +101,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags = 0);
   void RenderCaptureRelease(unsigned int captureId);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
+  bool GetFramePacing(CVariant &pacing);
   bool IsExternalPlaying();
 
   // proxy calls
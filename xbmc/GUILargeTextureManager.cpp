@@ -26,9 +26,11 @@
 #include "utils/TimeUtils.h"
 #include "utils/JobManager.h"
 #include "guilib/GraphicContext.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "TextureCache.h"
 
+#include <algorithm>
 #include <cassert>
 
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
@@ -91,11 +93,13 @@ CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path):
 {
   m_refCount = 1;
   m_timeToDelete = 0;
+  m_releaseTime = 0;
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
 {
   assert(m_refCount == 0);
+  CTextureBudget::GetInstance().Freed(GetMemoryUsage());
   m_texture.Free();
 }
 
@@ -110,6 +114,7 @@ bool CGUILargeTextureManager::CLargeTexture::DecrRef(bool deleteImmediately)
   m_refCount--;
   if (m_refCount == 0)
   {
+    m_releaseTime = XbmcThreads::SystemClockMillis();
     if (deleteImmediately)
       delete this;
     else
@@ -134,14 +139,26 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
   assert(!m_texture.size());
   if (texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+  CTextureBudget::GetInstance().Allocated(GetMemoryUsage());
+}
+
+size_t CGUILargeTextureManager::CLargeTexture::GetMemoryUsage() const
+{
+  size_t memory = 0;
+  for (std::vector<CBaseTexture*>::const_iterator it = m_texture.m_textures.begin(); it != m_texture.m_textures.end(); ++it)
+    memory += (*it)->GetPitch() * (*it)->GetRows();
+  return memory;
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
+  m_averageImageMemory = 0;
+  CTextureBudget::GetInstance().RegisterPool("large", this);
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
 {
+  CTextureBudget::GetInstance().UnregisterPool(this);
 }
 
 void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
@@ -159,6 +176,54 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
   }
 }
 
+std::vector<CGUILargeTextureManager::CLargeTexture *>::iterator CGUILargeTextureManager::FindLeastRecentlyUsed()
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  listIterator oldest = m_allocated.end();
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if (!(*it)->IsReferenced() &&
+        (oldest == m_allocated.end() || now - (*it)->GetReleaseTime() > now - (*oldest)->GetReleaseTime()))
+      oldest = it;
+  }
+  return oldest;
+}
+
+bool CGUILargeTextureManager::GetLeastRecentlyUsed(unsigned int &releaseTime)
+{
+  CSingleLock lock(m_listSection);
+  listIterator oldest = FindLeastRecentlyUsed();
+  if (oldest == m_allocated.end())
+    return false;
+  releaseTime = (*oldest)->GetReleaseTime();
+  return true;
+}
+
+size_t CGUILargeTextureManager::FreeLeastRecentlyUsed()
+{
+  CSingleLock lock(m_listSection);
+  listIterator oldest = FindLeastRecentlyUsed();
+  if (oldest == m_allocated.end())
+    return 0;
+  size_t memory = (*oldest)->GetMemoryUsage();
+  (*oldest)->DeleteIfRequired(true);
+  m_allocated.erase(oldest);
+  return memory;
+}
+
+void CGUILargeTextureManager::GetMemoryUsage(size_t &used, size_t &unused)
+{
+  CSingleLock lock(m_listSection);
+  used = unused = 0;
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    size_t memory = (*it)->GetMemoryUsage();
+    used += memory;
+    if (!(*it)->IsReferenced())
+      unused += memory;
+  }
+}
+
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
 bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache)
@@ -203,6 +268,7 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
     {
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
+      m_prefetchJobs.erase(id);
       m_queued.erase(it);
       return;
     }
@@ -210,7 +276,7 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
 }
 
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
+void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache, CJob::PRIORITY priority)
 {
   if (path.empty())
     return;
@@ -222,16 +288,91 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
     if (image->GetPath() == path)
     {
       image->AddRef();
+      if (priority != CJob::PRIORITY_LOW && m_prefetchJobs.erase(it->first))
+      { // prefetched image now wanted on screen, requeue at the requested priority
+        CJobManager::GetInstance().CancelJob(it->first);
+        it->first = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, priority);
+      }
       return; // already queued
     }
   }
 
   // queue the item
   CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, priority);
+  if (priority == CJob::PRIORITY_LOW)
+    m_prefetchJobs.insert(jobID);
   m_queued.push_back(std::make_pair(jobID, image));
 }
 
+void CGUILargeTextureManager::PrefetchImages(const void *owner, const std::vector<std::string> &images)
+{
+  CSingleLock lock(m_listSection);
+
+  // the budget is shared with the images held for other owners
+  size_t budget = (size_t)g_advancedSettings.m_imagePrefetchMemory * 1024 * 1024;
+  size_t used = 0;
+  for (std::map<const void *, std::vector<std::string> >::const_iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+  {
+    if (it->first == owner)
+      continue;
+    for (std::vector<std::string>::const_iterator path = it->second.begin(); path != it->second.end(); ++path)
+      used += GetImageMemory(*path);
+  }
+
+  std::vector<std::string> wanted;
+  for (std::vector<std::string>::const_iterator it = images.begin(); it != images.end(); ++it)
+  {
+    if (it->empty() || g_TextureManager.CanLoad(*it) ||
+        std::find(wanted.begin(), wanted.end(), *it) != wanted.end())
+      continue;
+    size_t memory = GetImageMemory(*it);
+    if (used + memory > budget)
+      break;
+    used += memory;
+    wanted.push_back(*it);
+  }
+
+  // reference the wanted images before releasing the previous ones so those in both stay loaded
+  for (std::vector<std::string>::const_iterator it = wanted.begin(); it != wanted.end(); ++it)
+  {
+    listIterator image = m_allocated.begin();
+    while (image != m_allocated.end() && (*image)->GetPath() != *it)
+      ++image;
+    if (image != m_allocated.end())
+      (*image)->AddRef();
+    else
+      QueueImage(*it, true, CJob::PRIORITY_LOW);
+  }
+
+  std::vector<std::string> &prefetched = m_prefetched[owner];
+  for (std::vector<std::string>::const_iterator it = prefetched.begin(); it != prefetched.end(); ++it)
+    ReleaseImage(*it);
+
+  if (wanted.empty())
+    m_prefetched.erase(owner);
+  else
+    prefetched.swap(wanted);
+}
+
+void CGUILargeTextureManager::CancelPrefetch(const void *owner)
+{
+  PrefetchImages(owner, std::vector<std::string>());
+}
+
+size_t CGUILargeTextureManager::GetImageMemory(const std::string &path) const
+{
+  for (std::vector<CLargeTexture *>::const_iterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if ((*it)->GetPath() == path)
+      return (*it)->GetMemoryUsage();
+  }
+  if (m_averageImageMemory)
+    return m_averageImageMemory;
+  // nothing loaded yet, assume a 16x9 image at the cached image resolution
+  return (size_t)g_advancedSettings.m_imageRes * g_advancedSettings.m_imageRes * 16 / 9 * 4;
+}
+
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
@@ -244,6 +385,9 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       CLargeTexture *image = it->second;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
+      if (size_t memory = image->GetMemoryUsage())
+        m_averageImageMemory = m_averageImageMemory ? (m_averageImageMemory * 7 + memory) / 8 : memory;
+      m_prefetchJobs.erase(jobID);
       m_queued.erase(it);
       m_allocated.push_back(image);
       return;
@@ -20,6 +20,8 @@
  *
  */
 
+#include <map>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -60,7 +62,7 @@ public:
 
  \sa IJobCallback, CGUITexture
  */
-class CGUILargeTextureManager : public IJobCallback
+class CGUILargeTextureManager : public IJobCallback, public ITextureBudgetPool
 {
 public:
   CGUILargeTextureManager();
@@ -115,6 +117,32 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Prefetch textures ahead of a scrolling container.
+
+   Holds a reference on each of the given images until the next call from the same owner, so
+   that they are loaded before CGUITexture asks for them. Images are queued at low priority in the
+   given order until the prefetch memory budget is used up. Images from the previous call that are
+   no longer wanted are released, cancelling their load if it is still queued.
+
+   \param owner the requesting container.
+   \param images the images to prefetch, ordered by distance from the viewport.
+   \sa CancelPrefetch
+   */
+  void PrefetchImages(const void *owner, const std::vector<std::string> &images);
+
+  /*!
+   \brief Release all images prefetched for the given owner.
+   \param owner the requesting container.
+   \sa PrefetchImages
+   */
+  void CancelPrefetch(const void *owner);
+
+  // ITextureBudgetPool implementation
+  virtual bool GetLeastRecentlyUsed(unsigned int &releaseTime);
+  virtual size_t FreeLeastRecentlyUsed();
+  virtual void GetMemoryUsage(size_t &used, size_t &unused);
+
 private:
   class CLargeTexture
   {
@@ -129,6 +157,9 @@ private:
 
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    bool IsReferenced() const { return m_refCount > 0; };
+    unsigned int GetReleaseTime() const { return m_releaseTime; };
+    size_t GetMemoryUsage() const;
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
@@ -137,15 +168,26 @@ private:
     std::string m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    unsigned int m_releaseTime; ///< system clock time the last reference was released
   };
 
-  void QueueImage(const std::string &path, bool useCache = true);
+  void QueueImage(const std::string &path, bool useCache = true, CJob::PRIORITY priority = CJob::PRIORITY_NORMAL);
+
+  /*!
+   \brief Memory used by an image, estimated from previously loaded images if not yet loaded.
+   */
+  size_t GetImageMemory(const std::string &path) const;
+  std::vector<CLargeTexture *>::iterator FindLeastRecentlyUsed();
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
 
+  std::map<const void *, std::vector<std::string> > m_prefetched; ///< images referenced per prefetch owner
+  std::set<unsigned int> m_prefetchJobs; ///< jobs queued at prefetch priority
+  size_t m_averageImageMemory;
+
   CCriticalSection m_listSection;
 };
 
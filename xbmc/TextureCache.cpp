@@ -21,8 +21,11 @@
 #include "TextureCache.h"
 #include "TextureCacheJob.h"
 #include "filesystem/File.h"
+#include "guilib/Texture.h"
+#include "pictures/Picture.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/Crc32.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
@@ -30,6 +33,8 @@
 #include "utils/StringUtils.h"
 #include "URL.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
 CTextureCache &CTextureCache::GetInstance()
@@ -38,8 +43,21 @@ CTextureCache &CTextureCache::GetInstance()
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+// fetching mostly waits on the network or disk, so keep several images in flight
+#define TEXTURECACHE_FETCH_JOBS  4
+#define TEXTURECACHE_ENCODE_JOBS 2
+// finished jobs a stage holds on to while the next one is full, a decoded 1080p image takes 8 MB
+#define TEXTURECACHE_STAGE_SPARE 2
+// pending use counts are written at least this often (ms)
+#define TEXTURECACHE_USECOUNT_INTERVAL 30000
+
+CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE),
+  m_fetchStage(*this, GetStageJobs(CTextureCacheJob::STAGE_FETCH), TEXTURECACHE_STAGE_SPARE),
+  m_decodeStage(*this, GetStageJobs(CTextureCacheJob::STAGE_DECODE), TEXTURECACHE_STAGE_SPARE),
+  m_encodeStage(*this, GetStageJobs(CTextureCacheJob::STAGE_ENCODE), TEXTURECACHE_STAGE_SPARE),
+  m_useCountTimer(this)
 {
+  m_writeStats = WriteStats();
 }
 
 CTextureCache::~CTextureCache()
@@ -48,14 +66,42 @@ CTextureCache::~CTextureCache()
 
 void CTextureCache::Initialize()
 {
-  CSingleLock lock(m_databaseSection);
-  if (!m_database.IsOpen())
-    m_database.Open();
+  {
+    CSingleLock lock(m_useCountSection);
+    m_writeStats = WriteStats();
+  }
+  {
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+      m_database.Open();
+  }
+  m_useCountTimer.Start(TEXTURECACHE_USECOUNT_INTERVAL, true);
 }
 
 void CTextureCache::Deinitialize()
 {
+  m_useCountTimer.Stop(true);
   CancelJobs();
+  m_fetchStage.CancelJobs();
+  m_decodeStage.CancelJobs();
+  m_encodeStage.CancelJobs();
+  {
+    CSingleLock lock(m_stageSection);
+    CStage *stages[] = { &m_fetchStage, &m_decodeStage, &m_encodeStage };
+    for (CStage *stage : stages)
+    {
+      for (std::deque<CTextureCacheJob*>::iterator i = stage->m_waiting.begin(); i != stage->m_waiting.end(); ++i)
+        delete *i;
+      stage->m_waiting.clear();
+      stage->m_jobs = 0;
+    }
+  }
+  {
+    CSingleLock lock(m_useCountSection);
+    FlushUseCounts(true);
+    CLog::Log(LOGDEBUG, "CTextureCache::%s - %u textures added, %u uses written as %u use counts in %u batches",
+              __FUNCTION__, m_writeStats.textures, m_writeStats.uses, m_writeStats.rows, m_writeStats.batches);
+  }
   CSingleLock lock(m_databaseSection);
   m_database.Close();
 }
@@ -127,7 +173,8 @@ void CTextureCache::BackgroundCacheImage(const std::string &url)
     return;
 
   // needs (re)caching
-  AddJob(new CTextureCacheJob(path, details.hash));
+  CSingleLock lock(m_stageSection);
+  QueueStage(m_fetchStage, new CTextureCacheJob(path, details.hash));
 }
 
 std::string CTextureCache::CacheImage(const std::string &image, CBaseTexture **texture /* = NULL */, CTextureDetails *details /* = NULL */)
@@ -136,11 +183,8 @@ std::string CTextureCache::CacheImage(const std::string &image, CBaseTexture **t
   if (url.empty())
     return "";
 
-  CSingleLock lock(m_processingSection);
-  if (m_processinglist.find(url) == m_processinglist.end())
+  if (StartProcessing(url))
   {
-    m_processinglist.insert(url);
-    lock.Leave();
     // cache the texture directly
     CTextureCacheJob job(url);
     bool success = job.CacheTexture(texture);
@@ -149,7 +193,6 @@ std::string CTextureCache::CacheImage(const std::string &image, CBaseTexture **t
       *details = job.m_details;
     return success ? GetCachedPath(job.m_details.file) : "";
   }
-  lock.Leave();
 
   // wait for currently processing job to end.
   while (true)
@@ -214,21 +257,60 @@ bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &de
 
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
+  {
+    CSingleLock lock(m_useCountSection);
+    m_writeStats.textures++;
+  }
   CSingleLock lock(m_databaseSection);
   return m_database.AddCachedTexture(url, details);
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
+  static const size_t textures_before_update = 100;
+
   CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
-  m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  CTextureUseCount &useCount = m_useCounts[details.id];
+  if (useCount.count == 0)
   {
-    AddJob(new CTextureUseCountJob(m_useCounts));
-    m_useCounts.clear();
+    useCount.id = details.id;
+    useCount.width = details.width;
+    useCount.height = details.height;
   }
+  useCount.count++;
+  m_writeStats.uses++;
+
+  if (m_useCounts.size() >= textures_before_update)
+    FlushUseCounts(false);
+}
+
+void CTextureCache::OnTimeout()
+{
+  CSingleLock lock(m_useCountSection);
+  FlushUseCounts(false);
+}
+
+void CTextureCache::FlushUseCounts(bool wait)
+{
+  if (m_useCounts.empty())
+    return;
+
+  std::vector<CTextureUseCount> useCounts;
+  useCounts.reserve(m_useCounts.size());
+  for (std::map<int, CTextureUseCount>::const_iterator i = m_useCounts.begin(); i != m_useCounts.end(); ++i)
+    useCounts.push_back(i->second);
+  m_useCounts.clear();
+
+  m_writeStats.rows += useCounts.size();
+  m_writeStats.batches++;
+
+  if (wait)
+  {
+    CSingleLock lock(m_databaseSection);
+    m_database.IncrementUseCounts(useCounts);
+  }
+  else
+    AddJob(new CTextureUseCountJob(useCounts));
 }
 
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
@@ -272,9 +354,20 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
       AddCachedTexture(job->m_url, job->m_details);
   }
 
-  { // remove from our processing list
+  StopProcessing(job->m_url);
+}
+
+bool CTextureCache::StartProcessing(const std::string &url)
+{
+  CSingleLock lock(m_processingSection);
+  return m_processinglist.insert(url).second;
+}
+
+void CTextureCache::StopProcessing(const std::string &url)
+{
+  {
     CSingleLock lock(m_processingSection);
-    std::set<std::string>::iterator i = m_processinglist.find(job->m_url);
+    std::set<std::string>::iterator i = m_processinglist.find(url);
     if (i != m_processinglist.end())
       m_processinglist.erase(i);
   }
@@ -282,28 +375,113 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
   m_completeEvent.Set();
 }
 
-void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+void CTextureCache::QueueStage(CStage &stage, CTextureCacheJob *job)
+{
+  if (stage.m_jobs >= stage.m_maxJobs)
+  {
+    if (job->m_stage == CTextureCacheJob::STAGE_FETCH)
+    { // the image may be asked for several times before it's fetched
+      for (std::deque<CTextureCacheJob*>::const_iterator i = stage.m_waiting.begin(); i != stage.m_waiting.end(); ++i)
+      {
+        if (**i == job)
+        {
+          delete job;
+          return;
+        }
+      }
+    }
+    stage.m_waiting.push_back(job);
+    return;
+  }
+
+  stage.m_jobs++;
+  if (job->m_stage == CTextureCacheJob::STAGE_DECODE)
+    ReleaseStage(m_fetchStage);
+  else if (job->m_stage == CTextureCacheJob::STAGE_ENCODE)
+    ReleaseStage(m_decodeStage);
+
+  std::string url = job->m_url;
+  bool fetch = job->m_stage == CTextureCacheJob::STAGE_FETCH;
+  if (!stage.AddJob(job))
+  { // already queued, a job past the fetch stage has to give up its url
+    stage.m_jobs--;
+    if (!fetch)
+      StopProcessing(url);
+  }
+}
+
+void CTextureCache::ReleaseStage(CStage &stage)
+{
+  if (stage.m_jobs)
+    stage.m_jobs--;
+  while (stage.m_jobs < stage.m_maxJobs && !stage.m_waiting.empty())
+  {
+    CTextureCacheJob *job = stage.m_waiting.front();
+    stage.m_waiting.pop_front();
+    QueueStage(stage, job);
+  }
+}
+
+void CTextureCache::OnStageComplete(CStage &stage, bool success, CTextureCacheJob *job)
+{
+  {
+    CSingleLock lock(m_stageSection);
+    if (success && job->m_stage != CTextureCacheJob::STAGE_DONE)
+    { // this job is deleted on return, so hand its state over to a job for the next stage,
+      // it keeps its place in this stage until the next stage takes it
+      CTextureCacheJob *next = job->NextStage();
+      QueueStage(next->m_stage == CTextureCacheJob::STAGE_DECODE ? m_decodeStage : m_encodeStage, next);
+      return;
+    }
+    ReleaseStage(stage);
+  }
+  OnCachingComplete(success, job);
+}
+
+void CTextureCache::OnStageCancelled(CStage &stage)
+{
+  CSingleLock lock(m_stageSection);
+  ReleaseStage(stage);
+}
+
+unsigned int CTextureCache::GetStageJobs(int stage)
+{
+  switch (stage)
+  {
+  case CTextureCacheJob::STAGE_FETCH:
+    return TEXTURECACHE_FETCH_JOBS;
+  case CTextureCacheJob::STAGE_DECODE:
+    // cpu bound, leave half of the cores to the gui
+    return std::max(g_cpuInfo.getCPUCount() / 2, 1);
+  default:
+    return TEXTURECACHE_ENCODE_JOBS;
+  }
+}
+
+CTextureCache::CStage::CStage(CTextureCache &cache, unsigned int jobsAtOnce, unsigned int spareJobs)
+  : CJobQueue(false, jobsAtOnce, CJob::PRIORITY_DEDICATED),
+    m_cache(cache),
+    m_maxJobs(jobsAtOnce + spareJobs),
+    m_jobs(0)
+{
+}
+
+void CTextureCache::CStage::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
-    OnCachingComplete(success, (CTextureCacheJob *)job);
-  return CJobQueue::OnJobComplete(jobID, success, job);
+    m_cache.OnStageComplete(*this, success, (CTextureCacheJob *)job);
+  CJobQueue::OnJobComplete(jobID, success, job);
 }
 
-void CTextureCache::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
+void CTextureCache::CStage::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0 && !progress)
   { // check our processing list
+    if (!m_cache.StartProcessing(((const CTextureCacheJob *)job)->m_url))
     {
-      CSingleLock lock(m_processingSection);
-      const CTextureCacheJob *cacheJob = (CTextureCacheJob *)job;
-      std::set<std::string>::iterator i = m_processinglist.find(cacheJob->m_url);
-      if (i == m_processinglist.end())
-      {
-        m_processinglist.insert(cacheJob->m_url);
-        return;
-      }
+      CancelJob(job);
+      m_cache.OnStageCancelled(*this);
     }
-    CancelJob(job);
   }
   else
     CJobQueue::OnJobProgress(jobID, progress, total, job);
@@ -315,10 +493,12 @@ bool CTextureCache::Export(const std::string &image, const std::string &destinat
   std::string cachedImage(GetCachedImage(image, details));
   if (!cachedImage.empty())
   {
-    std::string dest = destination + URIUtils::GetExtension(cachedImage);
+    // raw images are only of use to us, so export them as png
+    bool raw = URIUtils::HasExtension(cachedImage, ".dds");
+    std::string dest = destination + (raw ? ".png" : URIUtils::GetExtension(cachedImage));
     if (overwrite || !CFile::Exists(dest))
     {
-      if (CFile::Copy(cachedImage, dest))
+      if (raw ? ExportRaw(cachedImage, dest) : CFile::Copy(cachedImage, dest))
         return true;
       CLog::Log(LOGERROR, "%s failed exporting '%s' to '%s'", __FUNCTION__, cachedImage.c_str(), dest.c_str());
     }
@@ -332,9 +512,19 @@ bool CTextureCache::Export(const std::string &image, const std::string &destinat
   std::string cachedImage(GetCachedImage(image, details));
   if (!cachedImage.empty())
   {
-    if (CFile::Copy(cachedImage, destination))
+    if (URIUtils::HasExtension(cachedImage, ".dds") ? ExportRaw(cachedImage, destination) : CFile::Copy(cachedImage, destination))
       return true;
     CLog::Log(LOGERROR, "%s failed exporting '%s' to '%s'", __FUNCTION__, cachedImage.c_str(), destination.c_str());
   }
   return false;
 }
+
+bool CTextureCache::ExportRaw(const std::string &cachedImage, const std::string &destination)
+{
+  CBaseTexture *texture = CBaseTexture::LoadFromFile(cachedImage, 0, 0, true);
+  if (!texture)
+    return false;
+  bool success = CPicture::CreateThumbnailFromSurface(texture->GetPixels(), texture->GetWidth(), texture->GetHeight(), texture->GetPitch(), destination);
+  delete texture;
+  return success;
+}
@@ -20,12 +20,15 @@
 
 #pragma once
 
+#include <deque>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
 #include "threads/Event.h"
+#include "threads/Timer.h"
 
 class CURL;
 class CBaseTexture;
@@ -39,8 +42,16 @@ class CBaseTexture;
  may be periodically checked for updates and may be purged from the cache if
  unused for a set period of time.
 
+ Background caching runs as a pipeline of CTextureCacheJob stages: fetching the
+ image, decoding and scaling it, and encoding the cached file. Each stage runs its
+ own number of jobs at once on workers of their own, so the stages overlap. The
+ jobs hold back while pausable jobs are paused, e.g. during video playback. Each
+ stage holds a bounded number of jobs, a job keeps its place until the next stage
+ has room for it, which bounds the fetched and decoded images held in memory. The
+ processing list ensures a given URL is only ever in one of the stages at a time.
+
  */
-class CTextureCache : public CJobQueue
+class CTextureCache : public CJobQueue, private ITimerCallback
 {
 public:
   /*!
@@ -155,6 +166,14 @@ public:
    */
   bool Export(const std::string &image, const std::string &destination, bool overwrite);
   bool Export(const std::string &image, const std::string &destination); //! @todo BACKWARD COMPATIBILITY FOR MUSIC THUMBS
+
+  /*! \brief Number of jobs a stage of the caching pipeline runs at once
+   The stages run at PRIORITY_DEDICATED, the job manager starts a worker for each of
+   their jobs, so no stage waits for a worker held by another one.
+   \param stage the stage, see CTextureCacheJob::STAGE
+   \return the number of jobs at once.
+   */
+  static unsigned int GetStageJobs(int stage);
 private:
   // private construction, and no assignements; use the provided singleton methods
   CTextureCache();
@@ -195,11 +214,22 @@ private:
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
 
   /*! \brief Increment the use count of a texture
-   Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
-   \sa CUseCountJob, CTextureDatabase::IncrementUseCount
+   Uses are summed per texture and written behind by a CTextureUseCountJob once enough
+   textures were used, or at the latest on the next tick of m_useCountTimer.
+   \sa CTextureUseCountJob, CTextureDatabase::IncrementUseCounts
    */
   void IncrementUseCount(const CTextureDetails &details);
 
+  /*! \brief Queue the pending use counts for writing
+   \param wait whether to write them right away rather than from a job
+   Must be called with m_useCountSection held.
+   */
+  void FlushUseCounts(bool wait);
+
+  /*! \brief Queue the pending use counts for writing, called by m_useCountTimer
+   */
+  virtual void OnTimeout() override;
+
   /*! \brief Set a previously cached texture as valid in the database
    Thread-safe wrapper of CTextureDatabase::SetCachedTextureValid
    \param image url of the original image
@@ -208,8 +238,57 @@ private:
    */
   bool SetCachedTextureValid(const std::string &url, bool updateable);
 
-  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
-  virtual void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job);
+  /*! \brief Job queue running one stage of the caching pipeline
+   Runs jobsAtOnce jobs and holds spareJobs more, queued or finished. Further jobs wait in m_waiting.
+   Passes finished jobs on to CTextureCache::OnStageComplete.
+   */
+  class CStage : public CJobQueue
+  {
+  public:
+    CStage(CTextureCache &cache, unsigned int jobsAtOnce, unsigned int spareJobs);
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+    virtual void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job);
+  private:
+    friend class CTextureCache;
+    CTextureCache &m_cache;
+    unsigned int m_maxJobs;
+    unsigned int m_jobs;                      ///< Queued and running jobs, and finished ones waiting for room in the next stage
+    std::deque<CTextureCacheJob*> m_waiting;  ///< Jobs waiting for room in this stage
+  };
+
+  /*! \brief Queue a job in a stage, or let it wait if the stage is full
+   Once queued, the place of the job in the previous stage is released.
+   Must be called with m_stageSection held.
+   */
+  void QueueStage(CStage &stage, CTextureCacheJob *job);
+
+  /*! \brief A job has left the stage, queue waiting jobs in its place
+   Must be called with m_stageSection held.
+   */
+  void ReleaseStage(CStage &stage);
+
+  /*! \brief Remove a url from our processing list
+   \param url the url of the image
+   */
+  void StopProcessing(const std::string &url);
+
+  /*! \brief Add a url to our processing list
+   \param url the url of the image
+   \return true if added, false if the url is already being processed.
+   */
+  bool StartProcessing(const std::string &url);
+
+  /*! \brief Called when a stage of a caching job has completed.
+   Queues the next stage, or completes the caching once all stages are done or on failure.
+   \param stage the stage that ran the job.
+   \param success whether the stage was successful.
+   \param job the caching job.
+   */
+  void OnStageComplete(CStage &stage, bool success, CTextureCacheJob *job);
+
+  /*! \brief Called when a job was cancelled as its url is already being processed.
+   */
+  void OnStageCancelled(CStage &stage);
 
   /*! \brief Called when a caching job has completed.
    Removes the job from our processing list, updates the database
@@ -219,12 +298,33 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Encode a cached raw (.dds) image for export
+   \param cachedImage the cached image
+   \param destination url of the destination image, the format is taken from its extension
+   \return true if successful, false otherwise
+   */
+  static bool ExportRaw(const std::string &cachedImage, const std::string &destination);
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
-  std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
-  CCriticalSection             m_useCountSection;
+  std::map<int, CTextureUseCount> m_useCounts; ///< Uses not yet written, by texture id
+  CTimer                          m_useCountTimer; ///< Writes the pending uses periodically, also when idle
+  CCriticalSection                m_useCountSection;
+
+  /*! \brief Database writes since initialization, logged on deinitialization */
+  struct WriteStats
+  {
+    unsigned int uses;     ///< calls to IncrementUseCount
+    unsigned int rows;     ///< use counts written, once per texture and batch
+    unsigned int batches;  ///< use count batches written
+    unsigned int textures; ///< cached textures added
+  } m_writeStats;
+  CStage m_fetchStage;  ///< reads the images, I/O bound
+  CStage m_decodeStage; ///< decodes, scales and orientates, CPU bound
+  CStage m_encodeStage; ///< writes the cached files
+  CCriticalSection m_stageSection;
 };
 
@@ -24,6 +24,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
+#include "utils/JobManager.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocolDirectory.h"
 #include "pictures/Picture.h"
@@ -36,16 +37,30 @@
 #if defined(HAS_OMXPLAYER)
 #include "cores/omxplayer/OMXImage.h"
 #endif
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+#include <algorithm>
+#include <math.h>
 
 CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &oldHash):
   m_url(url),
   m_oldHash(oldHash),
-  m_cachePath(CTextureCache::GetCacheFile(m_url))
+  m_stage(STAGE_FETCH),
+  m_cachePath(CTextureCache::GetCacheFile(m_url)),
+  m_width(0),
+  m_height(0),
+  m_scalingAlgorithm(CPictureScalingAlgorithm::NoAlgorithm),
+  m_texture(NULL),
+  m_pixels(NULL)
 {
 }
 
 CTextureCacheJob::~CTextureCacheJob()
 {
+  delete m_texture;
+  delete[] m_pixels;
 }
 
 bool CTextureCacheJob::operator==(const CJob* job) const
@@ -61,71 +76,229 @@ bool CTextureCacheJob::operator==(const CJob* job) const
 
 bool CTextureCacheJob::DoWork()
 {
-  if (ShouldCancel(0, 0))
-    return false;
-  if (ShouldCancel(1, 0)) // HACK: second check is because we cancel the job in the first callback, but we don't detect it
-    return false;         //       until the second
+  switch (m_stage)
+  {
+  case STAGE_FETCH:
+    {
+      if (ShouldCancel(0, 0))
+        return false;
+      if (ShouldCancel(1, 0)) // HACK: second check is because we cancel the job in the first callback, but we don't detect it
+        return false;         //       until the second
+      if (!WaitWhilePaused())
+        return false;
+
+      // check whether we need cache the job anyway
+      bool needsRecaching = false;
+      std::string path(CTextureCache::GetInstance().CheckCachedImage(m_url, needsRecaching));
+      if (!path.empty() && !needsRecaching)
+        return false;
+      return Fetch();
+    }
+  case STAGE_DECODE:
+    return WaitWhilePaused() && Decode(false);
+  case STAGE_ENCODE:
+    return WaitWhilePaused() && Encode();
+  default:
+    return true;
+  }
+}
 
-  // check whether we need cache the job anyway
-  bool needsRecaching = false;
-  std::string path(CTextureCache::GetInstance().CheckCachedImage(m_url, needsRecaching));
-  if (!path.empty() && !needsRecaching)
-    return false;
-  return CacheTexture();
+bool CTextureCacheJob::WaitWhilePaused()
+{
+  // the stages run at dedicated priority, so hold back while pausable jobs are paused
+  while (CJobManager::GetInstance().IsPaused())
+  {
+    if (ShouldCancel(1, 0))
+      return false;
+    Sleep(100);
+  }
+  return true;
 }
 
 bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
+{
+  m_stage = STAGE_FETCH;
+  if (!Fetch())
+    return false;
+  if (m_stage == STAGE_DECODE && !Decode(out_texture != NULL))
+    return false;
+  if (m_stage == STAGE_ENCODE && !Encode())
+    return false;
+
+  if (out_texture) // caller wants the texture
+  {
+    if (!m_texture && !m_details.file.empty())
+      m_texture = LoadImage(CTextureCache::GetCachedPath(m_details.file), m_width, m_height, "" /* already flipped */);
+    *out_texture = m_texture;
+    m_texture = NULL;
+  }
+  return true;
+}
+
+CTextureCacheJob *CTextureCacheJob::NextStage()
+{
+  CTextureCacheJob *job = new CTextureCacheJob(m_url, m_oldHash);
+  job->m_details = m_details;
+  job->m_stage = m_stage;
+  job->m_image = m_image;
+  job->m_additionalInfo = m_additionalInfo;
+  job->m_width = m_width;
+  job->m_height = m_height;
+  job->m_scalingAlgorithm = m_scalingAlgorithm;
+  job->m_mimeType = m_mimeType;
+  job->m_kind = m_kind;
+  size_t size = m_buffer.size();
+  job->m_buffer.attach(m_buffer.detach(), size);
+  job->m_texture = m_texture;
+  job->m_pixels = m_pixels;
+  m_texture = NULL;
+  m_pixels = NULL;
+  return job;
+}
+
+bool CTextureCacheJob::Fetch()
 {
   // unwrap the URL as required
-  std::string additional_info;
-  unsigned int width, height;
-  CPictureScalingAlgorithm::Algorithm scalingAlgorithm;
-  std::string image = DecodeImageURL(m_url, width, height, scalingAlgorithm, additional_info);
+  m_image = DecodeImageURL(m_url, m_width, m_height, m_scalingAlgorithm, m_additionalInfo);
 
-  m_details.updateable = additional_info != "music" && UpdateableURL(image);
+  m_details.updateable = m_additionalInfo != "music" && UpdateableURL(m_image);
+
+  if (m_additionalInfo == "music")
+    m_kind = "music";
+  else if (StringUtils::StartsWith(m_url, "image://") && CURL(m_url).GetOption("size") == "thumb")
+    m_kind = "thumb";
+  else
+    m_kind = "image";
 
   // generate the hash
-  m_details.hash = GetImageHash(image);
+  m_details.hash = GetImageHash(m_image);
   if (m_details.hash.empty())
     return false;
   else if (m_details.hash == m_oldHash)
+  {
+    m_stage = STAGE_DONE;
     return true;
+  }
 
 #if defined(HAS_OMXPLAYER)
-  if (COMXImage::CreateThumb(image, width, height, additional_info, CTextureCache::GetCachedPath(m_cachePath + ".jpg")))
+  if (COMXImage::CreateThumb(m_image, m_width, m_height, m_additionalInfo, CTextureCache::GetCachedPath(m_cachePath + ".jpg")))
   {
-    m_details.width = width;
-    m_details.height = height;
+    m_details.width = m_width;
+    m_details.height = m_height;
     m_details.file = m_cachePath + ".jpg";
-    if (out_texture)
-      *out_texture = LoadImage(CTextureCache::GetCachedPath(m_details.file), width, height, "" /* already flipped */);
-    CLog::Log(LOGDEBUG, "Fast %s image '%s' to '%s': %p", m_oldHash.empty() ? "Caching" : "Recaching", CURL::GetRedacted(image).c_str(), m_details.file.c_str(), out_texture);
+    m_stage = STAGE_DONE;
+    CLog::Log(LOGDEBUG, "Fast %s image '%s' to '%s'", m_oldHash.empty() ? "Caching" : "Recaching", CURL::GetRedacted(m_image).c_str(), m_details.file.c_str());
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
-  if (texture)
+
+  m_stage = STAGE_DECODE;
+  if (m_additionalInfo == "music")
+  { // special case for embedded music images
+    MUSIC_INFO::EmbeddedArt art;
+    if (!CMusicThumbLoader::GetEmbeddedThumb(m_image, art) || !art.size)
+      return false;
+    memcpy(m_buffer.allocate(art.size).get(), &art.data[0], art.size);
+    m_mimeType = art.mime;
+    return true;
+  }
+
+  // dds, xbt and the like are loaded from their path by the decode stage
+  CURL url(m_image);
+  if (URIUtils::HasExtension(m_image, ".dds") || url.IsProtocol("xbt") ||
+      url.IsProtocol("resource") || url.IsProtocol("androidapp"))
+    return true;
+
+  CFileItem file(m_image, false);
+  file.FillInMimeType();
+  if (!StringUtils::StartsWithNoCase(file.GetMimeType(), "image/"))
+    return true;
+
+  XFILE::CFile reader;
+  if (reader.LoadFile(m_image, m_buffer) <= 0)
+    return false;
+  m_mimeType = file.GetMimeType();
+  return true;
+}
+
+bool CTextureCacheJob::Decode(bool keepTexture)
+{
+  // images are cached at most at the fanart resolution (see CPicture::PrepareCacheTexture), so
+  // decoding them any larger is wasted, and jpegs can be decoded at a fraction of their size
+  unsigned int width = m_width, height = m_height;
+  if (!width && !height)
   {
-    if (texture->HasAlpha())
-      m_details.file = m_cachePath + ".png";
-    else
-      m_details.file = m_cachePath + ".jpg";
+    height = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+    width = height * 16 / 9;
+  }
 
-    CLog::Log(LOGDEBUG, "%s image '%s' to '%s':", m_oldHash.empty() ? "Caching" : "Recaching", CURL::GetRedacted(image).c_str(), m_details.file.c_str());
+  if (m_buffer.size())
+  {
+    m_texture = CBaseTexture::LoadFromFileInMemory((unsigned char *)m_buffer.get(), m_buffer.size(), m_mimeType, width, height);
+    if (m_texture && m_additionalInfo == "flipped")
+      m_texture->SetOrientation(m_texture->GetOrientation() ^ 1);
+    m_buffer.clear();
+  }
+  else
+    m_texture = LoadImage(m_image, width, height, m_additionalInfo, true);
+  if (!m_texture)
+    return false;
 
-    if (CPicture::CacheTexture(texture, width, height, CTextureCache::GetCachedPath(m_details.file), scalingAlgorithm))
-    {
-      m_details.width = width;
-      m_details.height = height;
-      if (out_texture) // caller wants the texture
-        *out_texture = texture;
-      else
-        delete texture;
-      return true;
-    }
+  // large 16x9 images are cached at the fanart resolution, see CPicture::PrepareCacheTexture
+  if (m_kind == "image" && g_advancedSettings.m_fanartRes > g_advancedSettings.m_imageRes &&
+      m_texture->GetHeight() >= g_advancedSettings.m_fanartRes &&
+      fabsf((float)m_texture->GetWidth() / (float)m_texture->GetHeight() / (16.0f/9.0f) - 1.0f) <= 0.01f)
+    m_kind = "fanart";
+
+  if (CacheRaw(m_kind))
+    m_details.file = m_cachePath + ".dds";
+  else if (m_texture->HasAlpha())
+    m_details.file = m_cachePath + ".png";
+  else
+    m_details.file = m_cachePath + ".jpg";
+
+  if (!CPicture::PrepareCacheTexture(m_texture->GetPixels(), m_texture->GetWidth(), m_texture->GetHeight(),
+                                     m_texture->GetPitch(), m_texture->GetOrientation(),
+                                     m_width, m_height, m_pixels, m_scalingAlgorithm))
+    return false;
+
+  // the texture is only needed by the encode stage if its pixels are cached as they are
+  if (m_pixels && !keepTexture)
+  {
+    delete m_texture;
+    m_texture = NULL;
   }
-  delete texture;
-  return false;
+  m_stage = STAGE_ENCODE;
+  return true;
+}
+
+bool CTextureCacheJob::Encode()
+{
+  CLog::Log(LOGDEBUG, "%s image '%s' to '%s':", m_oldHash.empty() ? "Caching" : "Recaching", CURL::GetRedacted(m_image).c_str(), m_details.file.c_str());
+
+  bool success;
+  if (m_pixels)
+    success = CPicture::CreateThumbnailFromSurface((unsigned char *)m_pixels, m_width, m_height, m_width * 4, CTextureCache::GetCachedPath(m_details.file));
+  else if (m_texture)
+    success = CPicture::CreateThumbnailFromSurface(m_texture->GetPixels(), m_width, m_height, m_texture->GetPitch(), CTextureCache::GetCachedPath(m_details.file));
+  else
+    success = false;
+
+  delete[] m_pixels;
+  m_pixels = NULL;
+  if (!success)
+    return false;
+
+  m_details.width = m_width;
+  m_details.height = m_height;
+  m_stage = STAGE_DONE;
+  return true;
+}
+
+bool CTextureCacheJob::CacheRaw(const std::string &kind)
+{
+  const std::vector<std::string> &raw = g_advancedSettings.m_imageCacheRaw;
+  return std::find(raw.begin(), raw.end(), kind) != raw.end();
 }
 
 bool CTextureCacheJob::ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size)
@@ -249,31 +422,21 @@ std::string CTextureCacheJob::GetImageHash(const std::string &url)
   return "";
 }
 
-CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
+CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureUseCount> &textures) : m_textures(textures)
 {
 }
 
 bool CTextureUseCountJob::operator==(const CJob* job) const
 {
-  if (strcmp(job->GetType(),GetType()) == 0)
-  {
-    const CTextureUseCountJob* useJob = dynamic_cast<const CTextureUseCountJob*>(job);
-    if (useJob && useJob->m_textures == m_textures)
-      return true;
-  }
-  return false;
+  // batches are never merged, each holds uses not yet written
+  return job == this;
 }
 
 bool CTextureUseCountJob::DoWork()
 {
   CTextureDatabase db;
   if (db.Open())
-  {
-    db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
-    db.CommitTransaction();
-  }
+    db.IncrementUseCounts(m_textures);
   return true;
 }
 
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "pictures/PictureScalingAlgorithm.h"
+#include "utils/auto_buffer.h"
 #include "utils/Job.h"
 
 class CBaseTexture;
@@ -56,15 +57,40 @@ public:
   bool         updateable;
 };
 
+/*!
+ \ingroup textures
+ \brief Number of times a cached texture was used since its use count was last written
+ */
+struct CTextureUseCount
+{
+  int          id;
+  unsigned int width;
+  unsigned int height;
+  unsigned int count;
+};
+
 /*!
  \ingroup textures
  \brief Job class for caching textures
  
- Handles loading and caching of textures.
+ Handles loading and caching of textures. Caching is split into stages so that
+ CTextureCache can run each of them with its own concurrency: the fetch stage
+ reads the image (I/O bound), the decode stage decodes, scales and orientates it
+ (CPU bound) and the encode stage writes the cached JPG or PNG. A job runs the
+ stage given by m_stage, on success the state is handed over to a new job for
+ the next stage with NextStage().
  */
 class CTextureCacheJob : public CJob
 {
 public:
+  enum STAGE
+  {
+    STAGE_FETCH = 0,
+    STAGE_DECODE,
+    STAGE_ENCODE,
+    STAGE_DONE
+  };
+
   CTextureCacheJob(const std::string &url, const std::string &oldHash = "");
   virtual ~CTextureCacheJob();
 
@@ -72,19 +98,19 @@ public:
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
 
-  /*! \brief retrieve a hash for the given image
-   Combines the size, ctime and mtime of the image file into a "unique" hash
-   \param url location of the image
-   \return a hash string for this image
+  /*! \brief Cache the texture, running all stages in the calling thread
+   \param texture [out] the loaded texture, if wanted
+   \return true if successful, false otherwise
    */
   bool CacheTexture(CBaseTexture **texture = NULL);
 
+  /*! \brief Create a job for the next stage, taking over the state of this job
+   \return the job for m_stage, to be queued by the caller
+   */
+  CTextureCacheJob *NextStage();
+
   static bool ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size);
 
-  std::string m_url;
-  std::string m_oldHash;
-  CTextureDetails m_details;
-private:
   /*! \brief retrieve a hash for the given image
    Combines the size, ctime and mtime of the image file into a "unique" hash
    \param url location of the image
@@ -92,6 +118,40 @@ private:
    */
   static std::string GetImageHash(const std::string &url);
 
+  std::string m_url;
+  std::string m_oldHash;
+  CTextureDetails m_details;
+  STAGE m_stage;
+private:
+  /*! \brief Wait while the job manager pauses pausable jobs, e.g. during video playback
+   \return false if the job was cancelled while waiting
+   */
+  bool WaitWhilePaused();
+
+  /*! \brief Check the hash and read the image into memory
+   Images that can't be decoded from memory (eg dds or xbt) are left to the decode stage.
+   \return true if successful, false otherwise
+   */
+  bool Fetch();
+
+  /*! \brief Decode the fetched image and scale and orientate the pixels for caching
+   \param keepTexture whether to keep the decoded texture for the caller
+   \return true if successful, false otherwise
+   */
+  bool Decode(bool keepTexture);
+
+  /*! \brief Write the prepared pixels to the cache file
+   \return true if successful, false otherwise
+   */
+  bool Encode();
+
+  /*! \brief Check whether images of the given kind are cached as raw pixels (.dds)
+   Raw images are pre-scaled and load without decoding, at the cost of disk space.
+   \param kind the kind of image, one of "thumb", "fanart", "image" or "music".
+   \return true if set in advancedsettings.xml via <imagecacheraw>
+   */
+  static bool CacheRaw(const std::string &kind);
+
   /*! \brief Check whether a given URL represents an image that can be updated
    We currently don't check http:// and https:// URLs for updates, under the assumption that
    a image URL is much more likely to be static and the actual image at the URL is unlikely
@@ -125,6 +185,18 @@ private:
   static CBaseTexture *LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels = false);
 
   std::string    m_cachePath;
+
+  // state handed over between the stages
+  std::string    m_image;
+  std::string    m_additionalInfo;
+  unsigned int   m_width;
+  unsigned int   m_height;
+  CPictureScalingAlgorithm::Algorithm m_scalingAlgorithm;
+  XUTILS::auto_buffer m_buffer; ///< the fetched image file
+  std::string    m_mimeType;
+  std::string    m_kind; ///< the kind of image, see CacheRaw
+  CBaseTexture  *m_texture;
+  uint32_t      *m_pixels; ///< scaled and orientated pixels, NULL to use the texture's
 };
 
 /* \brief Job class for storing the use count of textures
@@ -132,14 +204,14 @@ private:
 class CTextureUseCountJob : public CJob
 {
 public:
-  CTextureUseCountJob(const std::vector<CTextureDetails> &textures);
+  CTextureUseCountJob(const std::vector<CTextureUseCount> &textures);
 
   virtual const char* GetType() const { return "usecount"; };
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
 
 private:
-  std::vector<CTextureDetails> m_textures;
+  std::vector<CTextureUseCount> m_textures;
 };
 
 /* \brief Job class for storing the use count of textures
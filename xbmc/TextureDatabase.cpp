@@ -27,6 +27,8 @@
 #include "utils/Variant.h"
 #include "utils/DatabaseUtils.h"
 
+#include <algorithm>
+
 enum TextureField
 {
   TF_None = 0,
@@ -162,7 +164,26 @@ CTextureDatabase::~CTextureDatabase()
 
 bool CTextureDatabase::Open()
 {
-  return CDatabase::Open();
+  if (!CDatabase::Open())
+    return false;
+
+  // the use count jobs and the texture cache write through separate connections while the GUI
+  // reads, in WAL mode readers don't block the writer and commits don't need to sync the whole db
+  if (m_sqlite)
+  {
+    try
+    {
+      m_pDS->query("PRAGMA journal_mode=WAL");
+      if (!m_pDS->eof() && m_pDS->fv(0).get_asString() != "wal")
+        CLog::Log(LOGWARNING, "%s - unable to switch to WAL mode, using %s", __FUNCTION__, m_pDS->fv(0).get_asString().c_str());
+      m_pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - failed to set the journal mode", __FUNCTION__);
+    }
+  }
+  return true;
 }
 
 void CTextureDatabase::CreateTables()
@@ -245,10 +266,41 @@ void CTextureDatabase::UpdateTables(int version)
   }
 }
 
-bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
+bool CTextureDatabase::IncrementUseCounts(const std::vector<CTextureUseCount> &textures)
 {
-  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", details.id, details.width, details.height);
-  return ExecuteQuery(sql);
+  // keeps the statement well within sqlite's expression depth limit
+  static const size_t max_rows_per_statement = 200;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    BeginTransaction();
+    for (size_t start = 0; start < textures.size(); start += max_rows_per_statement)
+    {
+      size_t end = std::min(start + max_rows_per_statement, textures.size());
+      std::string counts, sizes, ids;
+      for (size_t i = start; i < end; i++)
+      {
+        const CTextureUseCount &texture = textures[i];
+        counts += PrepareSQL(" WHEN %i THEN %u", texture.id, texture.count);
+        sizes += PrepareSQL(" WHEN %i THEN width=%u AND height=%u", texture.id, texture.width, texture.height);
+        if (!ids.empty())
+          ids += ",";
+        ids += PrepareSQL("%i", texture.id);
+      }
+      m_pDS->exec("UPDATE sizes SET usecount=usecount+CASE idtexture" + counts + " END, lastusetime=CURRENT_TIMESTAMP "
+                  "WHERE idtexture IN (" + ids + ") AND CASE idtexture" + sizes + " END");
+    }
+    return CommitTransaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on %" PRIuS" textures", __FUNCTION__, textures.size());
+    RollbackTransaction();
+  }
+  return false;
 }
 
 bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details)
@@ -367,6 +419,8 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
+    // one commit rather than one for each statement
+    BeginTransaction();
     std::string sql = PrepareSQL("DELETE FROM texture WHERE url='%s'", url.c_str());
     m_pDS->exec(sql);
 
@@ -378,10 +432,12 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
     // set the size information
     sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", textureID, details.width, details.height);
     m_pDS->exec(sql);
+    CommitTransaction();
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "%s failed on url '%s'", __FUNCTION__, url.c_str());
+    RollbackTransaction();
   }
   return true;
 }
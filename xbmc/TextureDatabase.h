@@ -80,7 +80,13 @@ public:
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
-  bool IncrementUseCount(const CTextureDetails &details);
+
+  /*! \brief Add to the use counts of a batch of textures
+   Writes the whole batch with a single statement in one transaction.
+   \param textures the textures and how often each was used
+   \return true if the use counts were written, false otherwise
+   */
+  bool IncrementUseCounts(const std::vector<CTextureUseCount> &textures);
 
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
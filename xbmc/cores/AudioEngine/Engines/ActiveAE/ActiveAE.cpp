@@ -22,6 +22,7 @@
 
 using namespace ActiveAE;
 #include "ActiveAESound.h"
+#include "ActiveAESoundCache.h"
 #include "ActiveAEStream.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSPProcess.h"
@@ -2598,6 +2599,8 @@ bool CActiveAE::Initialize()
   // hook into windowing for receiving display reset events
   g_Windowing.Register(this);
 
+  CActiveAESoundCache::Prune();
+
   m_inMsgEvent.Reset();
   return true;
 }
@@ -2947,6 +2950,14 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   SampleConfig config;
 
   sound = new CActiveAESound(file);
+
+  // sounds decoded on an earlier run are mapped from the cache
+  if (CActiveAESoundCache::Load(*sound, true))
+  {
+    m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+    return sound;
+  }
+
   if (!sound->Prepare())
   {
     delete sound;
@@ -3067,6 +3078,7 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   }
 
   sound->Finish();
+  CActiveAESoundCache::Store(*sound, true);
 
   // register sound
   m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
@@ -3089,6 +3101,16 @@ void CActiveAE::StopSound(CActiveAESound *sound)
   m_controlPort.SendOutMessage(CActiveAEControlProtocol::STOPSOUND, &sound, sizeof(CActiveAESound*));
 }
 
+// settings a converted sound depends on, they are part of its cache key
+static CActiveAESoundCache::Conversion GetSoundConversion(AEQuality quality)
+{
+  CActiveAESoundCache::Conversion conversion;
+  conversion.quality = quality;
+  conversion.boostCenter = CSettings::GetInstance().GetInt("audiooutput.boostcenter");
+  conversion.normalize = true;
+  return conversion;
+}
+
 /**
  * resample sounds to destination format for mixing
  * destination format is either format of stream or
@@ -3106,7 +3128,12 @@ void CActiveAE::ResampleSounds()
   {
     if (!(*it)->IsConverted())
     {
-      ResampleSound(*it);
+      // keep the converted sound for the next start, mixing maps it from the cache then
+      if (ResampleSound(*it) && (*it)->GetChannel() == AE_CH_NULL)
+      {
+        CActiveAESoundCache::Conversion conversion = GetSoundConversion(m_settings.resampleQuality);
+        CActiveAESoundCache::Store(**it, false, &conversion);
+      }
       // only do one sound, then yield to main loop
       break;
     }
@@ -3149,6 +3176,11 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
     }
   }
 
+  // routed test sounds are not cached
+  CActiveAESoundCache::Conversion conversion = GetSoundConversion(m_settings.resampleQuality);
+  if (outChannels.Count() == 0 && CActiveAESoundCache::Load(*sound, false, &dst_config, &conversion))
+    return true;
+
   IAEResample *resampler = CAEResampleFactory::Create(AERESAMPLEFACTORY_QUICK_RESAMPLE);
   resampler->Init(dst_config.channel_layout,
                   dst_config.channels,
@@ -3163,7 +3195,7 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
                   orig_config.bits_per_sample,
                   orig_config.dither_bits,
                   false,
-                  true,
+                  conversion.normalize,
                   outChannels.Count() > 0 ? &outChannels : NULL,
                   m_settings.resampleQuality,
                   false);
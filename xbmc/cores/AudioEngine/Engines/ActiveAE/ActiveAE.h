@@ -278,6 +278,9 @@ public:
   virtual void OnResetDisplay();
   virtual void OnAppFocusChange(bool focus);
 
+  /* cpu time of the engine and sink threads in 100ns units, for benchmarks */
+  int64_t GetThreadUsage() { return GetAbsoluteUsage() + m_sink.GetThreadUsage(); }
+
 protected:
   void PlaySound(CActiveAESound *sound);
   uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
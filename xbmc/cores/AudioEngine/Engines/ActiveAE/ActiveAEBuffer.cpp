@@ -31,20 +31,45 @@ using namespace ActiveAE;
 /* typecast AE to CActiveAE */
 #define AE (*((CActiveAE*)CAEFactory::GetEngine()))
 
+static std::atomic<unsigned int> g_soundPacketAllocations(0);
+
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 {
   data = AE.AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
+  g_soundPacketAllocations++;
   max_nb_samples = samples;
   nb_samples = 0;
   pause_burst_ms = 0;
+  external = false;
+}
+
+CSoundPacket::CSoundPacket(SampleConfig conf, int samples, uint8_t *buffer, int planesize) : config(conf)
+{
+  planes = av_sample_fmt_is_planar(config.fmt) ? config.channels : 1;
+  bytes_per_sample = av_get_bytes_per_sample(config.fmt);
+  linesize = planesize;
+  data = new uint8_t*[planes];
+  for (int i = 0; i < planes; i++)
+    data[i] = buffer + i * planesize;
+  max_nb_samples = samples;
+  nb_samples = samples;
+  pause_burst_ms = 0;
+  external = true;
 }
 
 CSoundPacket::~CSoundPacket()
 {
-  if (data)
+  if (external)
+    delete [] data;
+  else if (data)
     AE.FreeSoundSample(data);
 }
 
+unsigned int CSoundPacket::GetAllocations()
+{
+  return g_soundPacketAllocations;
+}
+
 CSampleBuffer::CSampleBuffer() : pkt(NULL), pool(NULL)
 {
   refCount = 0;
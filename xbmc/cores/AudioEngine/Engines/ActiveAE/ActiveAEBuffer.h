@@ -51,7 +51,9 @@ class CSoundPacket
 {
 public:
   CSoundPacket(SampleConfig conf, int samples);
+  CSoundPacket(SampleConfig conf, int samples, uint8_t *buffer, int planesize);
   ~CSoundPacket();
+  static unsigned int GetAllocations();  // number of packets that allocated their planes, for benchmarks
   uint8_t **data;                        // array with pointers to planes of data
   SampleConfig config;
   int bytes_per_sample;                  // bytes per sample and per channel
@@ -60,6 +62,7 @@ public:
   int nb_samples;                        // number of frames used
   int max_nb_samples;                    // max number of frames this packet can hold
   int pause_burst_ms;
+  bool external;                         // planes point to memory not owned by the packet, i.e. a mapped file
 };
 
 class CActiveAEBufferPool;
@@ -0,0 +1,349 @@
+/*
+ *      Copyright (C) 2010-2016 Team Kodi
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAERemap.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+
+struct Sample24
+{
+  uint8_t b[3];
+};
+
+template<typename T, int CH>
+void PermuteFrames(uint8_t *data, const int *map, int samples)
+{
+  T *frame = reinterpret_cast<T*>(data);
+  T tmp[CH];
+  for (int s = 0; s < samples; s++, frame += CH)
+  {
+    for (int c = 0; c < CH; c++)
+      tmp[c] = frame[map[c]];
+    for (int c = 0; c < CH; c++)
+      frame[c] = tmp[c];
+  }
+}
+
+template<typename T>
+void PermuteFramesGeneric(uint8_t *data, const int *map, int channels, int samples)
+{
+  T *frame = reinterpret_cast<T*>(data);
+  T tmp[AE_CH_MAX];
+  for (int s = 0; s < samples; s++, frame += channels)
+  {
+    for (int c = 0; c < channels; c++)
+      tmp[c] = frame[map[c]];
+    for (int c = 0; c < channels; c++)
+      frame[c] = tmp[c];
+  }
+}
+
+template<typename T>
+void PermuteFramesBySize(uint8_t *data, const int *map, int channels, int samples)
+{
+  switch (channels)
+  {
+    case 2: PermuteFrames<T, 2>(data, map, samples); break;
+    case 3: PermuteFrames<T, 3>(data, map, samples); break;
+    case 4: PermuteFrames<T, 4>(data, map, samples); break;
+    case 5: PermuteFrames<T, 5>(data, map, samples); break;
+    case 6: PermuteFrames<T, 6>(data, map, samples); break;
+    case 7: PermuteFrames<T, 7>(data, map, samples); break;
+    case 8: PermuteFrames<T, 8>(data, map, samples); break;
+    default: PermuteFramesGeneric<T>(data, map, channels, samples); break;
+  }
+}
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+// matrix is row major, OUTCH rows by INCH columns. all outputs of a block of
+// four samples are computed before storing, this allows in == out.
+// out[o] points at the first sample of output channel o, samples of a
+// channel are outStep floats apart
+template<int INCH, int OUTCH>
+int DownmixPlanarSSE(const float *matrix, float *const *in, float *const *out, int outStep, int samples)
+{
+  __m128 coeff[OUTCH][INCH];
+  for (int o = 0; o < OUTCH; o++)
+    for (int i = 0; i < INCH; i++)
+      coeff[o][i] = _mm_set_ps1(matrix[o * INCH + i]);
+
+  int even = samples & ~0x3;
+  for (int s = 0; s < even; s += 4)
+  {
+    __m128 src[INCH];
+    for (int i = 0; i < INCH; i++)
+      src[i] = _mm_loadu_ps(in[i] + s);
+
+    __m128 dst[OUTCH];
+    for (int o = 0; o < OUTCH; o++)
+    {
+      dst[o] = _mm_mul_ps(src[0], coeff[o][0]);
+      for (int i = 1; i < INCH; i++)
+        dst[o] = _mm_add_ps(dst[o], _mm_mul_ps(src[i], coeff[o][i]));
+    }
+
+    if (outStep == 1)
+    {
+      for (int o = 0; o < OUTCH; o++)
+        _mm_storeu_ps(out[o] + s, dst[o]);
+    }
+    else
+    {
+      float tmp[OUTCH][4];
+      for (int o = 0; o < OUTCH; o++)
+        _mm_storeu_ps(tmp[o], dst[o]);
+      for (int k = 0; k < 4; k++)
+        for (int o = 0; o < OUTCH; o++)
+          out[o][(s + k) * outStep] = tmp[o][k];
+    }
+  }
+  return even;
+}
+#endif
+
+// a frame is read completely before its outputs are stored and output frames
+// are never larger than input frames, so in and out may be the same buffer
+void DownmixScalar(const float *matrix, int inCh, int outCh, float *const *in, int inStep,
+                   float *const *out, int outStep, int start, int samples)
+{
+  float src[AE_CH_MAX];
+  float dst[AE_CH_MAX];
+  for (int s = start; s < samples; s++)
+  {
+    for (int i = 0; i < inCh; i++)
+      src[i] = in[i][s * inStep];
+    for (int o = 0; o < outCh; o++)
+    {
+      const float *row = matrix + o * inCh;
+      float sum = 0.0f;
+      for (int i = 0; i < inCh; i++)
+        sum += src[i] * row[i];
+      dst[o] = sum;
+    }
+    for (int o = 0; o < outCh; o++)
+      out[o][s * outStep] = dst[o];
+  }
+}
+
+int FindChannel(const CAEChannelInfo &layout, AEChannel ch)
+{
+  for (unsigned int i = 0; i < layout.Count(); i++)
+  {
+    if (layout[i] == ch)
+      return i;
+  }
+  return -1;
+}
+
+}
+
+CActiveAERemap::CActiveAERemap()
+{
+  m_isPermutation = false;
+  m_planar = false;
+  m_outPlanar = false;
+  m_channels = 0;
+  m_outChannels = 0;
+  m_bytesPerSample = 0;
+  memset(m_map, 0, sizeof(m_map));
+}
+
+CActiveAERemap::~CActiveAERemap()
+{
+}
+
+CAEChannelInfo CActiveAERemap::GetFFmpegOrder(const CAEChannelInfo &layout)
+{
+  std::vector<AEChannel> channels;
+  for (unsigned int i = 0; i < layout.Count(); i++)
+    channels.push_back(layout[i]);
+
+  // channels unknown to ffmpeg keep their relative order at the end
+  std::stable_sort(channels.begin(), channels.end(), [](AEChannel lhs, AEChannel rhs)
+  {
+    uint64_t avLhs = CAEUtil::GetAVChannel(lhs);
+    uint64_t avRhs = CAEUtil::GetAVChannel(rhs);
+    if (avLhs == 0 || avRhs == 0)
+      return avLhs != 0 && avRhs == 0;
+    return avLhs < avRhs;
+  });
+
+  CAEChannelInfo ordered;
+  ordered.Reset();
+  for (auto ch : channels)
+    ordered += ch;
+  return ordered;
+}
+
+bool CActiveAERemap::FollowsFFmpegOrder(const CAEChannelInfo &layout)
+{
+  uint64_t avLast, avCur = 0;
+  for (unsigned int i = 0; i < layout.Count(); i++)
+  {
+    avLast = avCur;
+    avCur = CAEUtil::GetAVChannel(layout[i]);
+    if (avCur < avLast)
+      return false;
+  }
+  return true;
+}
+
+bool CActiveAERemap::InitPermutation(const CAEChannelInfo &src, const CAEChannelInfo &dst, AEDataFormat format)
+{
+  if (src.Count() != dst.Count() || src.Count() == 0 || format == AE_FMT_RAW)
+    return false;
+
+  m_bytesPerSample = CAEUtil::DataFormatToBits(format) >> 3;
+  if (m_bytesPerSample == 0)
+    return false;
+
+  for (unsigned int i = 0; i < dst.Count(); i++)
+  {
+    int idx = FindChannel(src, dst[i]);
+    if (idx < 0)
+    {
+      CLog::Log(LOGERROR, "CActiveAERemap::%s - channel %s missing in source layout",
+                __FUNCTION__, CAEChannelInfo::GetChName(dst[i]));
+      return false;
+    }
+    m_map[i] = idx;
+  }
+
+  m_isPermutation = true;
+  m_planar = m_outPlanar = AE_IS_PLANAR(format);
+  m_channels = m_outChannels = src.Count();
+  m_matrix.clear();
+  return true;
+}
+
+bool CActiveAERemap::InitDownmix(const double *matrix, int stride, int inChannels, int outChannels, bool inPlanar, bool outPlanar)
+{
+  if (outChannels <= 0 || outChannels >= inChannels || inChannels > AE_CH_MAX)
+    return false;
+
+  m_matrix.resize(inChannels * outChannels);
+  for (int out = 0; out < outChannels; out++)
+  {
+    for (int in = 0; in < inChannels; in++)
+      m_matrix[out * inChannels + in] = (float)matrix[out * stride + in];
+  }
+
+  m_isPermutation = false;
+  m_planar = inPlanar;
+  m_outPlanar = outPlanar;
+  m_channels = inChannels;
+  m_outChannels = outChannels;
+  m_bytesPerSample = sizeof(float);
+  return true;
+}
+
+void CActiveAERemap::Remap(uint8_t **data, int samples)
+{
+  if (!m_isPermutation || samples <= 0)
+    return;
+
+  if (m_planar)
+    PermutePlanar(data, samples);
+  else
+    PermuteInterleaved(data, samples);
+}
+
+void CActiveAERemap::PermutePlanar(uint8_t **data, int samples)
+{
+  // walk the cycles of the permutation, one scratch plane is enough.
+  // plane pointers are left untouched because the first one owns the allocation
+  size_t planeSize = samples * m_bytesPerSample;
+  if (m_scratch.size() < planeSize)
+    m_scratch.resize(planeSize);
+
+  bool done[AE_CH_MAX] = { false };
+  for (int start = 0; start < m_channels; start++)
+  {
+    if (done[start] || m_map[start] == start)
+      continue;
+
+    memcpy(m_scratch.data(), data[start], planeSize);
+    int cur = start;
+    while (true)
+    {
+      done[cur] = true;
+      int src = m_map[cur];
+      if (src == start)
+      {
+        memcpy(data[cur], m_scratch.data(), planeSize);
+        break;
+      }
+      memcpy(data[cur], data[src], planeSize);
+      cur = src;
+    }
+  }
+}
+
+void CActiveAERemap::PermuteInterleaved(uint8_t **data, int samples)
+{
+  switch (m_bytesPerSample)
+  {
+    case 1: PermuteFramesBySize<uint8_t>(data[0], m_map, m_channels, samples); break;
+    case 2: PermuteFramesBySize<uint16_t>(data[0], m_map, m_channels, samples); break;
+    case 3: PermuteFramesBySize<Sample24>(data[0], m_map, m_channels, samples); break;
+    case 4: PermuteFramesBySize<uint32_t>(data[0], m_map, m_channels, samples); break;
+    case 8: PermuteFramesBySize<uint64_t>(data[0], m_map, m_channels, samples); break;
+    default:
+      CLog::Log(LOGERROR, "CActiveAERemap::%s - unsupported sample size %d", __FUNCTION__, m_bytesPerSample);
+      break;
+  }
+}
+
+void CActiveAERemap::Downmix(uint8_t **in, uint8_t **out, int samples)
+{
+  if (m_matrix.empty() || samples <= 0)
+    return;
+
+  float *src[AE_CH_MAX];
+  float *dst[AE_CH_MAX];
+  for (int i = 0; i < m_channels; i++)
+    src[i] = m_planar ? reinterpret_cast<float*>(in[i]) : reinterpret_cast<float*>(in[0]) + i;
+  for (int o = 0; o < m_outChannels; o++)
+    dst[o] = m_outPlanar ? reinterpret_cast<float*>(out[o]) : reinterpret_cast<float*>(out[0]) + o;
+  int inStep = m_planar ? 1 : m_channels;
+  int outStep = m_outPlanar ? 1 : m_outChannels;
+
+  int done = 0;
+#if defined(HAVE_SSE) && defined(__SSE__)
+  if (m_planar)
+  {
+    if (m_channels == 6 && m_outChannels == 2)
+      done = DownmixPlanarSSE<6, 2>(m_matrix.data(), src, dst, outStep, samples);
+    else if (m_channels == 8 && m_outChannels == 6)
+      done = DownmixPlanarSSE<8, 6>(m_matrix.data(), src, dst, outStep, samples);
+    else if (m_channels == 8 && m_outChannels == 2)
+      done = DownmixPlanarSSE<8, 2>(m_matrix.data(), src, dst, outStep, samples);
+  }
+#endif
+  DownmixScalar(m_matrix.data(), m_channels, m_outChannels, src, inStep, dst, outStep, done, samples);
+}
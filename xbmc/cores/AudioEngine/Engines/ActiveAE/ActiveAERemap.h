@@ -0,0 +1,97 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2016 Team Kodi
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEAudioFormat.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ActiveAE
+{
+
+/**
+ * Lightweight channel remapper used instead of a full resampler when only
+ * the channel order or the channel count changes.
+ *
+ * Permutations are applied in place, interleaved formats use kernels
+ * specialized on channel count and sample size. Downmixing takes the matrix
+ * built by libswresample and supports float formats, planar input uses SSE
+ * kernels for 5.1->2.0, 7.1->5.1 and 7.1->2.0 when available.
+ */
+class CActiveAERemap
+{
+public:
+  CActiveAERemap();
+  ~CActiveAERemap();
+
+  /**
+   * Set up a pure reorder of channels. dst must contain the same channels as src
+   * @return false if layouts don't match or format is not supported
+   */
+  bool InitPermutation(const CAEChannelInfo &src, const CAEChannelInfo &dst, AEDataFormat format);
+
+  /**
+   * Set up a downmix of float samples
+   * @param matrix coefficients in ffmpeg channel order, row out has the weights of the input channels
+   * @param stride distance between the rows of matrix
+   * @return false if the channel count doesn't go down
+   */
+  bool InitDownmix(const double *matrix, int stride, int inChannels, int outChannels, bool inPlanar, bool outPlanar);
+
+  /**
+   * Reorder channels in place
+   */
+  void Remap(uint8_t **data, int samples);
+
+  /**
+   * Apply the downmix matrix. in and out may be the same buffer if both are planar or both interleaved
+   */
+  void Downmix(uint8_t **in, uint8_t **out, int samples);
+
+  bool IsPermutation() const { return m_isPermutation; }
+  bool IsDownmix() const { return !m_matrix.empty(); }
+  int GetChannels() const { return m_channels; }
+
+  /**
+   * Return layout ordered like ffmpeg expects channels to appear in a buffer
+   */
+  static CAEChannelInfo GetFFmpegOrder(const CAEChannelInfo &layout);
+
+  /**
+   * Check if a layout follows ffmpeg channel order
+   */
+  static bool FollowsFFmpegOrder(const CAEChannelInfo &layout);
+
+protected:
+  void PermutePlanar(uint8_t **data, int samples);
+  void PermuteInterleaved(uint8_t **data, int samples);
+
+  bool m_isPermutation;
+  bool m_planar;
+  bool m_outPlanar;
+  int m_channels;
+  int m_outChannels;
+  int m_bytesPerSample;
+  int m_map[AE_CH_MAX];
+  std::vector<uint8_t> m_scratch;
+  std::vector<float> m_matrix;
+};
+
+}
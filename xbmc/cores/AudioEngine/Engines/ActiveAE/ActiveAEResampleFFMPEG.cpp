@@ -20,9 +20,12 @@
 
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
+#include "ActiveAERemap.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
 
+#include <climits>
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
@@ -35,11 +38,13 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_doesResample = false;
+  m_downmix = NULL;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
 {
   swr_free(&m_pContext);
+  delete m_downmix;
 }
 
 bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
@@ -182,6 +187,40 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
     return false;
   }
+
+  // float downmixes without resampling run our own kernels, the matrix is
+  // built from the options swr ended up with so the result is the same
+  if (!remapLayout && !force_resample && !m_doesResample &&
+      m_dst_channels < m_src_channels &&
+      av_get_packed_sample_fmt(m_src_fmt) == AV_SAMPLE_FMT_FLT &&
+      av_get_packed_sample_fmt(m_dst_fmt) == AV_SAMPLE_FMT_FLT)
+  {
+    double center, surround, lfe, maxval, volume;
+    int64_t encoding;
+    av_opt_get_double(m_pContext, "center_mix_level", 0, &center);
+    av_opt_get_double(m_pContext, "surround_mix_level", 0, &surround);
+    av_opt_get_double(m_pContext, "lfe_mix_level", 0, &lfe);
+    av_opt_get_double(m_pContext, "rematrix_maxval", 0, &maxval);
+    av_opt_get_double(m_pContext, "rematrix_volume", 0, &volume);
+    av_opt_get_int(m_pContext, "matrix_encoding", 0, &encoding);
+
+    // swr clips float output only if asked to
+    if (maxval <= 0)
+      maxval = INT_MAX;
+
+    memset(m_rematrix, 0, sizeof(m_rematrix));
+    if (swr_build_matrix(m_src_chan_layout, m_dst_chan_layout, center, surround, lfe, maxval, volume,
+                         (double*)m_rematrix, AE_CH_MAX, (AVMatrixEncoding)encoding, NULL) == 0)
+    {
+      m_downmix = new CActiveAERemap();
+      if (!m_downmix->InitDownmix((const double*)m_rematrix, AE_CH_MAX, m_src_channels, m_dst_channels,
+                                  av_sample_fmt_is_planar(m_src_fmt) != 0, av_sample_fmt_is_planar(m_dst_fmt) != 0))
+      {
+        delete m_downmix;
+        m_downmix = NULL;
+      }
+    }
+  }
   return true;
 }
 
@@ -205,6 +244,14 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     }
   }
 
+  // as long as swr holds no samples of its own, the downmix needs no state
+  if (m_downmix && !m_doesResample && src_buffer && src_samples <= dst_samples &&
+      swr_get_delay(m_pContext, m_src_rate) == 0)
+  {
+    m_downmix->Downmix(src_buffer, dst_buffer, src_samples);
+    return src_samples;
+  }
+
   int ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
   if (ret < 0)
   {
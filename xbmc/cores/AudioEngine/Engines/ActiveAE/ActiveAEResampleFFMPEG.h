@@ -33,6 +33,8 @@ struct SwrContext;
 namespace ActiveAE
 {
 
+class CActiveAERemap;
+
 class CActiveAEResampleFFMPEG : public IAEResample
 {
 public:
@@ -59,6 +61,7 @@ protected:
   int m_src_dither_bits, m_dst_dither_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+  CActiveAERemap *m_downmix;
 };
 
 }
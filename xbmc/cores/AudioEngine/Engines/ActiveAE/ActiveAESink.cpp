@@ -24,7 +24,7 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
-#include "utils/EndianSwap.h"
+#include "cores/AudioEngine/Utils/AEPackIEC61937.h"
 #include "ActiveAE.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "utils/log.h"
@@ -978,12 +978,12 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
         case SKIP_SWAP:
           break;
         case NEED_BYTESWAP:
-          Endian_Swap16_buf((uint16_t *)buffer[0], (uint16_t *)buffer[0], size / 2);
+          CAEPackIEC61937::SwapEndian((uint16_t *)buffer[0], (uint16_t *)buffer[0], size / 2);
           break;
         case CHECK_SWAP:
           SwapInit(samples);
           if (m_swapState == NEED_BYTESWAP)
-            Endian_Swap16_buf((uint16_t *)buffer[0], (uint16_t *)buffer[0], size / 2);
+            CAEPackIEC61937::SwapEndian((uint16_t *)buffer[0], (uint16_t *)buffer[0], size / 2);
           break;
         default:
           break;
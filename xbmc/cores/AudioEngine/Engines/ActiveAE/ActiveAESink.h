@@ -102,6 +102,7 @@ public:
   AEDeviceType GetDeviceType(const std::string &device);
   bool HasPassthroughDevice();
   bool SupportsFormat(const std::string &device, AEAudioFormat &format);
+  int64_t GetThreadUsage() { return GetAbsoluteUsage(); }
   CSinkControlProtocol m_controlPort;
   CSinkDataProtocol m_dataPort;
 
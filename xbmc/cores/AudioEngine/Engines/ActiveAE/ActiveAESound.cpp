@@ -23,6 +23,7 @@
 #include "cores/AudioEngine/AEFactory.h"
 #include "ActiveAE.h"
 #include "ActiveAESound.h"
+#include "utils/MappedFile.h"
 #include "utils/log.h"
 
 extern "C" {
@@ -82,6 +83,10 @@ uint8_t** CActiveAESound::InitSound(bool orig, SampleConfig config, int nb_sampl
 
   delete *info;
   *info = new CSoundPacket(config, nb_samples);
+  if (orig)
+    m_orig_mapping.reset();
+  else
+    m_dst_mapping.reset();
 
   (*info)->nb_samples = 0;
   m_isConverted = false;
@@ -116,6 +121,23 @@ bool CActiveAESound::StoreSound(bool orig, uint8_t **buffer, int samples, int li
   return true;
 }
 
+void CActiveAESound::MapSound(bool orig, CMappedFile *file, CSoundPacket *packet)
+{
+  if (orig)
+  {
+    delete m_orig_sound;
+    m_orig_sound = packet;
+    m_orig_mapping.reset(file);
+  }
+  else
+  {
+    delete m_dst_sound;
+    m_dst_sound = packet;
+    m_dst_mapping.reset(file);
+    m_isConverted = true;
+  }
+}
+
 CSoundPacket *CActiveAESound::GetSound(bool orig)
 {
   if (orig)
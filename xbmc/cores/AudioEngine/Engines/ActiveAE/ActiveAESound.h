@@ -22,7 +22,10 @@
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "filesystem/File.h"
 
+#include <memory>
+
 class DllAvUtil;
+class CMappedFile;
 
 namespace ActiveAE
 {
@@ -45,6 +48,8 @@ public:
   uint8_t** InitSound(bool orig, SampleConfig config, int nb_samples);
   bool StoreSound(bool orig, uint8_t **buffer, int samples, int linesize);
   CSoundPacket *GetSound(bool orig);
+  void MapSound(bool orig, CMappedFile *file, CSoundPacket *packet);
+  const std::string& GetFileName() const { return m_filename; }
 
   bool IsConverted() { return m_isConverted; }
   void SetConverted(bool state) { m_isConverted = state; }
@@ -68,6 +73,8 @@ protected:
 
   CSoundPacket *m_orig_sound;
   CSoundPacket *m_dst_sound;
+  std::unique_ptr<CMappedFile> m_orig_mapping;
+  std::unique_ptr<CMappedFile> m_dst_mapping;
 
   bool m_isConverted;
 };
@@ -0,0 +1,332 @@
+/*
+ *      Copyright (C) 2010-2016 Team Kodi
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAESoundCache.h"
+#include "ActiveAESound.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/MappedFile.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+using namespace ActiveAE;
+using namespace XFILE;
+
+#define SOUNDCACHE_PATH    "special://temp/aesounds/"
+#define SOUNDCACHE_MAGIC   "AESC"
+#define SOUNDCACHE_VERSION 1
+#define SOUNDCACHE_ALIGN   16
+#define SOUNDCACHE_MAXAGE  (30 * 24 * 60 * 60)
+#define SOUNDCACHE_MAXSIZE (64 * 1024 * 1024)
+
+namespace
+{
+
+// fixed size header, keeps sample data 16 byte aligned for sse mixing
+struct SoundCacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t sourceSize;
+  int64_t sourceTime;
+  uint64_t channelLayout;
+  int32_t fmt;
+  int32_t channels;
+  int32_t sampleRate;
+  int32_t bitsPerSample;
+  int32_t ditherBits;
+  int32_t samples;
+  int32_t planes;
+  int32_t planeSize;
+};
+
+static_assert(sizeof(SoundCacheHeader) % SOUNDCACHE_ALIGN == 0, "sound cache header breaks alignment");
+
+bool SameConfig(const SoundCacheHeader &header, const SampleConfig &config)
+{
+  return header.fmt == config.fmt &&
+         header.channels == config.channels &&
+         header.channelLayout == config.channel_layout &&
+         header.sampleRate == config.sample_rate;
+}
+
+bool GetSourceStamp(const std::string &filename, int64_t &size, int64_t &time)
+{
+  struct __stat64 st;
+  if (CFile::Stat(filename, &st) != 0)
+    return false;
+
+  size = st.st_size;
+  time = st.st_mtime;
+  return true;
+}
+
+// the planes must hold all samples, as the mixer reads them without further checks
+bool ValidLayout(const SoundCacheHeader &header)
+{
+  if (header.fmt <= AV_SAMPLE_FMT_NONE || header.fmt >= AV_SAMPLE_FMT_NB ||
+      header.channels <= 0 || header.samples <= 0 || header.planeSize <= 0)
+    return false;
+
+  AVSampleFormat fmt = (AVSampleFormat)header.fmt;
+  int planes = av_sample_fmt_is_planar(fmt) ? header.channels : 1;
+  if (header.planes != planes)
+    return false;
+
+  int64_t planeBytes = (int64_t)header.samples * av_get_bytes_per_sample(fmt) * header.channels / planes;
+  return planeBytes <= header.planeSize;
+}
+
+// writes a cache entry off the audio engine's thread
+class CSoundCacheWriteJob : public CJob
+{
+public:
+  CSoundCacheWriteJob(const std::string &filename, const std::string &path, std::vector<uint8_t> &entry)
+    : m_filename(filename), m_path(path)
+  {
+    m_entry.swap(entry);
+  }
+
+  virtual bool DoWork() override
+  {
+    // the stamp is taken here to keep the stat of the source off the calling thread too
+    SoundCacheHeader *header = reinterpret_cast<SoundCacheHeader*>(m_entry.data());
+    if (!GetSourceStamp(m_filename, header->sourceSize, header->sourceTime))
+      return false;
+
+    if (!CDirectory::Exists(SOUNDCACHE_PATH) && !CDirectory::Create(SOUNDCACHE_PATH))
+      return false;
+
+    // write to a temporary file first, a concurrent load must never see a partial entry
+    std::string tmpPath = m_path + ".tmp";
+
+    CFile file;
+    if (!file.OpenForWrite(tmpPath, true))
+      return false;
+
+    bool success = file.Write(m_entry.data(), m_entry.size()) == (ssize_t)m_entry.size();
+    file.Close();
+
+    if (success)
+    {
+      // the old entry may still be mapped, on windows it can only be moved away and
+      // deleted once unmapped, here it keeps its name until then
+      if (CFile::Exists(m_path))
+      {
+        std::string oldPath = m_path + ".old";
+        CFile::Delete(oldPath);
+        if (CFile::Rename(m_path, oldPath))
+          CFile::Delete(oldPath);
+        else
+          CFile::Delete(m_path);
+      }
+      success = CFile::Rename(tmpPath, m_path);
+    }
+
+    if (!success)
+    {
+      CLog::Log(LOGWARNING, "CSoundCacheWriteJob::%s - failed to write %s", __FUNCTION__, m_path.c_str());
+      CFile::Delete(tmpPath);
+    }
+    return success;
+  }
+
+private:
+  std::string m_filename;
+  std::string m_path;
+  std::vector<uint8_t> m_entry;
+};
+
+class CSoundCachePruneJob : public CJob
+{
+public:
+  virtual bool DoWork() override
+  {
+    CFileItemList items;
+    if (!CDirectory::GetDirectory(SOUNDCACHE_PATH, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+      return false;
+
+    struct Entry
+    {
+      std::string path;
+      int64_t size;
+      int64_t time;
+    };
+    std::vector<Entry> entries;
+    int64_t total = 0;
+    int64_t now = time(NULL);
+    int removed = 0;
+
+    for (int i = 0; i < items.Size(); i++)
+    {
+      if (items[i]->m_bIsFolder)
+        continue;
+
+      struct __stat64 st;
+      if (CFile::Stat(items[i]->GetPath(), &st) != 0)
+        continue;
+
+      if (now - st.st_mtime > SOUNDCACHE_MAXAGE)
+      {
+        if (CFile::Delete(items[i]->GetPath()))
+          removed++;
+        continue;
+      }
+
+      Entry entry = { items[i]->GetPath(), st.st_size, st.st_mtime };
+      entries.push_back(entry);
+      total += st.st_size;
+    }
+
+    // oldest first
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) { return lhs.time < rhs.time; });
+    for (std::vector<Entry>::const_iterator it = entries.begin(); it != entries.end() && total > SOUNDCACHE_MAXSIZE; ++it)
+    {
+      if (CFile::Delete(it->path))
+      {
+        total -= it->size;
+        removed++;
+      }
+    }
+
+    if (removed)
+      CLog::Log(LOGDEBUG, "CSoundCachePruneJob::%s - removed %d entries", __FUNCTION__, removed);
+    return true;
+  }
+};
+
+}
+
+std::string CActiveAESoundCache::GetCachePath(const std::string &filename, bool orig, const SampleConfig &config, const Conversion &conversion)
+{
+  std::string path = StringUtils::Format("%s%08x", SOUNDCACHE_PATH, Crc32::Compute(filename));
+  if (orig)
+    return path + ".orig.pcm";
+
+  return path + StringUtils::Format(".%d.%d.%d.%" PRIx64 ".q%d.c%d.n%d.pcm",
+                                    (int)config.fmt, config.sample_rate, config.channels, config.channel_layout,
+                                    (int)conversion.quality, conversion.boostCenter, conversion.normalize ? 1 : 0);
+}
+
+bool CActiveAESoundCache::Load(CActiveAESound &sound, bool orig, const SampleConfig *config, const Conversion *conversion)
+{
+  if (!orig && (!config || !conversion))
+    return false;
+
+  int64_t sourceSize, sourceTime;
+  if (!GetSourceStamp(sound.GetFileName(), sourceSize, sourceTime))
+    return false;
+
+  SampleConfig dummyConfig = {};
+  Conversion dummyConversion = {};
+  std::string path = GetCachePath(sound.GetFileName(), orig, config ? *config : dummyConfig,
+                                  conversion ? *conversion : dummyConversion);
+
+  CMappedFile *file = new CMappedFile();
+  if (!file->Open(path) || file->GetSize() < sizeof(SoundCacheHeader))
+  {
+    delete file;
+    return false;
+  }
+
+  SoundCacheHeader header;
+  memcpy(&header, file->GetData(), sizeof(header));
+
+  bool valid = memcmp(header.magic, SOUNDCACHE_MAGIC, 4) == 0 &&
+               header.version == SOUNDCACHE_VERSION &&
+               header.sourceSize == sourceSize &&
+               header.sourceTime == sourceTime &&
+               ValidLayout(header) &&
+               file->GetSize() >= sizeof(header) + (size_t)header.planes * header.planeSize;
+  if (valid && !orig)
+    valid = SameConfig(header, *config);
+
+  if (!valid)
+  {
+    CLog::Log(LOGDEBUG, "CActiveAESoundCache::%s - stale cache entry for %s", __FUNCTION__, sound.GetFileName().c_str());
+    delete file;
+    return false;
+  }
+
+  SampleConfig cached;
+  cached.fmt = (AVSampleFormat)header.fmt;
+  cached.channel_layout = header.channelLayout;
+  cached.channels = header.channels;
+  cached.sample_rate = header.sampleRate;
+  cached.bits_per_sample = header.bitsPerSample;
+  cached.dither_bits = header.ditherBits;
+
+  uint8_t *samples = const_cast<uint8_t*>(file->GetData()) + sizeof(header);
+  CSoundPacket *packet = new CSoundPacket(cached, header.samples, samples, header.planeSize);
+  sound.MapSound(orig, file, packet);
+  return true;
+}
+
+bool CActiveAESoundCache::Store(CActiveAESound &sound, bool orig, const Conversion *conversion)
+{
+  if (!orig && !conversion)
+    return false;
+
+  CSoundPacket *packet = sound.GetSound(orig);
+  if (!packet || packet->nb_samples <= 0 || packet->external)
+    return false;
+
+  int planeBytes = packet->nb_samples * packet->bytes_per_sample * packet->config.channels / packet->planes;
+
+  SoundCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SOUNDCACHE_MAGIC, 4);
+  header.version = SOUNDCACHE_VERSION;
+  header.channelLayout = packet->config.channel_layout;
+  header.fmt = packet->config.fmt;
+  header.channels = packet->config.channels;
+  header.sampleRate = packet->config.sample_rate;
+  header.bitsPerSample = packet->config.bits_per_sample;
+  header.ditherBits = packet->config.dither_bits;
+  header.samples = packet->nb_samples;
+  header.planes = packet->planes;
+  header.planeSize = (planeBytes + SOUNDCACHE_ALIGN - 1) & ~(SOUNDCACHE_ALIGN - 1);
+
+  // copy the samples, the sound may be freed before the job gets to write them
+  std::vector<uint8_t> entry(sizeof(header) + (size_t)header.planes * header.planeSize, 0);
+  memcpy(entry.data(), &header, sizeof(header));
+  for (int i = 0; i < packet->planes; i++)
+    memcpy(entry.data() + sizeof(header) + (size_t)i * header.planeSize, packet->data[i], planeBytes);
+
+  Conversion dummy = {};
+  std::string path = GetCachePath(sound.GetFileName(), orig, packet->config, conversion ? *conversion : dummy);
+  CJobManager::GetInstance().AddJob(new CSoundCacheWriteJob(sound.GetFileName(), path, entry), NULL, CJob::PRIORITY_LOW);
+  return true;
+}
+
+void CActiveAESoundCache::Prune()
+{
+  CJobManager::GetInstance().AddJob(new CSoundCachePruneJob(), NULL, CJob::PRIORITY_LOW_PAUSABLE);
+}
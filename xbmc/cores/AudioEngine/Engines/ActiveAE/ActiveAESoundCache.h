@@ -0,0 +1,75 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2016 Team Kodi
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAEBuffer.h"
+#include <string>
+
+namespace ActiveAE
+{
+
+class CActiveAESound;
+
+/**
+ * Persistent cache of decoded GUI sounds in special://temp/aesounds/.
+ * Entries store either the original decoded samples or the samples converted
+ * to the engine's internal format. They are validated against size and
+ * modification time of the source file and memory-mapped on load, so mixing
+ * reads straight from the mapped pages. Entries not written for a month are
+ * pruned, as are the oldest ones once the cache grows too large.
+ */
+class CActiveAESoundCache
+{
+public:
+  /**
+   * Settings a converted sound depends on besides its format
+   */
+  struct Conversion
+  {
+    AEQuality quality;
+    int boostCenter;
+    bool normalize;
+  };
+
+  /**
+   * Map a cached sound into the orig or the converted slot of sound
+   * @param config required format of the converted sound, ignored for orig
+   * @param conversion settings the converted sound was made with, ignored for orig
+   */
+  static bool Load(CActiveAESound &sound, bool orig, const SampleConfig *config = NULL, const Conversion *conversion = NULL);
+
+  /**
+   * Write the orig or the converted slot of sound to the cache. The samples are
+   * copied and written by a job, so no file I/O happens on the calling thread
+   * @param conversion settings the converted sound was made with, ignored for orig
+   * @return true if the write was queued
+   */
+  static bool Store(CActiveAESound &sound, bool orig, const Conversion *conversion = NULL);
+
+  /**
+   * Remove old entries and keep the cache below its size limit, runs in a job
+   */
+  static void Prune();
+
+protected:
+  static std::string GetCachePath(const std::string &filename, bool orig, const SampleConfig &config, const Conversion &conversion);
+};
+
+}
@@ -24,10 +24,10 @@
 
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
-#include "cores/AudioEngine/AEResampleFactory.h"
 
 #include "ActiveAE.h"
 #include "ActiveAEStream.h"
+#include "ActiveAERemap.h"
 
 using namespace ActiveAE;
 
@@ -60,7 +60,6 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid)
   m_leftoverBytes = 0;
   m_forceResampler = false;
   m_remapper = NULL;
-  m_remapBuffer = NULL;
   m_streamResampleRatio = 1.0;
   m_streamResampleMode = 0;
   m_profile = 0;
@@ -77,7 +76,6 @@ CActiveAEStream::~CActiveAEStream()
 {
   delete [] m_leftoverBuffer;
   delete m_remapper;
-  delete m_remapBuffer;
 }
 
 void CActiveAEStream::IncFreeBuffers()
@@ -101,81 +99,19 @@ void CActiveAEStream::ResetFreeBuffers()
 void CActiveAEStream::InitRemapper()
 {
   // check if input format follows ffmpeg channel mask
-  bool needRemap = false;
-  unsigned int avLast, avCur = 0;
-  for(unsigned int i=0; i<m_format.m_channelLayout.Count(); i++)
-  {
-    avLast = avCur;
-    avCur = CAEUtil::GetAVChannel(m_format.m_channelLayout[i]);
-    if(avCur < avLast)
-    {
-      needRemap = true;
-      break;
-    }
-  }
-
-  if(needRemap)
+  if (!CActiveAERemap::FollowsFFmpegOrder(m_format.m_channelLayout))
   {
     CLog::Log(LOGDEBUG, "CActiveAEStream::%s - initialize remapper", __FUNCTION__);
 
-    m_remapper = CAEResampleFactory::Create();
-    uint64_t avLayout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
-
-    // build layout according to ffmpeg channel order
-    // we need this for reference
-    CAEChannelInfo ffmpegLayout;
-    ffmpegLayout.Reset();
-    int idx = 0;
-    for(unsigned int i=0; i<m_format.m_channelLayout.Count(); i++)
+    // channels are reordered in place, no extra buffer required
+    CAEChannelInfo ffmpegLayout = CActiveAERemap::GetFFmpegOrder(m_format.m_channelLayout);
+    m_remapper = new CActiveAERemap();
+    if (!m_remapper->InitPermutation(m_format.m_channelLayout, ffmpegLayout, m_format.m_dataFormat))
     {
-      for(unsigned int j=0; j<m_format.m_channelLayout.Count(); j++)
-      {
-        idx = CAEUtil::GetAVChannelIndex(m_format.m_channelLayout[j], avLayout);
-        if (idx == (int)i)
-        {
-          ffmpegLayout += m_format.m_channelLayout[j];
-          break;
-        }
-      }
+      CLog::Log(LOGERROR, "CActiveAEStream::%s - failed to initialize remapper", __FUNCTION__);
+      delete m_remapper;
+      m_remapper = NULL;
     }
-
-    // build remap layout we can pass to resampler as destination layout
-    CAEChannelInfo remapLayout;
-    remapLayout.Reset();
-    for(unsigned int i=0; i<m_format.m_channelLayout.Count(); i++)
-    {
-      for(unsigned int j=0; j<m_format.m_channelLayout.Count(); j++)
-      {
-        idx = CAEUtil::GetAVChannelIndex(m_format.m_channelLayout[j], avLayout);
-        if (idx == (int)i)
-        {
-          remapLayout += ffmpegLayout[j];
-          break;
-        }
-      }
-    }
-
-    // initialize resampler for only doing remapping
-    m_remapper->Init(avLayout,
-                     m_format.m_channelLayout.Count(),
-                     m_format.m_sampleRate,
-                     CAEUtil::GetAVSampleFormat(m_format.m_dataFormat),
-                     CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat),
-                     CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat),
-                     avLayout,
-                     m_format.m_channelLayout.Count(),
-                     m_format.m_sampleRate,
-                     CAEUtil::GetAVSampleFormat(m_format.m_dataFormat),
-                     CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat),
-                     CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat),
-                     false,
-                     false,
-                     &remapLayout,
-                     AE_QUALITY_LOW, // not used for remapping
-                     false);
-
-    // extra sound packet, we can't resample to the same buffer
-    m_remapBuffer = new CSoundPacket(m_inputBuffers->m_allSamples[0]->pkt->config, m_inputBuffers->m_allSamples[0]->pkt->max_nb_samples);
   }
 }
 
@@ -183,19 +119,7 @@ void CActiveAEStream::RemapBuffer()
 {
   if(m_remapper)
   {
-    int samples = m_remapper->Resample(m_remapBuffer->data, m_remapBuffer->max_nb_samples,
-                                       m_currentBuffer->pkt->data, m_currentBuffer->pkt->nb_samples,
-                                       1.0);
-
-    if (samples != m_currentBuffer->pkt->nb_samples)
-    {
-      CLog::Log(LOGERROR, "CActiveAEStream::%s - error remapping", __FUNCTION__);
-    }
-
-    // swap sound packets
-    CSoundPacket *tmp = m_currentBuffer->pkt;
-    m_currentBuffer->pkt = m_remapBuffer;
-    m_remapBuffer = tmp;
+    m_remapper->Remap(m_currentBuffer->pkt->data, m_currentBuffer->pkt->nb_samples);
   }
 }
 
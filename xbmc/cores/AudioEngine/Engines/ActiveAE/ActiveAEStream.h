@@ -89,6 +89,8 @@ protected:
   XbmcThreads::EndTime m_timer;
 };
 
+class CActiveAERemap;
+
 class CActiveAEStreamBuffers
 {
 public:
@@ -200,8 +202,7 @@ protected:
   uint8_t *m_leftoverBuffer;
   int m_leftoverBytes;
   CSampleBuffer *m_currentBuffer;
-  CSoundPacket *m_remapBuffer;
-  IAEResample *m_remapper;
+  CActiveAERemap *m_remapper;
   double m_lastPts;
   double m_lastPtsJump;
   std::atomic_int m_errorInterval;
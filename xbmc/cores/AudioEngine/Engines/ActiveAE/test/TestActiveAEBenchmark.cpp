@@ -0,0 +1,458 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * End to end benchmarks of ActiveAE running over the NULL sink, selected
+ * with AE_SINK=NULL. The NULL sink consumes data in real time, so these are
+ * disabled by default. Run them with
+ *
+ *   kodi-test --gtest_also_run_disabled_tests --gtest_filter='TestActiveAEBenchmark.*'
+ *
+ * and add --gtest_output=xml to collect the recorded properties (cpu per
+ * stream, latency and allocation counts) on a build server.
+ */
+
+#include "system.h"
+
+#if defined(TARGET_LINUX) || defined(TARGET_FREEBSD)
+
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Interfaces/AESound.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Utils/AEStreamData.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "filesystem/File.h"
+#include "settings/Settings.h"
+#include "threads/SystemClock.h"
+#include "utils/EndianSwap.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+#define BENCH_SECONDS     5
+#define BENCH_WARMUP_MS   1000
+#define BENCH_SOUND       "special://temp/aebench.wav"
+
+struct StreamSpec
+{
+  AEDataFormat format;
+  unsigned int sampleRate;
+  AEStdChLayout layout;
+  CAEStreamInfo::DataType rawType;
+  const AEChannel *channels;  ///< replaces the standard layout if set
+};
+
+// 5.1 and 7.1 in wav/alsa order, the back channels ahead of the centre are out of
+// ffmpeg order and make the stream reorder its input
+const AEChannel g_layout51Alsa[] = { AE_CH_FL, AE_CH_FR, AE_CH_BL, AE_CH_BR, AE_CH_FC, AE_CH_LFE, AE_CH_NULL };
+const AEChannel g_layout71Alsa[] = { AE_CH_FL, AE_CH_FR, AE_CH_BL, AE_CH_BR, AE_CH_FC, AE_CH_LFE, AE_CH_SL, AE_CH_SR, AE_CH_NULL };
+
+CAEChannelInfo GetLayout(const StreamSpec &spec)
+{
+  return spec.channels ? CAEChannelInfo(spec.channels) : CAEChannelInfo(spec.layout);
+}
+
+struct StreamState
+{
+  StreamState()
+    : stream(NULL), dataFrames(0), position(0), pts(0), ptsStep(0),
+      delaySum(0), delayMax(0), delayCount(0), startTime(0), playingTime(0) {}
+
+  IAEStream *stream;
+  StreamSpec spec;
+  std::vector<uint8_t> data;
+  unsigned int dataFrames;
+  unsigned int position;
+  double pts;
+  double ptsStep;
+  double delaySum;
+  double delayMax;
+  unsigned int delayCount;
+  unsigned int startTime;
+  unsigned int playingTime;
+};
+
+// cpu time of the engine's own threads, the feeding thread of the benchmark is left out
+double EngineCpuSeconds()
+{
+  ActiveAE::CActiveAE *engine = static_cast<ActiveAE::CActiveAE*>(CAEFactory::GetEngine());
+  return engine->GetThreadUsage() / 1e7;
+}
+
+}
+
+class TestActiveAEBenchmark : public testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    setenv("AE_SINK", "NULL", 1);
+
+    CSettings &settings = CSettings::GetInstance();
+    settings.SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "NULL:NULL");
+    settings.SetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE, "NULL:NULL");
+    settings.SetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE, 48000);
+    settings.SetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE, AE_SOUND_ALWAYS);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGH, false);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_AC3PASSTHROUGH, true);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_EAC3PASSTHROUGH, true);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_DTSPASSTHROUGH, true);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_TRUEHDPASSTHROUGH, true);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_DTSHDPASSTHROUGH, true);
+  }
+
+  virtual void TearDown()
+  {
+    CAEFactory::UnLoadEngine();
+    XFILE::CFile::Delete(BENCH_SOUND);
+    unsetenv("AE_SINK");
+  }
+
+  void StartEngine(int config, AEStdChLayout channels, bool passthrough = false)
+  {
+    CSettings &settings = CSettings::GetInstance();
+    settings.SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, config);
+    settings.SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, channels);
+    settings.SetBool(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGH, passthrough);
+
+    ASSERT_TRUE(CAEFactory::LoadEngine());
+    ASSERT_TRUE(CAEFactory::StartEngine());
+  }
+
+  /* 200ms of 16 bit stereo noise as a stand in for a gui sound */
+  void WriteSound()
+  {
+    const unsigned int rate = 44100;
+    const unsigned int frames = rate / 5;
+    const uint32_t dataSize = frames * 4;
+
+    std::vector<uint8_t> wav(44 + dataSize);
+    uint8_t *p = wav.data();
+    uint32_t u32;
+    uint16_t u16;
+    memcpy(p, "RIFF", 4);
+    u32 = Endian_SwapLE32(36 + dataSize); memcpy(p + 4, &u32, 4);
+    memcpy(p + 8, "WAVEfmt ", 8);
+    u32 = Endian_SwapLE32(16); memcpy(p + 16, &u32, 4);
+    u16 = Endian_SwapLE16(1); memcpy(p + 20, &u16, 2);
+    u16 = Endian_SwapLE16(2); memcpy(p + 22, &u16, 2);
+    u32 = Endian_SwapLE32(rate); memcpy(p + 24, &u32, 4);
+    u32 = Endian_SwapLE32(rate * 4); memcpy(p + 28, &u32, 4);
+    u16 = Endian_SwapLE16(4); memcpy(p + 32, &u16, 2);
+    u16 = Endian_SwapLE16(16); memcpy(p + 34, &u16, 2);
+    memcpy(p + 36, "data", 4);
+    u32 = Endian_SwapLE32(dataSize); memcpy(p + 40, &u32, 4);
+    for (unsigned int i = 0; i < frames * 2; i++)
+    {
+      u16 = Endian_SwapLE16((uint16_t)(rand() & 0x0FFF));
+      memcpy(p + 44 + i * 2, &u16, 2);
+    }
+
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(BENCH_SOUND, true));
+    ASSERT_EQ((ssize_t)wav.size(), file.Write(wav.data(), wav.size()));
+    file.Close();
+  }
+
+  void InitSource(StreamState &state)
+  {
+    if (state.spec.format == AE_FMT_RAW)
+    {
+      /* the engine does not parse passthrough data, a constant payload is
+       * enough to drive the packer */
+      state.dataFrames = 1;
+      if (state.spec.rawType == CAEStreamInfo::STREAM_TYPE_TRUEHD)
+      {
+        /* 24 access units in 2560 byte slots, the unit length is stored in
+         * the last two bytes of each slot like the passthrough codec does */
+        const unsigned int unitSize = 2000;
+        state.data.assign(24 * 2560, 0x55);
+        for (unsigned int i = 0; i < 24; i++)
+        {
+          state.data[i * 2560 + 2558] = unitSize >> 8;
+          state.data[i * 2560 + 2559] = unitSize & 0xFF;
+        }
+        state.ptsStep = 20.0;
+      }
+      else
+      {
+        state.data.assign(1792, 0x55);
+        state.data[0] = 0x0B;
+        state.data[1] = 0x77;
+        state.ptsStep = 32.0;
+      }
+      return;
+    }
+
+    /* one second of a sine per channel, planar or interleaved as the format requires */
+    unsigned int channels = GetLayout(state.spec).Count();
+    state.dataFrames = state.spec.sampleRate;
+    state.data.resize(state.dataFrames * channels * sizeof(float));
+    float *samples = (float*)state.data.data();
+    for (unsigned int i = 0; i < state.dataFrames; i++)
+    {
+      for (unsigned int c = 0; c < channels; c++)
+      {
+        float value = 0.25f * sinf(2.0f * (float)M_PI * (220.0f * (c + 1)) * i / state.spec.sampleRate);
+        if (AE_IS_PLANAR(state.spec.format))
+          samples[c * state.dataFrames + i] = value;
+        else
+          samples[i * channels + c] = value;
+      }
+    }
+  }
+
+  /* returns the number of frames accepted by the stream */
+  unsigned int Feed(StreamState &state)
+  {
+    IAEStream *stream = state.stream;
+    unsigned int space = stream->GetSpace();
+    if (!space)
+      return 0;
+
+    if (state.spec.format == AE_FMT_RAW)
+    {
+      uint8_t *data = state.data.data();
+      unsigned int added = stream->AddData(&data, 0, state.data.size(), state.pts);
+      state.pts += state.ptsStep;
+      return added;
+    }
+
+    unsigned int frameSize = stream->GetFrameSize();
+    unsigned int frames = std::min(space / frameSize, state.dataFrames - state.position);
+    if (!frames)
+      return 0;
+
+    unsigned int channels = GetLayout(state.spec).Count();
+    std::vector<uint8_t*> planes;
+    if (AE_IS_PLANAR(state.spec.format))
+    {
+      for (unsigned int c = 0; c < channels; c++)
+        planes.push_back(state.data.data() + c * state.dataFrames * sizeof(float));
+    }
+    else
+      planes.push_back(state.data.data());
+
+    unsigned int added = stream->AddData(planes.data(), state.position, frames, state.pts);
+    state.position = (state.position + added) % state.dataFrames;
+    state.pts += 1000.0 * added / state.spec.sampleRate;
+    return added;
+  }
+
+  void Run(const char *name, const std::vector<StreamSpec> &specs, bool sounds)
+  {
+    IAESound *sound = NULL;
+    if (sounds)
+    {
+      WriteSound();
+      sound = CAEFactory::MakeSound(BENCH_SOUND);
+      ASSERT_TRUE(sound != NULL);
+    }
+
+    std::vector<StreamState> states(specs.size());
+    for (size_t i = 0; i < specs.size(); i++)
+    {
+      StreamState &state = states[i];
+      state.spec = specs[i];
+      InitSource(state);
+
+      AEAudioFormat format;
+      format.m_dataFormat = state.spec.format;
+      format.m_sampleRate = state.spec.sampleRate;
+      format.m_channelLayout = GetLayout(state.spec);
+      if (state.spec.format == AE_FMT_RAW)
+      {
+        format.m_streamInfo.m_type = state.spec.rawType;
+        format.m_streamInfo.m_sampleRate = 48000;
+        format.m_streamInfo.m_channels = 6;
+        format.m_frameSize = 1;
+      }
+
+      state.stream = CAEFactory::MakeStream(format, 0);
+      ASSERT_TRUE(state.stream != NULL);
+      state.startTime = XbmcThreads::SystemClockMillis();
+    }
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    unsigned int lastSound = start;
+    double cpuStart = 0;
+    unsigned int allocationsStart = 0;
+    bool measuring = false;
+
+    while (true)
+    {
+      unsigned int now = XbmcThreads::SystemClockMillis();
+      if (!measuring && now - start >= BENCH_WARMUP_MS)
+      {
+        /* leave stream creation and initial buffering out of the figures */
+        measuring = true;
+        start = now;
+        cpuStart = EngineCpuSeconds();
+        allocationsStart = ActiveAE::CSoundPacket::GetAllocations();
+      }
+      else if (measuring && now - start >= BENCH_SECONDS * 1000)
+        break;
+
+      unsigned int added = 0;
+      for (size_t i = 0; i < states.size(); i++)
+      {
+        StreamState &state = states[i];
+        added += Feed(state);
+
+        if (!state.playingTime && !state.stream->IsBuffering())
+          state.playingTime = now;
+
+        if (measuring)
+        {
+          double delay = state.stream->GetDelay();
+          state.delaySum += delay;
+          state.delayMax = std::max(state.delayMax, delay);
+          state.delayCount++;
+        }
+      }
+
+      if (sound && now - lastSound >= 250)
+      {
+        sound->Play();
+        lastSound = now;
+      }
+
+      if (!added)
+        usleep(5000);
+    }
+
+    double cpu = EngineCpuSeconds() - cpuStart;
+    unsigned int allocations = ActiveAE::CSoundPacket::GetAllocations() - allocationsStart;
+    double elapsed = (XbmcThreads::SystemClockMillis() - start) / 1000.0;
+
+    double delaySum = 0, delayMax = 0, startup = 0;
+    unsigned int delayCount = 0;
+    for (size_t i = 0; i < states.size(); i++)
+    {
+      delaySum += states[i].delaySum;
+      delayCount += states[i].delayCount;
+      delayMax = std::max(delayMax, states[i].delayMax);
+      if (states[i].playingTime)
+        startup = std::max(startup, (double)(states[i].playingTime - states[i].startTime));
+      CAEFactory::FreeStream(states[i].stream);
+    }
+    if (sound)
+      CAEFactory::FreeSound(sound);
+
+    double cpuPerStream = 100.0 * cpu / elapsed / states.size();
+    double delayAvg = delayCount ? 1000.0 * delaySum / delayCount : 0;
+
+    printf("ActiveAE benchmark %s: %u streams, engine cpu %.2f%% per stream, "
+           "delay avg %.1f ms max %.1f ms, startup %.0f ms, %u packet allocations\n",
+           name, (unsigned int)states.size(), cpuPerStream, delayAvg, 1000.0 * delayMax,
+           startup, allocations);
+
+    RecordProperty("cpu_per_stream_permille", (int)(cpuPerStream * 10));
+    RecordProperty("delay_avg_ms", (int)delayAvg);
+    RecordProperty("delay_max_ms", (int)(1000.0 * delayMax));
+    RecordProperty("startup_ms", (int)startup);
+    RecordProperty("packet_allocations", (int)allocations);
+
+    EXPECT_GT(delayCount, 0U);
+  }
+};
+
+TEST_F(TestActiveAEBenchmark, DISABLED_SingleStream)
+{
+  StartEngine(AE_CONFIG_FIXED, AE_CH_LAYOUT_2_0);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL }
+  };
+  Run("single", specs, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_MultipleStreams)
+{
+  StartEngine(AE_CONFIG_FIXED, AE_CH_LAYOUT_2_0);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL },
+    { AE_FMT_FLOATP, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL },
+    { AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL },
+    { AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL }
+  };
+  Run("multiple", specs, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_Resample)
+{
+  StartEngine(AE_CONFIG_FIXED, AE_CH_LAYOUT_2_0);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_FLOAT, 44100, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL },
+    { AE_FMT_FLOATP, 96000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL }
+  };
+  Run("resample", specs, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_Remap)
+{
+  StartEngine(AE_CONFIG_FIXED, AE_CH_LAYOUT_7_1);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_5_1, CAEStreamInfo::STREAM_TYPE_NULL, g_layout51Alsa },
+    { AE_FMT_FLOATP, 48000, AE_CH_LAYOUT_7_1, CAEStreamInfo::STREAM_TYPE_NULL, g_layout71Alsa }
+  };
+  Run("remap", specs, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_GuiSounds)
+{
+  StartEngine(AE_CONFIG_FIXED, AE_CH_LAYOUT_2_0);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_NULL }
+  };
+  Run("sounds", specs, true);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_PassthroughAC3)
+{
+  StartEngine(AE_CONFIG_AUTO, AE_CH_LAYOUT_2_0, true);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_RAW, 48000, AE_CH_LAYOUT_2_0, CAEStreamInfo::STREAM_TYPE_AC3 }
+  };
+  Run("passthrough ac3", specs, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_PassthroughTrueHD)
+{
+  StartEngine(AE_CONFIG_AUTO, AE_CH_LAYOUT_7_1, true);
+  std::vector<StreamSpec> specs = {
+    { AE_FMT_RAW, 192000, AE_CH_LAYOUT_7_1, CAEStreamInfo::STREAM_TYPE_TRUEHD }
+  };
+  Run("passthrough truehd", specs, false);
+}
+
+#endif
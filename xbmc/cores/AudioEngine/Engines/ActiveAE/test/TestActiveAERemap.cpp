@@ -0,0 +1,186 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAERemap.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+
+#include <vector>
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+namespace
+{
+
+#define TEST_SAMPLES 1027
+
+class CTestResample : public CActiveAEResampleFFMPEG
+{
+public:
+  bool UsesDownmix() const { return m_downmix != NULL; }
+};
+
+// holds float samples and the plane pointers handed to the resampler
+struct SampleBuffer
+{
+  SampleBuffer(int channels, bool planar) : data(channels * TEST_SAMPLES)
+  {
+    int planes = planar ? channels : 1;
+    for (int i = 0; i < planes; i++)
+      this->planes.push_back(reinterpret_cast<uint8_t*>(data.data() + i * TEST_SAMPLES));
+  }
+
+  std::vector<float> data;
+  std::vector<uint8_t*> planes;
+};
+
+void Fill(SampleBuffer &buffer)
+{
+  unsigned int seed = 1;
+  for (auto &sample : buffer.data)
+  {
+    seed = seed * 1103515245 + 12345;
+    sample = (float)((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+  }
+}
+
+// converts with the downmix kernels and with swr itself, force_resample keeps swr in charge
+void CompareWithSwr(uint64_t srcLayout, AVSampleFormat srcFmt, uint64_t dstLayout, AVSampleFormat dstFmt, bool normalize)
+{
+  int srcChannels = av_get_channel_layout_nb_channels(srcLayout);
+  int dstChannels = av_get_channel_layout_nb_channels(dstLayout);
+
+  CTestResample downmix;
+  CTestResample swr;
+  ASSERT_TRUE(downmix.Init(dstLayout, dstChannels, 48000, dstFmt, 32, 0,
+                           srcLayout, srcChannels, 48000, srcFmt, 32, 0,
+                           false, normalize, NULL, AE_QUALITY_MID, false));
+  ASSERT_TRUE(swr.Init(dstLayout, dstChannels, 48000, dstFmt, 32, 0,
+                       srcLayout, srcChannels, 48000, srcFmt, 32, 0,
+                       false, normalize, NULL, AE_QUALITY_MID, true));
+  EXPECT_TRUE(downmix.UsesDownmix());
+  EXPECT_FALSE(swr.UsesDownmix());
+
+  SampleBuffer src(srcChannels, av_sample_fmt_is_planar(srcFmt) != 0);
+  SampleBuffer dstDownmix(dstChannels, av_sample_fmt_is_planar(dstFmt) != 0);
+  SampleBuffer dstSwr(dstChannels, av_sample_fmt_is_planar(dstFmt) != 0);
+  Fill(src);
+
+  EXPECT_EQ(TEST_SAMPLES, downmix.Resample(dstDownmix.planes.data(), TEST_SAMPLES, src.planes.data(), TEST_SAMPLES, 1.0));
+  EXPECT_EQ(TEST_SAMPLES, swr.Resample(dstSwr.planes.data(), TEST_SAMPLES, src.planes.data(), TEST_SAMPLES, 1.0));
+  for (size_t i = 0; i < dstSwr.data.size(); i++)
+    ASSERT_NEAR(dstSwr.data[i], dstDownmix.data[i], 1e-5) << "at sample " << i;
+}
+
+}
+
+TEST(TestActiveAERemap, Downmix51To20)
+{
+  CompareWithSwr(AV_CH_LAYOUT_5POINT1, AV_SAMPLE_FMT_FLTP, AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_FLTP, false);
+}
+
+TEST(TestActiveAERemap, Downmix51BackTo20Interleaved)
+{
+  CompareWithSwr(AV_CH_LAYOUT_5POINT1_BACK, AV_SAMPLE_FMT_FLTP, AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_FLT, false);
+}
+
+TEST(TestActiveAERemap, Downmix71To51)
+{
+  CompareWithSwr(AV_CH_LAYOUT_7POINT1, AV_SAMPLE_FMT_FLTP, AV_CH_LAYOUT_5POINT1, AV_SAMPLE_FMT_FLTP, false);
+}
+
+TEST(TestActiveAERemap, Downmix71To20Normalized)
+{
+  CompareWithSwr(AV_CH_LAYOUT_7POINT1, AV_SAMPLE_FMT_FLTP, AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_FLT, true);
+}
+
+TEST(TestActiveAERemap, DownmixInterleavedInput)
+{
+  CompareWithSwr(AV_CH_LAYOUT_5POINT1, AV_SAMPLE_FMT_FLT, AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_FLT, false);
+}
+
+TEST(TestActiveAERemap, DownmixInPlace)
+{
+  // plain sum of the front pair into mono
+  double matrix[] = { 0.5, 0.5 };
+  CActiveAERemap remap;
+  ASSERT_TRUE(remap.InitDownmix(matrix, 2, 2, 1, false, false));
+
+  float samples[] = { 1.0f, 0.0f, 0.5f, 0.5f, -1.0f, 1.0f, 0.25f, 0.75f };
+  uint8_t *data[] = { reinterpret_cast<uint8_t*>(samples) };
+  remap.Downmix(data, data, 4);
+  EXPECT_FLOAT_EQ(0.5f, samples[0]);
+  EXPECT_FLOAT_EQ(0.5f, samples[1]);
+  EXPECT_FLOAT_EQ(0.0f, samples[2]);
+  EXPECT_FLOAT_EQ(0.5f, samples[3]);
+}
+
+TEST(TestActiveAERemap, PermuteInterleaved)
+{
+  // wav order 5.1 with the back pair ahead of the centre
+  CAEChannelInfo layout;
+  layout.Reset();
+  layout += AE_CH_FL;
+  layout += AE_CH_FR;
+  layout += AE_CH_BL;
+  layout += AE_CH_BR;
+  layout += AE_CH_FC;
+  layout += AE_CH_LFE;
+  EXPECT_FALSE(CActiveAERemap::FollowsFFmpegOrder(layout));
+
+  CAEChannelInfo ffmpegLayout = CActiveAERemap::GetFFmpegOrder(layout);
+  EXPECT_TRUE(CActiveAERemap::FollowsFFmpegOrder(ffmpegLayout));
+
+  CActiveAERemap remap;
+  ASSERT_TRUE(remap.InitPermutation(layout, ffmpegLayout, AE_FMT_S16NE));
+
+  int16_t samples[] = { 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15 };
+  uint8_t *data[] = { reinterpret_cast<uint8_t*>(samples) };
+  remap.Remap(data, 2);
+  int16_t expected[] = { 0, 1, 4, 5, 2, 3, 10, 11, 14, 15, 12, 13 };
+  for (int i = 0; i < 12; i++)
+    EXPECT_EQ(expected[i], samples[i]);
+}
+
+TEST(TestActiveAERemap, PermutePlanar)
+{
+  CAEChannelInfo layout;
+  layout.Reset();
+  layout += AE_CH_FC;
+  layout += AE_CH_FL;
+  layout += AE_CH_FR;
+
+  CActiveAERemap remap;
+  ASSERT_TRUE(remap.InitPermutation(layout, CActiveAERemap::GetFFmpegOrder(layout), AE_FMT_FLOATP));
+
+  float fc[] = { 3.0f, 3.0f };
+  float fl[] = { 1.0f, 1.0f };
+  float fr[] = { 2.0f, 2.0f };
+  uint8_t *data[] = { reinterpret_cast<uint8_t*>(fc), reinterpret_cast<uint8_t*>(fl), reinterpret_cast<uint8_t*>(fr) };
+  remap.Remap(data, 2);
+  EXPECT_FLOAT_EQ(1.0f, fc[0]);
+  EXPECT_FLOAT_EQ(2.0f, fl[1]);
+  EXPECT_FLOAT_EQ(3.0f, fr[0]);
+}
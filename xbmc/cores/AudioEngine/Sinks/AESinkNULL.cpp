@@ -111,6 +111,37 @@ void CAESinkNULL::EnumerateDevices (AEDeviceList &devices, bool passthrough)
   // we never return any devices
 }
 
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  // a virtual hdmi device accepting every format, only enumerated on request
+  // (AE_SINK=NULL) to run the engine on machines without audio hardware
+  CAEDeviceInfo info;
+  info.m_deviceName = "NULL";
+  info.m_displayName = "NULL";
+  info.m_displayNameExtra = "virtual output";
+  info.m_deviceType = AE_DEVTYPE_HDMI;
+  info.m_wantsIECPassthrough = true;
+  info.m_channels = CAEChannelInfo(AE_CH_LAYOUT_7_1);
+
+  const unsigned int rates[] = { 32000, 44100, 48000, 88200, 96000, 176400, 192000 };
+  info.m_sampleRates.assign(rates, rates + sizeof(rates) / sizeof(rates[0]));
+
+  info.m_dataFormats.push_back(AE_FMT_FLOAT);
+  info.m_dataFormats.push_back(AE_FMT_S16NE);
+  info.m_dataFormats.push_back(AE_FMT_RAW);
+
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_AC3);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_EAC3);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD_CORE);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_512);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_1024);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_2048);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_TRUEHD);
+
+  list.push_back(info);
+}
+
 void CAESinkNULL::Process()
 {
   CLog::Log(LOGDEBUG, "CAESinkNULL::Process");
@@ -22,6 +22,7 @@
 #include "system.h"
 #include "threads/Thread.h"
 #include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
 
 class CAESinkNULL : public CThread, public IAESink
 {
@@ -40,6 +41,7 @@ public:
   virtual void         Drain           ();
 
   static void          EnumerateDevices(AEDeviceList &devices, bool passthrough);
+  static void          EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
 private:
   virtual void         Process();
 
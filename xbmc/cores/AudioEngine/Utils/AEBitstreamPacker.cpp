@@ -33,10 +33,7 @@
 #define EAC3_MAX_BURST_PAYLOAD_SIZE (24576 - BURST_HEADER_SIZE)
 
 CAEBitstreamPacker::CAEBitstreamPacker() :
-  m_trueHD   (NULL),
   m_trueHDPos(0),
-  m_dtsHD    (NULL),
-  m_dtsHDSize(0),
   m_eac3     (NULL),
   m_eac3Size (0),
   m_eac3FramesCount(0),
@@ -49,8 +46,6 @@ CAEBitstreamPacker::CAEBitstreamPacker() :
 
 CAEBitstreamPacker::~CAEBitstreamPacker()
 {
-  delete[] m_trueHD;
-  delete[] m_dtsHD;
   delete[] m_eac3;
 }
 
@@ -153,20 +148,18 @@ void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size
   static const uint8_t mat_middle_code[12] = { 0xC3, 0xC1, 0x42, 0x49, 0x3B, 0xFA, 0x82, 0x83, 0x49, 0x80, 0x77, 0xE0 };
   static const uint8_t mat_end_code   [16] = { 0xC3, 0xC2, 0xC0, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97, 0x11 };
 
-  /* create the buffer if it doesnt already exist */
-  if (!m_trueHD)
-  {
-    m_trueHD    = new uint8_t[MAT_FRAME_SIZE];
-    m_trueHDPos = 0;
-  }
+  /* the MAT frame is assembled in place behind the burst header and swapped
+   * there once complete, this saves a full copy of the frame per burst */
+  uint8_t *frame = m_packedBuffer + IEC61937_DATA_OFFSET;
 
   /* setup the frame for the data */
   if (m_trueHDPos == 0)
   {
-    memset(m_trueHD, 0, MAT_FRAME_SIZE);
-    memcpy(m_trueHD, mat_start_code, sizeof(mat_start_code));
-    memcpy(m_trueHD + (12 * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET, mat_middle_code, sizeof(mat_middle_code));
-    memcpy(m_trueHD + MAT_FRAME_SIZE - sizeof(mat_end_code), mat_end_code, sizeof(mat_end_code));
+    m_dataSize = 0;
+    memset(frame, 0, MAT_FRAME_SIZE);
+    memcpy(frame, mat_start_code, sizeof(mat_start_code));
+    memcpy(frame + (12 * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET, mat_middle_code, sizeof(mat_middle_code));
+    memcpy(frame + MAT_FRAME_SIZE - sizeof(mat_end_code), mat_end_code, sizeof(mat_end_code));
   }
 
   size_t offset;
@@ -177,13 +170,13 @@ void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size
   else
     offset = (m_trueHDPos * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE;
 
-  memcpy(m_trueHD + offset, data, size);
+  memcpy(frame + offset, data, size);
 
   /* if we have a full frame */
   if (++m_trueHDPos == 24)
   {
     m_trueHDPos = 0;
-    m_dataSize  = CAEPackIEC61937::PackTrueHD(m_trueHD, MAT_FRAME_SIZE, m_packedBuffer);
+    m_dataSize  = CAEPackIEC61937::PackTrueHD(NULL, MAT_FRAME_SIZE, m_packedBuffer);
   }
 }
 
@@ -192,19 +185,22 @@ void CAEBitstreamPacker::PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size)
   static const uint8_t dtshd_start_code[10] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
   unsigned int dataSize = sizeof(dtshd_start_code) + 2 + size;
 
-  if (dataSize > m_dtsHDSize)
+  if (dataSize >= MAX_IEC61937_PACKET - IEC61937_DATA_OFFSET)
   {
-    delete[] m_dtsHD;
-    m_dtsHDSize = dataSize;
-    m_dtsHD     = new uint8_t[dataSize];
-    memcpy(m_dtsHD, dtshd_start_code, sizeof(dtshd_start_code));
+    CLog::Log(LOGERROR, "CAEBitstreamPacker::PackDTSHD - frame too large: %d", size);
+    m_dataSize = 0;
+    return;
   }
 
-  m_dtsHD[sizeof(dtshd_start_code) + 0] = ((uint16_t)size & 0xFF00) >> 8;
-  m_dtsHD[sizeof(dtshd_start_code) + 1] = ((uint16_t)size & 0x00FF);
-  memcpy(m_dtsHD + sizeof(dtshd_start_code) + 2, data, size);
+  /* build the payload in place and let the packer swap it there */
+  uint8_t *payload = m_packedBuffer + IEC61937_DATA_OFFSET;
+  memcpy(payload, dtshd_start_code, sizeof(dtshd_start_code));
+  payload[sizeof(dtshd_start_code) + 0] = ((uint16_t)size & 0xFF00) >> 8;
+  payload[sizeof(dtshd_start_code) + 1] = ((uint16_t)size & 0x00FF);
+  memcpy(payload + sizeof(dtshd_start_code) + 2, data, size);
+  payload[dataSize] = 0; /* padding byte of odd sized frames */
 
-  m_dataSize = CAEPackIEC61937::PackDTSHD(m_dtsHD, dataSize, m_packedBuffer, info.m_dtsPeriod);
+  m_dataSize = CAEPackIEC61937::PackDTSHD(NULL, dataSize, m_packedBuffer, info.m_dtsPeriod);
 }
 
 void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
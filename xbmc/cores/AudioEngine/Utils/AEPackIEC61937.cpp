@@ -22,13 +22,55 @@
 #include "system.h"
 #include "AEPackIEC61937.h"
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #define IEC61937_PREAMBLE1  0xF872
 #define IEC61937_PREAMBLE2  0x4E1F
 
-inline void SwapEndian(uint16_t *dst, uint16_t *src, unsigned int size)
+void CAEPackIEC61937::SwapEndian(uint16_t *dst, const uint16_t *src, unsigned int size)
 {
-  for (unsigned int i = 0; i < size; ++i, ++dst, ++src)
-    *dst = ((*src & 0xFF00) >> 8) | ((*src & 0x00FF) << 8);
+  unsigned int i = 0;
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  /* 64 bytes per iteration, unaligned loads and stores are cheap enough here
+   * and allow dst == src */
+  for (; i + 32 <= size; i += 32)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + i + 16));
+    __m128i d = _mm_loadu_si128((const __m128i*)(src + i + 24));
+    a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+    b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+    c = _mm_or_si128(_mm_slli_epi16(c, 8), _mm_srli_epi16(c, 8));
+    d = _mm_or_si128(_mm_slli_epi16(d, 8), _mm_srli_epi16(d, 8));
+    _mm_storeu_si128((__m128i*)(dst + i), a);
+    _mm_storeu_si128((__m128i*)(dst + i + 8), b);
+    _mm_storeu_si128((__m128i*)(dst + i + 16), c);
+    _mm_storeu_si128((__m128i*)(dst + i + 24), d);
+  }
+  for (; i + 8 <= size; i += 8)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+    a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+    _mm_storeu_si128((__m128i*)(dst + i), a);
+  }
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  for (; i + 16 <= size; i += 16)
+  {
+    uint8x16_t a = vld1q_u8((const uint8_t*)(src + i));
+    uint8x16_t b = vld1q_u8((const uint8_t*)(src + i + 8));
+    vst1q_u8((uint8_t*)(dst + i), vrev16q_u8(a));
+    vst1q_u8((uint8_t*)(dst + i + 8), vrev16q_u8(b));
+  }
+#endif
+
+  for (; i < size; ++i)
+    dst[i] = ((src[i] & 0xFF00) >> 8) | ((src[i] & 0x00FF) << 8);
 }
 
 int CAEPackIEC61937::PackAC3(uint8_t *data, unsigned int size, uint8_t *dest)
@@ -49,6 +49,12 @@ public:
   static int PackTrueHD  (uint8_t *data, unsigned int size, uint8_t *dest);
   static int PackDTSHD   (uint8_t *data, unsigned int size, uint8_t *dest, unsigned int period);
   static int PackPause(uint8_t *dest, unsigned int millis, unsigned int framesize, unsigned int samplerate, unsigned int rep_priod, unsigned int encodedRate);
+
+  /*!
+   \brief Swap the byte order of size 16 bit words, dst may equal src.
+   Uses SSE2 or NEON where available.
+   */
+  static void SwapEndian(uint16_t *dst, const uint16_t *src, unsigned int size);
 private:
 
   static int PackDTS(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian,
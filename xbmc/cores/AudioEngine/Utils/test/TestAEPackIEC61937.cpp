@@ -0,0 +1,188 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AEPackIEC61937.h"
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/* reference implementation, the scalar packing as it was before the simd kernels */
+namespace
+{
+
+void RefSwap(uint16_t *dst, const uint16_t *src, unsigned int size)
+{
+  for (unsigned int i = 0; i < size; ++i)
+    dst[i] = ((src[i] & 0xFF00) >> 8) | ((src[i] & 0x00FF) << 8);
+}
+
+std::vector<uint8_t> RefPack(const uint8_t *data, unsigned int size, uint16_t type,
+                             uint16_t length, unsigned int burstSize)
+{
+  std::vector<uint8_t> out(burstSize, 0);
+  uint16_t header[4] = { 0xF872, 0x4E1F, type, length };
+  memcpy(out.data(), header, sizeof(header));
+
+  std::vector<uint8_t> padded(data, data + size);
+  if (size & 1)
+    padded.push_back(0);
+  RefSwap((uint16_t*)(out.data() + IEC61937_DATA_OFFSET), (const uint16_t*)padded.data(), padded.size() / 2);
+  return out;
+}
+
+std::vector<uint8_t> MakeData(unsigned int size, unsigned int seed)
+{
+  std::vector<uint8_t> data(size);
+  for (unsigned int i = 0; i < size; i++)
+    data[i] = (uint8_t)(i * 31 + seed * 7 + (i >> 8));
+  return data;
+}
+
+}
+
+TEST(TestAEPackIEC61937, SwapEndian)
+{
+  /* cover the vector bodies, the scalar tail and unaligned pointers */
+  std::vector<uint16_t> src(300), dst(300), ref(300);
+  for (unsigned int i = 0; i < src.size(); i++)
+    src[i] = (uint16_t)(i * 0x0101 + 0x1234);
+
+  for (unsigned int offset = 0; offset < 4; offset++)
+  {
+    for (unsigned int size = 0; size < 280; size += 7)
+    {
+      std::fill(dst.begin(), dst.end(), 0xAAAA);
+      std::fill(ref.begin(), ref.end(), 0xAAAA);
+      CAEPackIEC61937::SwapEndian(dst.data() + offset, src.data() + offset, size);
+      RefSwap(ref.data() + offset, src.data() + offset, size);
+      EXPECT_EQ(0, memcmp(dst.data(), ref.data(), dst.size() * 2)) << "size " << size << " offset " << offset;
+    }
+  }
+}
+
+TEST(TestAEPackIEC61937, SwapEndianInPlace)
+{
+  std::vector<uint16_t> buf(1000), ref(1000);
+  for (unsigned int i = 0; i < buf.size(); i++)
+    buf[i] = (uint16_t)(i * 0x0307);
+
+  RefSwap(ref.data(), buf.data(), 999);
+  ref[999] = buf[999];
+  CAEPackIEC61937::SwapEndian(buf.data(), buf.data(), 999);
+  EXPECT_EQ(0, memcmp(buf.data(), ref.data(), buf.size() * 2));
+}
+
+#ifndef __BIG_ENDIAN__
+TEST(TestAEPackIEC61937, PackAC3)
+{
+  std::vector<uint8_t> data = MakeData(1792, 1);
+  std::vector<uint8_t> ref = RefPack(data.data(), data.size(), 0x01 | ((data[5] & 0x7) << 8),
+                                     data.size() << 3, OUT_FRAMESTOBYTES(AC3_FRAME_SIZE));
+
+  std::vector<uint8_t> out(MAX_IEC61937_PACKET, 0xAA);
+  int size = CAEPackIEC61937::PackAC3(data.data(), data.size(), out.data());
+  ASSERT_EQ((int)ref.size(), size);
+  EXPECT_EQ(0, memcmp(out.data(), ref.data(), size));
+}
+
+TEST(TestAEPackIEC61937, PackEAC3InPlace)
+{
+  std::vector<uint8_t> data = MakeData(4000, 2);
+  std::vector<uint8_t> ref = RefPack(data.data(), data.size(), 0x15, data.size(),
+                                     OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE));
+
+  std::vector<uint8_t> out(MAX_IEC61937_PACKET, 0xAA);
+  memcpy(out.data() + IEC61937_DATA_OFFSET, data.data(), data.size());
+  int size = CAEPackIEC61937::PackEAC3(NULL, data.size(), out.data());
+  ASSERT_EQ((int)ref.size(), size);
+  EXPECT_EQ(0, memcmp(out.data(), ref.data(), size));
+}
+
+TEST(TestAEBitstreamPacker, TrueHD)
+{
+  static const uint8_t mat_start_code [20] = { 0x07, 0x9E, 0x00, 0x03, 0x84, 0x01, 0x01, 0x01, 0x80, 0x00, 0x56, 0xA5, 0x3B, 0xF4, 0x81, 0x83, 0x49, 0x80, 0x77, 0xE0 };
+  static const uint8_t mat_middle_code[12] = { 0xC3, 0xC1, 0x42, 0x49, 0x3B, 0xFA, 0x82, 0x83, 0x49, 0x80, 0x77, 0xE0 };
+  static const uint8_t mat_end_code   [16] = { 0xC3, 0xC2, 0xC0, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97, 0x11 };
+  const unsigned int matFrameSize = 61424;
+
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_TRUEHD;
+  info.m_sampleRate = 48000;
+
+  CAEBitstreamPacker packer;
+  std::vector<uint8_t> mat(matFrameSize, 0);
+  memcpy(mat.data(), mat_start_code, sizeof(mat_start_code));
+  memcpy(mat.data() + 12 * 2560 - 8 - 4, mat_middle_code, sizeof(mat_middle_code));
+  memcpy(mat.data() + matFrameSize - sizeof(mat_end_code), mat_end_code, sizeof(mat_end_code));
+
+  for (unsigned int i = 0; i < 24; i++)
+  {
+    std::vector<uint8_t> unit = MakeData(1200 + i * 16, i);
+    size_t offset;
+    if (i == 0)
+      offset = sizeof(mat_start_code);
+    else if (i == 12)
+      offset = i * 2560 + sizeof(mat_middle_code) - 8 - 4;
+    else
+      offset = i * 2560 - 8;
+    memcpy(mat.data() + offset, unit.data(), unit.size());
+
+    packer.Pack(info, unit.data(), unit.size());
+    if (i < 23)
+      EXPECT_EQ(0U, packer.GetSize());
+  }
+
+  std::vector<uint8_t> ref = RefPack(mat.data(), mat.size(), 0x16, matFrameSize,
+                                     OUT_FRAMESTOBYTES(TRUEHD_FRAME_SIZE));
+  ASSERT_EQ(ref.size(), packer.GetSize());
+  EXPECT_EQ(0, memcmp(packer.GetBuffer(), ref.data(), ref.size()));
+}
+
+TEST(TestAEBitstreamPacker, DTSHD)
+{
+  static const uint8_t dtshd_start_code[10] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
+
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_DTSHD;
+  info.m_dtsPeriod = 2048;
+
+  CAEBitstreamPacker packer;
+  for (unsigned int size = 2011; size < 2014; size++)
+  {
+    std::vector<uint8_t> frame = MakeData(size, size);
+    std::vector<uint8_t> payload(dtshd_start_code, dtshd_start_code + sizeof(dtshd_start_code));
+    payload.push_back((size & 0xFF00) >> 8);
+    payload.push_back(size & 0x00FF);
+    payload.insert(payload.end(), frame.begin(), frame.end());
+
+    std::vector<uint8_t> ref = RefPack(payload.data(), payload.size(), 0x11 | (2 << 8),
+                                       ((payload.size() + 0x17) & ~0x0f) - 0x08, 2048 << 2);
+
+    packer.Reset();
+    packer.Pack(info, frame.data(), frame.size());
+    ASSERT_EQ(ref.size(), packer.GetSize());
+    EXPECT_EQ(0, memcmp(packer.GetBuffer(), ref.data(), ref.size())) << "size " << size;
+  }
+}
+#endif
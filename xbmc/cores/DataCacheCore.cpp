@@ -100,6 +100,28 @@ std::string CDataCacheCore::GetVideoPixelFormat()
   return m_playerVideoInfo.pixFormat;
 }
 
+void CDataCacheCore::SetVideoDecoderThreads(int threads, std::string threadType)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderThreads = threads;
+  m_playerVideoInfo.decoderThreadType = threadType;
+}
+
+int CDataCacheCore::GetVideoDecoderThreads()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreads;
+}
+
+std::string CDataCacheCore::GetVideoDecoderThreadType()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreadType;
+}
+
 void CDataCacheCore::SetVideoDimensions(int width, int height)
 {
   CSingleLock lock(m_videoPlayerSection);
@@ -41,6 +41,9 @@ public:
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(std::string pixFormat);
   std::string GetVideoPixelFormat();
+  void SetVideoDecoderThreads(int threads, std::string threadType);
+  int GetVideoDecoderThreads();
+  std::string GetVideoDecoderThreadType();
   void SetVideoDimensions(int width, int height);
   int GetVideoWidth();
   int GetVideoHeight();
@@ -77,6 +80,8 @@ protected:
     bool isHwDecoder;
     std::string deintMethod;
     std::string pixFormat;
+    int decoderThreads;
+    std::string decoderThreadType;
     int width;
     int height;
     float fps;
@@ -37,6 +37,7 @@ struct TextCacheStruct_t;
 class TiXmlElement;
 class CStreamDetails;
 class CAction;
+class CVariant;
 
 namespace PVR
 {
@@ -368,6 +369,11 @@ public:
 
   virtual void Render(bool clear, uint32_t alpha = 255, bool gui = true) {};
 
+  /*!
+   \brief called by the render thread once the rendered frame is on screen
+   */
+  virtual void FrameFinish() {};
+
   virtual void FlushRenderer() {};
 
   virtual void SetRenderViewMode(int mode) {};
@@ -392,6 +398,8 @@ public:
   virtual void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) {};
   virtual bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) { return false; };
 
+  virtual bool GetFramePacing(CVariant &pacing) { return false; };
+
   std::string m_name;
   std::string m_type;
 
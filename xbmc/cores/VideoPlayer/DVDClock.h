@@ -68,6 +68,7 @@ public:
   void SetMaxSpeedAdjust(double speed);
 
   double GetAbsoluteClock(bool interpolated = true);
+  int64_t GetVblankTime(); /**< host counter at the last vblank, 0 if the reference clock doesn't follow vblank */
   double GetFrequency() { return (double)m_systemFrequency ; }
 
   bool GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
@@ -22,9 +22,31 @@
 #include "DVDClock.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "utils/log.h"
+#include "utils/CPUInfo.h"
 #include "cores/FFmpeg.h"
 #include "Util.h"
 
+#include <algorithm>
+#include <string.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// streaming loads need sse4.1, the rest of the binary is not built for it
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <smmintrin.h>
+#define HAS_STREAM_LOAD
+#define STREAM_LOAD_TARGET __attribute__((target("sse4.1")))
+#elif defined(TARGET_WINDOWS)
+#include <smmintrin.h>
+#define HAS_STREAM_LOAD
+#define STREAM_LOAD_TARGET
+#endif
+
 #ifdef TARGET_WINDOWS
 #pragma comment(lib, "avcodec.lib")
 #pragma comment(lib, "avfilter.lib")
@@ -39,6 +61,39 @@ extern "C" {
 #include "libswscale/swscale.h"
 }
 
+#if defined(HAS_STREAM_LOAD)
+static bool HasStreamLoad()
+{
+  static bool sse4 = (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE4) != 0;
+  return sse4;
+}
+
+STREAM_LOAD_TARGET
+static void CopyRowStreamLoad(uint8_t *dst, const uint8_t *src, int width)
+{
+  // movntdqa needs an aligned source
+  int head = std::min((int)((16 - ((uintptr_t)src & 15)) & 15), width);
+  memcpy(dst, src, head);
+
+  int x = head;
+  for (; x + 64 <= width; x += 64)
+  {
+    __m128i x0 = _mm_stream_load_si128((__m128i*)(src + x));
+    __m128i x1 = _mm_stream_load_si128((__m128i*)(src + x + 16));
+    __m128i x2 = _mm_stream_load_si128((__m128i*)(src + x + 32));
+    __m128i x3 = _mm_stream_load_si128((__m128i*)(src + x + 48));
+    _mm_storeu_si128((__m128i*)(dst + x), x0);
+    _mm_storeu_si128((__m128i*)(dst + x + 16), x1);
+    _mm_storeu_si128((__m128i*)(dst + x + 32), x2);
+    _mm_storeu_si128((__m128i*)(dst + x + 48), x3);
+  }
+  for (; x + 16 <= width; x += 16)
+    _mm_storeu_si128((__m128i*)(dst + x), _mm_stream_load_si128((__m128i*)(src + x)));
+
+  memcpy(dst + x, src + x, width - x);
+}
+#endif
+
 // allocate a new picture (AV_PIX_FMT_YUV420P)
 DVDVideoPicture* CDVDCodecUtils::AllocatePicture(int iWidth, int iHeight)
 {
@@ -83,94 +138,29 @@ void CDVDCodecUtils::FreePicture(DVDVideoPicture* pPicture)
 
 bool CDVDCodecUtils::CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc)
 {
-  uint8_t *s, *d;
   int w = pSrc->iWidth;
   int h = pSrc->iHeight;
 
-  s = pSrc->data[0];
-  d = pDst->data[0];
-
-  for (int y = 0; y < h; y++)
-  {
-    memcpy(d, s, w);
-    s += pSrc->iLineSize[0];
-    d += pDst->iLineSize[0];
-  }
+  CopyPlane(pDst->data[0], pDst->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
 
   w >>= 1;
   h >>= 1;
 
-  s = pSrc->data[1];
-  d = pDst->data[1];
-  for (int y = 0; y < h; y++)
-  {
-    memcpy(d, s, w);
-    s += pSrc->iLineSize[1];
-    d += pDst->iLineSize[1];
-  }
-
-  s = pSrc->data[2];
-  d = pDst->data[2];
-  for (int y = 0; y < h; y++)
-  {
-    memcpy(d, s, w);
-    s += pSrc->iLineSize[2];
-    d += pDst->iLineSize[2];
-  }
+  CopyPlane(pDst->data[1], pDst->iLineSize[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CopyPlane(pDst->data[2], pDst->iLineSize[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
 bool CDVDCodecUtils::CopyPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
   int w = pImage->width * pImage->bpp;
   int h = pImage->height;
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  s = pSrc->data[1];
-  d = pImage->plane[1];
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
+
   w =(pImage->width  >> pImage->cshift_x) * pImage->bpp;
   h =(pImage->height >> pImage->cshift_y);
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
-  s = pSrc->data[2];
-  d = pImage->plane[2];
-  if ((w==pSrc->iLineSize[2]) && ((unsigned int) pSrc->iLineSize[2]==pImage->stride[2]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[2];
-      d += pImage->stride[2];
-    }
-  }
+  CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CopyPlane(pImage->plane[2], pImage->stride[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
@@ -200,26 +190,17 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToNV12Picture(DVDVideoPicture *pSrc)
       pPicture->format = RENDER_FMT_NV12;
       
       // copy luma
-      uint8_t *s = pSrc->data[0];
-      uint8_t *d = pPicture->data[0];
-      for (int y = 0; y < (int)pSrc->iHeight; y++)
-      {
-        memcpy(d, s, pSrc->iWidth);
-        s += pSrc->iLineSize[0];
-        d += pPicture->iLineSize[0];
-      }
+      CopyPlane(pPicture->data[0], pPicture->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0],
+                pSrc->iWidth, pSrc->iHeight);
 
       //copy chroma
       for (int y = 0; y < (int)pSrc->iHeight/2; y++) {
         uint8_t *s_u = pSrc->data[1] + (y * pSrc->iLineSize[1]);
         uint8_t *s_v = pSrc->data[2] + (y * pSrc->iLineSize[2]);
         uint8_t *d_uv = pPicture->data[1] + (y * pPicture->iLineSize[1]);
-        for (int x = 0; x < (int)pSrc->iWidth/2; x++) {
-          *d_uv++ = *s_u++;
-          *d_uv++ = *s_v++;
-        }
+        InterleaveUV(d_uv, s_u, s_v, pSrc->iWidth/2);
       }
-      
+
     }
     else
     {
@@ -288,70 +269,81 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
 
 bool CDVDCodecUtils::CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
   // Copy Y
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+            pSrc->iWidth, pSrc->iHeight);
+
+  // Copy packed UV (width is same as for Y as it's both U and V components)
+  CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1],
+            pSrc->iWidth, pSrc->iHeight >> 1);
+
+  return true;
+}
+
+bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
+{
+  // Copy YUYV
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+            pSrc->iWidth * 2, pSrc->iHeight);
+
+  return true;
+}
+
+void CDVDCodecUtils::CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride,
+                               int width, int height, bool uncached)
+{
+#if defined(HAS_STREAM_LOAD)
+  if (uncached && HasStreamLoad())
   {
-    for (int y = 0; y < h; y++)
+    for (int y = 0; y < height; y++)
     {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
+      CopyRowStreamLoad(dst, src, width);
+      src += srcStride;
+      dst += dstStride;
     }
+    return;
   }
-  
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w = pSrc->iWidth;
-  h = pSrc->iHeight >> 1;
-  // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
+#endif
+
+  if (width == srcStride && srcStride == dstStride)
   {
-    memcpy(d, s, w*h);
+    memcpy(dst, src, width * height);
+    return;
   }
-  else
+
+  for (int y = 0; y < height; y++)
   {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
+    memcpy(dst, src, width);
+    src += srcStride;
+    dst += dstStride;
   }
-
-  return true;
 }
 
-bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
+void CDVDCodecUtils::InterleaveUV(uint8_t *dst, const uint8_t *u, const uint8_t *v, int width)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
-
-  // Copy YUYV
-  if ((w * 2 == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
+  int x = 0;
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  for (; x + 16 <= width; x += 16)
   {
-    memcpy(d, s, w*h*2);
+    __m128i mu = _mm_loadu_si128((const __m128i*)(u + x));
+    __m128i mv = _mm_loadu_si128((const __m128i*)(v + x));
+    _mm_storeu_si128((__m128i*)(dst + 2 * x), _mm_unpacklo_epi8(mu, mv));
+    _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(mu, mv));
   }
-  else
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  for (; x + 16 <= width; x += 16)
   {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w*2);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
+    uint8x16x2_t uv;
+    uv.val[0] = vld1q_u8(u + x);
+    uv.val[1] = vld1q_u8(v + x);
+    vst2q_u8(dst + 2 * x, uv);
+  }
+#endif
+  for (; x < width; x++)
+  {
+    dst[2 * x] = u[x];
+    dst[2 * x + 1] = v[x];
   }
-  
-  return true;
 }
 
 bool CDVDCodecUtils::IsVP3CompatibleWidth(int width)
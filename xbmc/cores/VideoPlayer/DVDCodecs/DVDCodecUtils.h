@@ -42,6 +42,18 @@ public:
   static bool CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc);
   static bool CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc);
 
+  /*!
+   * \brief Copy width bytes of height rows between two planes
+   * \param uncached source is write combined or uncached memory, e.g. a mapped
+   *        pixel buffer, read it with sse4.1 streaming loads when available
+   */
+  static void CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride,
+                        int width, int height, bool uncached = false);
+  /*!
+   * \brief Interleave one row of U and V samples into a NV12 chroma row
+   */
+  static void InterleaveUV(uint8_t *dst, const uint8_t *u, const uint8_t *v, int width);
+
   static bool IsVP3CompatibleWidth(int width);
 
   static double NormalizeFrameduration(double frameduration, bool *match = NULL);
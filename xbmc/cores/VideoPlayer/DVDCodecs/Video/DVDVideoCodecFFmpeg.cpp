@@ -143,6 +143,41 @@ void CDVDVideoCodecFFmpeg::CDropControl::Process(int64_t pts, bool drop)
   m_lastPTS = pts;
 }
 
+// picks the thread count for software decode once when the codec is opened, changing it
+// later needs a reopen, which drops and replays packets. ffmpeg keeps choosing between
+// frame and slice threading, frame threading is what keeps high bitrate streams real time.
+static int GetThreadCount(const AVCodec *codec, int width, int height)
+{
+  int pixels = width * height;
+
+  // size unknown
+  if (pixels <= 0)
+    return std::max(1, std::min(g_cpuInfo.getCPUCount() * 3 / 2, 16));
+
+  // one thread per quarter of a 1080p h264 frame, weighted by the cost of the codec
+  double weight = 1.0;
+  if (codec->id == AV_CODEC_ID_HEVC || codec->id == AV_CODEC_ID_VP9)
+    weight = 2.0;
+  else if (codec->id == AV_CODEC_ID_MPEG1VIDEO || codec->id == AV_CODEC_ID_MPEG2VIDEO)
+    weight = 0.5;
+
+  int maxThreads = std::max(1, std::min(g_cpuInfo.getCPUCount() * 2, 16));
+  const int quarter = 1920 * 1080 / 4;
+  int threads = (int)((pixels * weight + quarter - 1) / quarter);
+  return std::max(std::min(2, maxThreads), std::min(threads, maxThreads));
+}
+
+static const char* GetThreadTypeName(int threadType)
+{
+  if (threadType == FF_THREAD_SLICE)
+    return "slice";
+  else if (threadType == FF_THREAD_FRAME)
+    return "frame";
+  else if (threadType == 0)
+    return "none";
+  return "auto";
+}
+
 enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt)
 {
   CDVDVideoCodecFFmpeg* ctx  = (CDVDVideoCodecFFmpeg*)avctx->opaque;
@@ -371,12 +406,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = g_cpuInfo.getCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      m_pCodecContext->thread_count = GetThreadCount(pCodec, hints.width, hints.height);
+      m_pCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
     }
   }
   else
@@ -431,6 +464,17 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     return false;
   }
 
+  // the mode ffmpeg settled on is only known once the codec is open
+  if (m_decoderState == STATE_SW_MULTI)
+  {
+    m_processInfo.SetVideoDecoderThreads(m_pCodecContext->thread_count,
+                                         GetThreadTypeName(m_pCodecContext->active_thread_type));
+    CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open %s threaded with %d threads",
+              GetThreadTypeName(m_pCodecContext->active_thread_type), m_pCodecContext->thread_count);
+  }
+  else
+    m_processInfo.SetVideoDecoderThreads(0, "");
+
   m_pFrame = av_frame_alloc();
   if (!m_pFrame)
   {
@@ -414,6 +414,15 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput, bool streaminfo, bool filein
   if (g_advancedSettings.m_videoFpsDetect == 0) 
       m_pFormatContext->fps_probe_size = 0;
   
+  // stream details only need what matroska and mp4 carry in their headers,
+  // don't read far into (remote) files to estimate frame rates
+  if (fileinfo && (strncmp(m_pFormatContext->iformat->name, "matroska", 8) == 0 ||
+                   strcmp(m_pFormatContext->iformat->name, "mov,mp4,m4a,3gp,3g2,mj2") == 0))
+  {
+    av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+    m_pFormatContext->fps_probe_size = 0;
+  }
+
   // analyse very short to speed up mjpeg playback start
   if (iformat && (strcmp(iformat->name, "mjpeg") == 0) && m_ioContext->seekable == 0)
     av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
@@ -25,6 +25,7 @@
 #include "pictures/Picture.h"
 #include "video/VideoInfoTag.h"
 #include "filesystem/StackDirectory.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -55,6 +56,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <string.h>
 
 bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
 {
@@ -95,6 +97,266 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+/*!
+ \brief Software decoder for thumbnail keyframes.
+
+ Only decodes keyframes, at the lowest resolution the codec supports that still
+ covers the thumb size and without loop filter. The codec context is kept open
+ while consecutive files share codec, codec tag, size and extradata, which is the common
+ case for a batch of episodes.
+ */
+class CDVDFileInfo::CThumbDecoder
+{
+public:
+  CThumbDecoder();
+  ~CThumbDecoder();
+
+  bool Open(const CDVDStreamInfo &hint);
+  void Close();
+  bool Decode(const DemuxPacket *packet);
+  AVFrame* GetFrame() { return m_frame; }
+
+private:
+  AVCodecContext *m_context;
+  AVFrame *m_frame;
+  AVCodecID m_codecId;
+  unsigned int m_codecTag;
+  int m_bitsPerCodedSample;
+  int m_width;
+  int m_height;
+  std::vector<uint8_t> m_extraData;
+};
+
+CDVDFileInfo::CThumbDecoder::CThumbDecoder()
+{
+  m_context = nullptr;
+  m_frame = nullptr;
+  m_codecId = AV_CODEC_ID_NONE;
+  m_codecTag = 0;
+  m_bitsPerCodedSample = 0;
+  m_width = 0;
+  m_height = 0;
+}
+
+CDVDFileInfo::CThumbDecoder::~CThumbDecoder()
+{
+  Close();
+}
+
+bool CDVDFileInfo::CThumbDecoder::Open(const CDVDStreamInfo &hint)
+{
+  const uint8_t *extraData = (const uint8_t*)hint.extradata;
+  size_t extraSize = hint.extradata ? hint.extrasize : 0;
+
+  if (m_context && m_codecId == hint.codec &&
+      m_codecTag == hint.codec_tag && m_bitsPerCodedSample == hint.bitsperpixel &&
+      m_width == hint.width && m_height == hint.height &&
+      m_extraData.size() == extraSize &&
+      (extraSize == 0 || memcmp(m_extraData.data(), extraData, extraSize) == 0))
+  {
+    avcodec_flush_buffers(m_context);
+    return true;
+  }
+
+  Close();
+
+  AVCodec *codec = avcodec_find_decoder(hint.codec);
+  if (!codec || hint.width <= 0 || hint.height <= 0)
+    return false;
+
+  m_context = avcodec_alloc_context3(codec);
+  if (!m_context)
+    return false;
+
+  // scale down in the decoder as far as the thumb size allows
+  int lowres = 0;
+  while (lowres < av_codec_get_max_lowres(codec) &&
+         (hint.width >> (lowres + 1)) >= (int)g_advancedSettings.m_imageRes)
+    lowres++;
+
+  av_codec_set_lowres(m_context, lowres);
+  m_context->skip_frame = AVDISCARD_NONKEY;
+  m_context->skip_loop_filter = AVDISCARD_ALL;
+  m_context->flags2 |= CODEC_FLAG2_FAST;
+  m_context->thread_count = 1;
+  m_context->workaround_bugs = FF_BUG_AUTODETECT;
+  m_context->codec_tag = hint.codec_tag;
+  m_context->coded_width = hint.width;
+  m_context->coded_height = hint.height;
+  m_context->bits_per_coded_sample = hint.bitsperpixel;
+
+  if (extraSize > 0)
+  {
+    m_context->extradata_size = extraSize;
+    m_context->extradata = (uint8_t*)av_mallocz(extraSize + FF_INPUT_BUFFER_PADDING_SIZE);
+    if (!m_context->extradata)
+    {
+      Close();
+      return false;
+    }
+    memcpy(m_context->extradata, extraData, extraSize);
+  }
+
+  m_frame = av_frame_alloc();
+  if (!m_frame || avcodec_open2(m_context, codec, nullptr) < 0)
+  {
+    CLog::Log(LOGDEBUG, "CDVDFileInfo::CThumbDecoder::%s - unable to open codec %d", __FUNCTION__, hint.codec);
+    Close();
+    return false;
+  }
+
+  m_codecId = hint.codec;
+  m_codecTag = hint.codec_tag;
+  m_bitsPerCodedSample = hint.bitsperpixel;
+  m_width = hint.width;
+  m_height = hint.height;
+  m_extraData.assign(extraData, extraData + extraSize);
+  return true;
+}
+
+void CDVDFileInfo::CThumbDecoder::Close()
+{
+  av_frame_free(&m_frame);
+  avcodec_free_context(&m_context);
+  m_codecId = AV_CODEC_ID_NONE;
+  m_codecTag = 0;
+  m_bitsPerCodedSample = 0;
+  m_width = 0;
+  m_height = 0;
+  m_extraData.clear();
+}
+
+bool CDVDFileInfo::CThumbDecoder::Decode(const DemuxPacket *packet)
+{
+  if (!m_context)
+    return false;
+
+  AVPacket avpkt;
+  av_init_packet(&avpkt);
+  avpkt.data = packet ? packet->pData : nullptr;
+  avpkt.size = packet ? packet->iSize : 0;
+  avpkt.flags = AV_PKT_FLAG_KEY;
+
+  int gotPicture = 0;
+  if (avcodec_decode_video2(m_context, m_frame, &gotPicture, &avpkt) < 0)
+    return false;
+
+  return gotPicture && m_frame->key_frame;
+}
+
+namespace
+{
+
+// decoders are pooled across extraction jobs, at most as many as jobs run at once
+const size_t MAX_THUMB_DECODERS = 4;
+CCriticalSection thumbDecoderSection;
+std::vector<CDVDFileInfo::CThumbDecoder*> thumbDecoders;
+
+}
+
+CDVDFileInfo::CThumbDecoder* CDVDFileInfo::AcquireThumbDecoder()
+{
+  CSingleLock lock(thumbDecoderSection);
+  if (thumbDecoders.empty())
+    return new CThumbDecoder();
+
+  CThumbDecoder *decoder = thumbDecoders.back();
+  thumbDecoders.pop_back();
+  return decoder;
+}
+
+void CDVDFileInfo::ReleaseThumbDecoder(CThumbDecoder *decoder)
+{
+  CSingleLock lock(thumbDecoderSection);
+  if (thumbDecoders.size() < MAX_THUMB_DECODERS)
+    thumbDecoders.push_back(decoder);
+  else
+    delete decoder;
+}
+
+void CDVDFileInfo::FlushThumbDecoders()
+{
+  CSingleLock lock(thumbDecoderSection);
+  for (CThumbDecoder *decoder : thumbDecoders)
+    delete decoder;
+  thumbDecoders.clear();
+}
+
+bool CDVDFileInfo::CacheThumb(uint8_t* const data[], const int lineSize[], int width, int height,
+                              int format, double aspect, int orientation, CTextureDetails &details)
+{
+  unsigned int nWidth = g_advancedSettings.m_imageRes;
+  unsigned int nHeight = (unsigned int)((double)g_advancedSettings.m_imageRes / aspect);
+
+  struct SwsContext *context = sws_getContext(width, height, (AVPixelFormat)format,
+                                              nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+  if (!context)
+    return false;
+
+  uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
+  if (!pOutBuf)
+  {
+    sws_freeContext(context);
+    return false;
+  }
+
+  const uint8_t *src[] = { data[0], data[1], data[2], 0 };
+  int     srcStride[] = { lineSize[0], lineSize[1], lineSize[2], 0 };
+  uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+  int     dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+  sws_scale(context, src, srcStride, 0, height, dst, dstStride);
+  sws_freeContext(context);
+
+  details.width = nWidth;
+  details.height = nHeight;
+  CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+  av_free(pOutBuf);
+  return true;
+}
+
+bool CDVDFileInfo::ExtractKeyframe(CDVDDemux *pDemuxer, int nVideoStream, const CDVDStreamInfo &hint, int nSeekTo,
+                                   CThumbDecoder &decoder, CTextureDetails &details, int &packetsTried)
+{
+  if (!decoder.Open(hint))
+    return false;
+
+  if (!pDemuxer->SeekTime(nSeekTo, true))
+    return false;
+
+  // non keyframes are skipped by the decoder, give up after a few gops
+  bool gotPicture = false;
+  int abort_index = pDemuxer->GetNrOfStreams() * 160;
+  while (!gotPicture && abort_index--)
+  {
+    DemuxPacket* pPacket = pDemuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+    {
+      // drain a picture held back by the decoder's delay
+      gotPicture = decoder.Decode(nullptr);
+      break;
+    }
+
+    if (pPacket->iStreamId == nVideoStream)
+      gotPicture = decoder.Decode(pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+  }
+
+  if (!gotPicture)
+    return false;
+
+  AVFrame *frame = decoder.GetFrame();
+  double aspect = (double)frame->width / frame->height;
+  if (frame->sample_aspect_ratio.num > 0 && frame->sample_aspect_ratio.den > 0)
+    aspect *= av_q2d(frame->sample_aspect_ratio);
+  if (hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+
+  return CacheThumb(frame->data, frame->linesize, frame->width, frame->height,
+                    frame->format, aspect, DegreeToOrientation(hint.orientation), details);
+}
+
 bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
                                 CTextureDetails &details,
                                 CStreamDetails *pStreamDetails, int pos)
@@ -195,20 +457,30 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.software = true;
 
-    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    int nTotalLen = pDemuxer->GetStreamLength();
+    int nSeekTo = (pos==-1) ? nTotalLen / 3 : pos;
 
-    if (pVideoCodec)
+    CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
+
+    // fast path, a single low resolution keyframe from a pooled decoder
+    CThumbDecoder *decoder = AcquireThumbDecoder();
+    bOk = ExtractKeyframe(pDemuxer, nVideoStream, hint, nSeekTo, *decoder, details, packetsTried);
+    ReleaseThumbDecoder(decoder);
+
+    CDVDVideoCodec *pVideoCodec = nullptr;
+    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
+
+    if (!bOk)
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = (pos==-1) ? nTotalLen / 3 : pos;
+      CLog::Log(LOGDEBUG,"%s - keyframe extraction failed in %s, using full decode", __FUNCTION__, redactPath.c_str());
+      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    }
 
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
+    if (pVideoCodec)
+    {
       if (pDemuxer->SeekTime(nSeekTo, true))
       {
         int iDecoderState = VC_ERROR;
@@ -252,34 +524,12 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
         if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
-          {
-            unsigned int nWidth = g_advancedSettings.m_imageRes;
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)g_advancedSettings.m_imageRes / aspect);
-
-            uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+          double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+          if(hint.forced_aspect && hint.aspect != 0)
+            aspect = hint.aspect;
 
-            if (context)
-            {
-              uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
-              int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int     dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
-          }
+          bOk = CacheThumb(picture.data, picture.iLineSize, picture.iWidth, picture.iHeight,
+                           AV_PIX_FMT_YUV420P, aspect, DegreeToOrientation(hint.orientation), details);
         }
         else
         {
@@ -20,11 +20,13 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 class CFileItem;
 class CDVDDemux;
+class CDVDStreamInfo;
 class CStreamDetails;
 class CStreamDetailSubtitle;
 class CDVDInputStream;
@@ -33,11 +35,16 @@ class CTextureDetails;
 class CDVDFileInfo
 {
 public:
+  class CThumbDecoder;
+
   // Extract a thumbnail immage from the media at strPath, optionally populating a streamdetails class with the data
   static bool ExtractThumb(const std::string &strPath,
                            CTextureDetails &details,
                            CStreamDetails *pStreamDetails, int pos=-1);
 
+  // Release the keyframe decoders kept for subsequent thumbnail extractions
+  static void FlushThumbDecoders();
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(CDVDInputStream* pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
@@ -53,4 +60,12 @@ public:
   *   \param[out] details The external subtitle file's StreamDetails.
   */
   static bool AddExternalSubtitleToDetails(const std::string &path, CStreamDetails &details, const std::string& filename, const std::string& subfilename = "");
+
+private:
+  static CThumbDecoder* AcquireThumbDecoder();
+  static void ReleaseThumbDecoder(CThumbDecoder *decoder);
+  static bool ExtractKeyframe(CDVDDemux *pDemuxer, int nVideoStream, const CDVDStreamInfo &hint, int nSeekTo,
+                              CThumbDecoder &decoder, CTextureDetails &details, int &packetsTried);
+  static bool CacheThumb(uint8_t* const data[], const int lineSize[], int width, int height,
+                         int format, double aspect, int orientation, CTextureDetails &details);
 };
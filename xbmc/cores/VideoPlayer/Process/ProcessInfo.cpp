@@ -53,6 +53,8 @@ void CProcessInfo::ResetVideoCodecInfo()
   m_videoDecoderName = "unknown";
   m_videoDeintMethod = "unknown";
   m_videoPixelFormat = "unknown";
+  m_videoDecoderThreads = 0;
+  m_videoDecoderThreadType = "";
   m_videoWidth = 0;
   m_videoHeight = 0;
   m_videoFPS = 0.0;
@@ -66,6 +68,7 @@ void CProcessInfo::ResetVideoCodecInfo()
   CServiceBroker::GetDataCacheCore().SetVideoDecoderName(m_videoDecoderName, m_videoIsHWDecoder);
   CServiceBroker::GetDataCacheCore().SetVideoDeintMethod(m_videoDeintMethod);
   CServiceBroker::GetDataCacheCore().SetVideoPixelFormat(m_videoPixelFormat);
+  CServiceBroker::GetDataCacheCore().SetVideoDecoderThreads(m_videoDecoderThreads, m_videoDecoderThreadType);
   CServiceBroker::GetDataCacheCore().SetVideoDimensions(m_videoWidth, m_videoHeight);
   CServiceBroker::GetDataCacheCore().SetVideoFps(m_videoFPS);
   CServiceBroker::GetDataCacheCore().SetVideoDAR(m_videoDAR);
@@ -128,6 +131,30 @@ std::string CProcessInfo::GetVideoPixelFormat()
   return m_videoPixelFormat;
 }
 
+void CProcessInfo::SetVideoDecoderThreads(int threads, std::string threadType)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecoderThreads = threads;
+  m_videoDecoderThreadType = threadType;
+
+  CServiceBroker::GetDataCacheCore().SetVideoDecoderThreads(m_videoDecoderThreads, m_videoDecoderThreadType);
+}
+
+int CProcessInfo::GetVideoDecoderThreads()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderThreads;
+}
+
+std::string CProcessInfo::GetVideoDecoderThreadType()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderThreadType;
+}
+
 void CProcessInfo::SetVideoDimensions(int width, int height)
 {
   CSingleLock lock(m_videoCodecSection);
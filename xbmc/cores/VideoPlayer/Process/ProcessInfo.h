@@ -40,6 +40,9 @@ public:
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(std::string pixFormat);
   std::string GetVideoPixelFormat();
+  void SetVideoDecoderThreads(int threads, std::string threadType);
+  int GetVideoDecoderThreads();
+  std::string GetVideoDecoderThreadType();
   void SetVideoDimensions(int width, int height);
   void GetVideoDimensions(int &width, int &height);
   void SetVideoFps(float fps);
@@ -84,6 +87,8 @@ protected:
   std::string m_videoDecoderName;
   std::string m_videoDeintMethod;
   std::string m_videoPixelFormat;
+  int m_videoDecoderThreads;
+  std::string m_videoDecoderThreadType;
   int m_videoWidth;
   int m_videoHeight;
   float m_videoFPS;
@@ -5121,6 +5121,11 @@ void CVideoPlayer::Render(bool clear, uint32_t alpha, bool gui)
   m_renderManager.Render(clear, 0, alpha, gui);
 }
 
+void CVideoPlayer::FrameFinish()
+{
+  m_renderManager.FrameFinish();
+}
+
 void CVideoPlayer::FlushRenderer()
 {
   m_renderManager.Flush();
@@ -5200,6 +5205,11 @@ bool CVideoPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned int m
   return m_renderManager.RenderCaptureGetPixels(captureId, millis, buffer, size);
 }
 
+bool CVideoPlayer::GetFramePacing(CVariant &pacing)
+{
+  return m_renderManager.GetFramePacing(pacing);
+}
+
 void CVideoPlayer::VideoParamsChange()
 {
   m_messenger.Put(new CDVDMsg(CDVDMsg::PLAYER_AVCHANGE));
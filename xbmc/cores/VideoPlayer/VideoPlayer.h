@@ -372,6 +372,7 @@ public:
 
   virtual void FrameMove();
   virtual void Render(bool clear, uint32_t alpha = 255, bool gui = true);
+  virtual void FrameFinish() override;
   virtual void FlushRenderer();
   virtual void SetRenderViewMode(int mode);
   float GetRenderAspectRatio();
@@ -389,6 +390,8 @@ public:
   virtual void RenderCaptureRelease(unsigned int captureId);
   virtual bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
 
+  virtual bool GetFramePacing(CVariant &pacing) override;
+
   // IDispResource interface
   virtual void OnLostDisplay();
   virtual void OnResetDisplay();
@@ -0,0 +1,369 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "VideoPlayerBenchmark.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "DVDStreamInfo.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDCodecUtils.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "Process/ProcessInfo.h"
+#include "VideoRenderers/BaseRenderer.h"
+#include "cores/FFmpeg.h"
+
+#if defined(TARGET_POSIX)
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+
+int64_t ProcessCPUTime()
+{
+#if defined(TARGET_WINDOWS)
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    return 0;
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  return (k.QuadPart + u.QuadPart) / 10;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return (int64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+// cpu time of the calling thread only, so a stage isn't charged for the
+// decoder's worker threads or anything else running in the process
+int64_t ThreadCPUTime()
+{
+#if defined(TARGET_WINDOWS)
+  FILETIME creation, exit, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    return 0;
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  return (k.QuadPart + u.QuadPart) / 10;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec now;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+    return 0;
+  return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#else
+  return 0;
+#endif
+}
+
+class CStageTimer
+{
+public:
+  explicit CStageTimer(CVideoPlayerBenchmark::SStage &stage)
+    : m_stage(stage), m_wall(CurrentHostCounter()), m_cpu(ThreadCPUTime()) {}
+  ~CStageTimer()
+  {
+    m_stage.wall += CurrentHostCounter() - m_wall;
+    m_stage.cpu += ThreadCPUTime() - m_cpu;
+    m_stage.calls++;
+  }
+private:
+  CVideoPlayerBenchmark::SStage &m_stage;
+  int64_t m_wall;
+  int64_t m_cpu;
+};
+
+// stands in for a software renderer, pictures are copied into planes the
+// way the renderers upload them, nothing is presented
+class CNullRenderer
+{
+public:
+  CNullRenderer() : m_format(RENDER_FMT_NONE) { memset(&m_image, 0, sizeof(m_image)); }
+
+  // returns true if the buffers had to be (re)allocated
+  bool Configure(const DVDVideoPicture &picture)
+  {
+    if (m_format == picture.format && m_image.width == (unsigned)picture.iWidth &&
+        m_image.height == (unsigned)picture.iHeight)
+      return false;
+
+    m_format = picture.format;
+    memset(&m_image, 0, sizeof(m_image));
+    m_image.width = picture.iWidth;
+    m_image.height = picture.iHeight;
+    m_image.cshift_x = 1;
+    m_image.cshift_y = 1;
+    m_image.bpp = m_format == RENDER_FMT_YUV420P ? 1 : 2;
+    if (m_format == RENDER_FMT_NV12)
+      m_image.bpp = 1;
+
+    for (int p = 0; p < 3; p++)
+    {
+      unsigned int width = p ? m_image.width >> m_image.cshift_x : m_image.width;
+      unsigned int height = p ? m_image.height >> m_image.cshift_y : m_image.height;
+      // nv12 keeps interleaved chroma in the second plane
+      if (m_format == RENDER_FMT_NV12 && p)
+        width *= 2;
+      m_image.stride[p] = width * m_image.bpp;
+      m_image.planesize[p] = m_image.stride[p] * height;
+      m_planes[p].resize(m_image.planesize[p]);
+      m_image.plane[p] = m_planes[p].data();
+    }
+    return true;
+  }
+
+  void AddVideoPicture(DVDVideoPicture &picture)
+  {
+    switch (picture.format)
+    {
+      case RENDER_FMT_YUV420P:
+      case RENDER_FMT_YUV420P10:
+      case RENDER_FMT_YUV420P16:
+        CDVDCodecUtils::CopyPicture(&m_image, &picture);
+        break;
+      case RENDER_FMT_NV12:
+        CDVDCodecUtils::CopyNV12Picture(&m_image, &picture);
+        break;
+      default:
+        // hardware surfaces are not mapped by the null renderer
+        break;
+    }
+  }
+
+private:
+  ERenderFormat m_format;
+  YV12Image m_image;
+  std::vector<uint8_t> m_planes[3];
+};
+
+}
+
+double CVideoPlayerBenchmark::SResult::GetFps() const
+{
+  double seconds = (double)wall / CurrentHostFrequency();
+  return seconds > 0 ? frames / seconds : 0.0;
+}
+
+int64_t CVideoPlayerBenchmark::SResult::GetDecodeCPU() const
+{
+  return std::max<int64_t>(0, cpu - demux.cpu - copy.cpu - render.cpu);
+}
+
+std::string CVideoPlayerBenchmark::SResult::ToString() const
+{
+  double frequency = CurrentHostFrequency() / 1000.0;
+  std::string str = StringUtils::Format("%s %s %dx%d: %d frames %.1f fps, %d dropped, %d errors, %d reopens, "
+                                        "%d demux packets, %d render reconfigures",
+                                        CURL::GetRedacted(file).c_str(), codec.c_str(), width, height,
+                                        frames, GetFps(), dropped, errors, reopens, demuxPackets, reconfigures);
+
+  const SStage *stages[] = { &demux, &decode, &copy, &render };
+  const char *names[] = { "demux", "decode", "copy", "render" };
+  for (int i = 0; i < 4; i++)
+  {
+    str += StringUtils::Format("\n  %-6s %8.1fms wall %8.1fms thread cpu %7d calls",
+                               names[i], stages[i]->wall / frequency, stages[i]->cpu / 1000.0, stages[i]->calls);
+  }
+  str += StringUtils::Format("\n  total  %8.1fms wall %8.1fms process cpu, %8.1fms decode cpu with workers, %.1f MB in %d packets",
+                             wall / frequency, cpu / 1000.0, GetDecodeCPU() / 1000.0,
+                             packetBytes / (1024.0 * 1024.0), packets);
+  return str;
+}
+
+bool CVideoPlayerBenchmark::Run(const std::string &file, const SOptions &options, SResult &result)
+{
+  result = SResult();
+  result.file = file;
+
+  std::string redactPath = CURL::GetRedacted(file);
+  CFileItem item(file, false);
+  item.SetMimeTypeForInternetFile();
+
+  std::unique_ptr<CDVDInputStream> input(CDVDFactoryInputStream::CreateInputStream(NULL, item));
+  if (!input || !input->Open())
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::%s - unable to open %s", __FUNCTION__, redactPath.c_str());
+    return false;
+  }
+
+  std::unique_ptr<CDVDDemux> demux;
+  try
+  {
+    demux.reset(CDVDFactoryDemuxer::CreateDemuxer(input.get(), true));
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::%s - exception thrown when opening demuxer", __FUNCTION__);
+  }
+  if (!demux)
+    return false;
+
+  int streamId = -1;
+  int64_t demuxerId = -1;
+  for (CDemuxStream* stream : demux->GetStreams())
+  {
+    if (stream && stream->type == STREAM_VIDEO && !(stream->flags & AV_DISPOSITION_ATTACHED_PIC) && streamId == -1)
+    {
+      streamId = stream->uniqueId;
+      demuxerId = stream->demuxerId;
+    }
+    else if (stream)
+      demux->EnableStream(stream->demuxerId, stream->uniqueId, false);
+  }
+  if (streamId == -1)
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::%s - no video stream in %s", __FUNCTION__, redactPath.c_str());
+    return false;
+  }
+
+  CDVDStreamInfo hint(*demux->GetStream(demuxerId, streamId), true);
+  hint.software = options.software;
+
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  std::unique_ptr<CDVDVideoCodec> codec(CDVDFactoryCodec::CreateVideoCodec(hint, *processInfo));
+  if (!codec)
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::%s - no decoder for %s", __FUNCTION__, redactPath.c_str());
+    return false;
+  }
+  result.codec = codec->GetName();
+
+  CNullRenderer renderer;
+  DVDVideoPicture picture;
+  int64_t wallStart = CurrentHostCounter();
+  int64_t cpuStart = ProcessCPUTime();
+  bool eof = false;
+
+  while (!eof && (options.maxFrames <= 0 || result.frames < options.maxFrames))
+  {
+    DemuxPacket* packet;
+    {
+      CStageTimer timer(result.demux);
+      packet = demux->Read();
+    }
+
+    int state;
+    if (packet)
+    {
+      result.demuxPackets++;
+      if (packet->iStreamId != streamId)
+      {
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+        continue;
+      }
+      result.packets++;
+      result.packetBytes += packet->iSize;
+
+      {
+        CStageTimer timer(result.decode);
+        state = codec->Decode(packet->pData, packet->iSize, packet->dts, packet->pts);
+      }
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+    }
+    else
+    {
+      // end of file, squeeze out what is left in the decoder
+      eof = true;
+      codec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+      CStageTimer timer(result.decode);
+      state = codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+    }
+
+    while (true)
+    {
+      if (state & VC_ERROR)
+      {
+        result.errors++;
+        break;
+      }
+
+      if (state & VC_REOPEN)
+      {
+        CStageTimer timer(result.decode);
+        codec->Reopen();
+        result.reopens++;
+        break;
+      }
+
+      if (state & VC_PICTURE)
+      {
+        bool valid;
+        {
+          CStageTimer timer(result.copy);
+          memset(&picture, 0, sizeof(picture));
+          valid = codec->GetPicture(&picture);
+        }
+
+        if (!valid || (picture.iFlags & DVP_FLAG_DROPPED))
+          result.dropped++;
+        else
+        {
+          result.frames++;
+          result.width = picture.iWidth;
+          result.height = picture.iHeight;
+          if (options.render)
+          {
+            CStageTimer timer(result.render);
+            if (renderer.Configure(picture))
+              result.reconfigures++;
+            renderer.AddVideoPicture(picture);
+          }
+        }
+        codec->ClearPicture(&picture);
+      }
+
+      if ((state & VC_BUFFER) || !(state & (VC_PICTURE | VC_USERDATA)))
+        break;
+
+      CStageTimer timer(result.decode);
+      state = codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+    }
+  }
+
+  result.wall = CurrentHostCounter() - wallStart;
+  result.cpu = ProcessCPUTime() - cpuStart;
+
+  CLog::Log(LOGDEBUG, "CVideoPlayerBenchmark::%s - %s", __FUNCTION__, result.ToString().c_str());
+  return result.frames > 0;
+}
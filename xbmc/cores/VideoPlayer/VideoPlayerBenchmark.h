@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+/*!
+ \brief Headless demux and decode throughput measurement.
+
+ Runs the VideoPlayer demux and video decode pipeline of a file as fast as
+ possible, without clock sync and without a display. In render mode decoded
+ pictures are handed to a null renderer which only does the copy into render
+ buffers a software renderer would do. Used by the benchmark tests to compare
+ codec paths on build servers.
+ */
+class CVideoPlayerBenchmark
+{
+public:
+  struct SOptions
+  {
+    SOptions() : render(false), software(true), maxFrames(0) {}
+    bool render;    //!< pass decoded pictures to the null renderer
+    bool software;  //!< force software decoding
+    int maxFrames;  //!< stop after this many pictures, 0 decodes the whole file
+  };
+
+  struct SStage
+  {
+    int64_t wall;   //!< host counter ticks spent in the stage
+    int64_t cpu;    //!< cpu time of the benchmark thread in microseconds, without decoder worker threads
+    int calls;
+  };
+
+  struct SResult
+  {
+    std::string file;
+    std::string codec;
+    int width;
+    int height;
+    int packets;
+    int64_t packetBytes;
+    int frames;
+    int dropped;
+    int errors;
+    int reopens;
+    int demuxPackets; //!< packets read from all streams, each one is a demuxer allocation
+    int reconfigures; //!< render buffer (re)allocations of the null renderer
+    SStage demux;
+    SStage decode;
+    SStage copy;
+    SStage render;
+    int64_t wall;
+    int64_t cpu;      //!< process cpu time in microseconds, includes decoder worker threads
+
+    double GetFps() const;
+    //! process cpu minus the other stages, covers the decoder worker threads
+    int64_t GetDecodeCPU() const;
+    std::string ToString() const;
+  };
+
+  static bool Run(const std::string &file, const SOptions &options, SResult &result);
+};
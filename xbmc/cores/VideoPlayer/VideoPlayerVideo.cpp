@@ -907,6 +907,10 @@ std::string CVideoPlayerVideo::GetCodecInfo()
   s << ", ar:"     << std::fixed << std::setprecision(2) << m_processInfo.GetVideoDAR();
   s << ", di:"   << m_processInfo.GetVideoDeintMethod();
 
+  int threads = m_processInfo.GetVideoDecoderThreads();
+  if (threads > 0)
+    s << ", th:" << threads << " " << m_processInfo.GetVideoDecoderThreadType();
+
   return s.str();
 }
 
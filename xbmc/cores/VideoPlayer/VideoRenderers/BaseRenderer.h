@@ -20,6 +20,7 @@
  *
  */
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,8 @@
 #define MAX_PLANES 3
 #define MAX_FIELDS 3
 #define NUM_BUFFERS 6
+// capacity of the render queue, renderers report how much of it they support in CRenderInfo
+#define MAX_RENDER_BUFFERS 12
 
 class CSetting;
 
@@ -91,9 +94,13 @@ public:
   virtual void SetBufferSize(int numBuffers) { }
   virtual void ReleaseBuffer(int idx) { }
   virtual bool NeedBuffer(int idx) { return false; }
+  // the gpu still reads from the buffer, it is kept even if the gui is not rendered
+  virtual bool IsBufferBusy(int idx) { return false; }
   virtual bool IsGuiLayer() { return true; }
   // Render info, can be called before configure
   virtual CRenderInfo GetRenderInfo() { return CRenderInfo(); }
+  // Renderer specific line for the debug overlay, e.g. upload timings
+  virtual void GetDebugInfo(std::string &info) { }
   virtual void Update() = 0;
   virtual void RenderUpdate(bool clear, unsigned int flags = 0, unsigned int alpha = 255) = 0;
   virtual bool RenderCapture(CRenderCapture* capture) = 0;
@@ -44,65 +44,25 @@ CDebugRenderer::~CDebugRenderer()
   }
 }
 
-void CDebugRenderer::SetInfo(std::string &info1, std::string &info2, std::string &info3, std::string &info4, std::string &info5, std::string &info6)
+void CDebugRenderer::SetInfo(std::string &info1, std::string &info2, std::string &info3, std::string &info4, std::string &info5, std::string &info6, std::string &info7)
 {
   m_overlayRenderer.Release(0);
 
-  if (info1 != m_strDebug[0])
-  {
-    m_strDebug[0] = info1;
-    if (m_overlay[0])
-      m_overlay[0]->Release();
-    m_overlay[0] = new CDVDOverlayText();
-    m_overlay[0]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[0]));
-  }
-  if (info2 != m_strDebug[1])
-  {
-    m_strDebug[1] = info2;
-    if (m_overlay[1])
-      m_overlay[1]->Release();
-    m_overlay[1] = new CDVDOverlayText();
-    m_overlay[1]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[1]));
-  }
-  if (info3 != m_strDebug[2])
-  {
-    m_strDebug[2] = info3;
-    if (m_overlay[2])
-      m_overlay[2]->Release();
-    m_overlay[2] = new CDVDOverlayText();
-    m_overlay[2]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[2]));
-  }
-  if (info4 != m_strDebug[3])
-  {
-    m_strDebug[3] = info4;
-    if (m_overlay[3])
-      m_overlay[3]->Release();
-    m_overlay[3] = new CDVDOverlayText();
-    m_overlay[3]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[3]));
-  }
-  if (info5 != m_strDebug[4])
-  {
-    m_strDebug[4] = info5;
-    if (m_overlay[4])
-      m_overlay[4]->Release();
-    m_overlay[4] = new CDVDOverlayText();
-    m_overlay[4]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[4]));
-  }
-  if (info6 != m_strDebug[5])
+  std::string *info[OVERLAY_LINES] = { &info1, &info2, &info3, &info4, &info5, &info6, &info7 };
+  for (int i=0; i<OVERLAY_LINES; i++)
   {
-    m_strDebug[5] = info6;
-    if (m_overlay[5])
-      m_overlay[5]->Release();
-    m_overlay[5] = new CDVDOverlayText();
-    m_overlay[5]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[5]));
+    if (*info[i] != m_strDebug[i])
+    {
+      m_strDebug[i] = *info[i];
+      if (m_overlay[i])
+        m_overlay[i]->Release();
+      m_overlay[i] = new CDVDOverlayText();
+      m_overlay[i]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[i]));
+    }
   }
 
-  m_overlayRenderer.AddOverlay(m_overlay[0], 0, 0);
-  m_overlayRenderer.AddOverlay(m_overlay[1], 0, 0);
-  m_overlayRenderer.AddOverlay(m_overlay[2], 0, 0);
-  m_overlayRenderer.AddOverlay(m_overlay[3], 0, 0);
-  m_overlayRenderer.AddOverlay(m_overlay[4], 0, 0);
-  m_overlayRenderer.AddOverlay(m_overlay[5], 0, 0);
+  for (int i=0; i<OVERLAY_LINES; i++)
+    m_overlayRenderer.AddOverlay(m_overlay[i], 0, 0);
 }
 
 void CDebugRenderer::Render(CRect &src, CRect &dst, CRect &view)
@@ -23,7 +23,7 @@
 #include "OverlayRenderer.h"
 #include <string>
 
-#define OVERLAY_LINES 6
+#define OVERLAY_LINES 7
 
 class CDVDOverlayText;
 
@@ -32,7 +32,7 @@ class CDebugRenderer
 public:
   CDebugRenderer();
   virtual ~CDebugRenderer();
-  void SetInfo(std::string &info1, std::string &info2, std::string &info3, std::string &info4, std::string &info5, std::string &info6);
+  void SetInfo(std::string &info1, std::string &info2, std::string &info3, std::string &info4, std::string &info5, std::string &info6, std::string &info7);
   void Render(CRect &src, CRect &dst, CRect &view);
   void Flush();
 
@@ -0,0 +1,141 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FramePacing.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+
+CFramePacing::CFramePacing()
+{
+  m_samples.reserve(FRAMEPACING_SAMPLES);
+  Reset();
+}
+
+void CFramePacing::Reset()
+{
+  CSingleLock lock(m_section);
+
+  m_samples.clear();
+  m_pos = 0;
+  m_flips = 0;
+  m_repeats = 0;
+  m_underruns = 0;
+  m_skipped = 0;
+  m_ticks = 0;
+  std::fill(m_histogram, m_histogram + FRAMEPACING_HISTOGRAM, 0);
+}
+
+void CFramePacing::Add(const SSample &sample)
+{
+  CSingleLock lock(m_section);
+
+  if (m_samples.size() < FRAMEPACING_SAMPLES)
+    m_samples.push_back(sample);
+  else
+    m_samples[m_pos] = sample;
+  m_pos = (m_pos + 1) % FRAMEPACING_SAMPLES;
+
+  if (sample.decision == FLIP)
+  {
+    // the previous frame is done, account the vsyncs it was shown for
+    if (m_ticks > 0)
+      m_histogram[std::min(m_ticks, (unsigned int)FRAMEPACING_HISTOGRAM) - 1]++;
+    m_ticks = 1;
+    m_flips++;
+  }
+  else
+  {
+    if (m_ticks > 0)
+      m_ticks++;
+    if (sample.decision == UNDERRUN)
+      m_underruns++;
+    else
+      m_repeats++;
+  }
+  m_skipped += sample.skipped;
+}
+
+std::vector<CFramePacing::SSample> CFramePacing::GetSamples() const
+{
+  CSingleLock lock(m_section);
+
+  // oldest first
+  std::vector<SSample> samples;
+  samples.reserve(m_samples.size());
+  if (m_samples.size() == FRAMEPACING_SAMPLES)
+    samples.insert(samples.end(), m_samples.begin() + m_pos, m_samples.end());
+  samples.insert(samples.end(), m_samples.begin(), m_samples.begin() + (m_samples.size() == FRAMEPACING_SAMPLES ? m_pos : m_samples.size()));
+  return samples;
+}
+
+void CFramePacing::GetHistogram(unsigned int (&bins)[FRAMEPACING_HISTOGRAM]) const
+{
+  CSingleLock lock(m_section);
+  std::copy(m_histogram, m_histogram + FRAMEPACING_HISTOGRAM, bins);
+}
+
+std::string CFramePacing::GetSummary() const
+{
+  CSingleLock lock(m_section);
+
+  std::string summary = "Pacing:";
+  for (int i = 0; i < FRAMEPACING_HISTOGRAM; i++)
+    summary += StringUtils::Format(" %d%s:%u", i + 1, i == FRAMEPACING_HISTOGRAM - 1 ? "+" : "", m_histogram[i]);
+  summary += StringUtils::Format("  flip:%u repeat:%u skip:%u underrun:%u", m_flips, m_repeats, m_skipped, m_underruns);
+  return summary;
+}
+
+void CFramePacing::Serialize(CVariant &value) const
+{
+  std::vector<SSample> samples = GetSamples();
+
+  CSingleLock lock(m_section);
+
+  // host counters relative to the oldest sample, all times in milliseconds
+  double frequency = CurrentHostFrequency() / 1000.0;
+  int64_t start = samples.empty() ? 0 : samples.front().vsync;
+
+  value["samples"] = CVariant(CVariant::VariantTypeArray);
+  for (const SSample &sample : samples)
+  {
+    CVariant entry(CVariant::VariantTypeObject);
+    entry["vsync"] = (sample.vsync - start) / frequency;
+    entry["flip"] = sample.flip ? (sample.flip - start) / frequency : 0.0;
+    entry["clock"] = sample.clock / 1000.0;
+    entry["target"] = sample.target / 1000.0;
+    entry["pts"] = sample.pts / 1000.0;
+    entry["decision"] = sample.decision == FLIP ? "flip" : sample.decision == REPEAT ? "repeat" : "underrun";
+    entry["skipped"] = sample.skipped;
+    value["samples"].push_back(entry);
+  }
+
+  value["histogram"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < FRAMEPACING_HISTOGRAM; i++)
+    value["histogram"].push_back(m_histogram[i]);
+
+  value["flips"] = m_flips;
+  value["repeats"] = m_repeats;
+  value["skipped"] = m_skipped;
+  value["underruns"] = m_underruns;
+}
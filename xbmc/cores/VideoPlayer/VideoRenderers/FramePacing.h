@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "threads/CriticalSection.h"
+#include "utils/ISerializable.h"
+
+#define FRAMEPACING_SAMPLES   1024
+#define FRAMEPACING_HISTOGRAM 6
+
+/*!
+ \brief Per vsync record of the render manager's presentation decisions.
+
+ Keeps the last FRAMEPACING_SAMPLES render ticks in a ring buffer plus a
+ histogram of how many vsyncs each frame stayed on screen. A 24p clip on a
+ 24Hz display fills only the first bin, on 60Hz it alternates between the
+ second and third bin (3:2 judder).
+ */
+class CFramePacing : public ISerializable
+{
+public:
+  enum EDecision
+  {
+    FLIP,     //!< a new frame was flipped
+    REPEAT,   //!< no frame due yet, the previous one stays on screen
+    UNDERRUN  //!< the queue was empty while the clock was running
+  };
+
+  struct SSample
+  {
+    int64_t vsync;   //!< host counter at the last vblank of the reference clock, the render tick if it doesn't follow vblank
+    int64_t flip;    //!< host counter once the flipped frame was presented, 0 if nothing was flipped
+    double clock;    //!< player clock at the tick
+    double target;   //!< pts due on screen at this vsync
+    double pts;      //!< pts of the frame on screen after the decision
+    int decision;
+    int skipped;     //!< late frames discarded by this decision
+  };
+
+  CFramePacing();
+
+  void Reset();
+  void Add(const SSample &sample);
+  std::vector<SSample> GetSamples() const;
+  void GetHistogram(unsigned int (&bins)[FRAMEPACING_HISTOGRAM]) const;
+
+  /*!
+   \brief One line histogram and counters for the debug overlay.
+   */
+  std::string GetSummary() const;
+
+  virtual void Serialize(CVariant &value) const override;
+
+private:
+  mutable CCriticalSection m_section;
+  std::vector<SSample> m_samples;
+  unsigned int m_pos;
+  unsigned int m_flips;
+  unsigned int m_repeats;
+  unsigned int m_underruns;
+  unsigned int m_skipped;
+  unsigned int m_ticks;
+  unsigned int m_histogram[FRAMEPACING_HISTOGRAM];
+};
@@ -26,6 +26,7 @@
 #endif
 
 #ifdef HAS_GL
+#include <algorithm>
 #include <locale.h>
 
 #include "LinuxRendererGL.h"
@@ -44,6 +45,7 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "RenderCapture.h"
 #include "RenderFormats.h"
 #include "cores/IPlayer.h"
@@ -110,6 +112,10 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
+  memset(&pboMap, 0, sizeof(pboMap));
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+  fence = NULL;
+#endif
   flipindex = 0;
   hwDec = NULL;
 }
@@ -154,6 +160,11 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_clearColour = 0.0f;
   m_pboSupported = false;
   m_pboUsed = false;
+  m_pboPersistent = false;
+  m_uploadFrame = 0;
+  m_uploadTotal = 0;
+  m_uploadMax = 0;
+  m_uploadFrames = 0;
   m_nonLinStretch = false;
   m_nonLinStretchGui = false;
   m_pixelRatio = 0.0f;
@@ -234,7 +245,7 @@ bool CLinuxRendererGL::ValidateRenderTarget()
     // function pointer for texture might change in
     // call to LoadShaders
     glFinish();
-    for (int i = 0 ; i < NUM_BUFFERS ; i++)
+    for (int i = 0 ; i < MAX_RENDER_BUFFERS ; i++)
       DeleteTexture(i);
 
     // trigger update of video filters
@@ -293,6 +304,11 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
   m_pixelRatio       = 1.0;
 
   m_pboSupported = g_Windowing.IsExtSupported("GL_ARB_pixel_buffer_object");
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+  m_pboPersistent = m_pboSupported &&
+                    g_Windowing.IsExtSupported("GL_ARB_buffer_storage") &&
+                    g_Windowing.IsExtSupported("GL_ARB_sync");
+#endif
 
 #ifdef TARGET_DARWIN_OSX
   // on osx 10.9 mavericks we get a strange ripple
@@ -303,7 +319,7 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
     std::string rendervendor = g_Windowing.GetRenderVendor();
     StringUtils::ToLower(rendervendor);
     if (rendervendor.find("intel") != std::string::npos)
-      m_pboSupported = false;
+      m_pboSupported = m_pboPersistent = false;
   }
 #endif
 
@@ -487,6 +503,8 @@ void CLinuxRendererGL::LoadPlane( YUVPLANE& plane, int type, unsigned flipindex
   if(plane.flipindex == flipindex)
     return;
 
+  int64_t start = CurrentHostCounter();
+
   //if no pbo given, use the plane pbo
   GLuint currPbo;
   if (pbo)
@@ -528,6 +546,7 @@ void CLinuxRendererGL::LoadPlane( YUVPLANE& plane, int type, unsigned flipindex
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 
   plane.flipindex = flipindex;
+  m_uploadFrame += CurrentHostCounter() - start;
 }
 
 void CLinuxRendererGL::Reset()
@@ -699,6 +718,17 @@ void CLinuxRendererGL::FlipPage(int source)
 
   m_buffers[m_iYV12RenderBuffer].flipindex = ++m_flipindex;
 
+  m_uploadTotal += m_uploadFrame;
+  m_uploadMax = std::max(m_uploadMax, m_uploadFrame);
+  m_uploadFrames++;
+  m_uploadFrame = 0;
+
+  // kick off the dma from the pbos right away, the textures are not needed before the
+  // gui has been rendered, so the transfer overlaps with it and with decoding the next frame.
+  // fields are uploaded on demand in Render, they depend on the current deinterlacing pass
+  if (m_pboUsed && m_currentField == FIELD_FULL && m_buffers[m_iYV12RenderBuffer].pbo[0])
+    UploadTexture(m_iYV12RenderBuffer);
+
   return;
 }
 
@@ -1056,7 +1086,7 @@ void CLinuxRendererGL::UnInit()
   }
 
   // YV12 textures
-  for (int i = 0; i < NUM_BUFFERS; ++i)
+  for (int i = 0; i < MAX_RENDER_BUFFERS; ++i)
   {
     DeleteTexture(i);
   }
@@ -1646,19 +1676,25 @@ void CLinuxRendererGL::DeleteTexture(int index)
     DeleteYUV422PackedTexture(index);
   else
     DeleteYV12Texture(index);
+
+  DeleteFence(m_buffers[index]);
 }
 
 bool CLinuxRendererGL::UploadTexture(int index)
 {
+  bool ret;
   if (m_format == RENDER_FMT_NV12)
-    return UploadNV12Texture(index);
+    ret = UploadNV12Texture(index);
   else if (m_format == RENDER_FMT_YUYV422 ||
            m_format == RENDER_FMT_UYVY422)
-    return UploadYUV422PackedTexture(index);
+    ret = UploadYUV422PackedTexture(index);
   else
-    return UploadYV12Texture(index);
+    ret = UploadYV12Texture(index);
 
-  return false;
+  if (ret)
+    FencePbo(m_buffers[index]);
+
+  return ret;
 }
 
 //********************************************************************************************************
@@ -1704,13 +1740,12 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
 
     for (int i = 0; i < 3; i++)
     {
-      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
-      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
-      if (pboPtr)
+      im.plane[i] = CreatePbo(pbo[i], im.planesize[i]);
+      if (im.plane[i])
       {
-        im.plane[i] = (BYTE*) pboPtr + PBO_OFFSET;
         memset(im.plane[i], 0, im.planesize[i]);
+        if (m_pboPersistent)
+          m_buffers[index].pboMap[i] = im.plane[i];
       }
       else
       {
@@ -1729,6 +1764,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
       }
       glDeleteBuffersARB(3, pbo);
       memset(m_buffers[index].pbo, 0, sizeof(m_buffers[index].pbo));
+      memset(m_buffers[index].pboMap, 0, sizeof(m_buffers[index].pboMap));
     }
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
@@ -1920,6 +1956,7 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
       }
       glDeleteBuffersARB(1, pbo + p);
       pbo[p] = 0;
+      m_buffers[index].pboMap[p] = NULL;
     }
     else
     {
@@ -2037,13 +2074,12 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
 
     for (int i = 0; i < 2; i++)
     {
-      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
-      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
-      if (pboPtr)
+      im.plane[i] = CreatePbo(pbo[i], im.planesize[i]);
+      if (im.plane[i])
       {
-        im.plane[i] = (BYTE*)pboPtr + PBO_OFFSET;
         memset(im.plane[i], 0, im.planesize[i]);
+        if (m_pboPersistent)
+          m_buffers[index].pboMap[i] = im.plane[i];
       }
       else
       {
@@ -2062,6 +2098,7 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
       }
       glDeleteBuffersARB(2, pbo);
       memset(m_buffers[index].pbo, 0, sizeof(m_buffers[index].pbo));
+      memset(m_buffers[index].pboMap, 0, sizeof(m_buffers[index].pboMap));
     }
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
@@ -2178,6 +2215,7 @@ void CLinuxRendererGL::DeleteNV12Texture(int index)
       }
       glDeleteBuffersARB(1, pbo + p);
       pbo[p] = 0;
+      m_buffers[index].pboMap[p] = NULL;
     }
     else
     {
@@ -2271,6 +2309,7 @@ void CLinuxRendererGL::DeleteYUV422PackedTexture(int index)
     }
     glDeleteBuffersARB(1, pbo);
     pbo[0] = 0;
+    m_buffers[index].pboMap[0] = NULL;
   }
   else
   {
@@ -2319,12 +2358,11 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     pboSetup = true;
     glGenBuffersARB(1, pbo);
 
-    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[0]);
-    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[0] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-    void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
-    if (pboPtr)
+    im.plane[0] = CreatePbo(pbo[0], im.planesize[0]);
+    if (im.plane[0])
     {
-      im.plane[0] = (BYTE*)pboPtr + PBO_OFFSET;
+      if (m_pboPersistent)
+        m_buffers[index].pboMap[0] = im.plane[0];
       memset(im.plane[0], 0, im.planesize[0]);
     }
     else
@@ -2339,6 +2377,7 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
       glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
       glDeleteBuffersARB(1, pbo);
       memset(m_buffers[index].pbo, 0, sizeof(m_buffers[index].pbo));
+      memset(m_buffers[index].pboMap, 0, sizeof(m_buffers[index].pboMap));
     }
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
@@ -2518,6 +2557,31 @@ bool CLinuxRendererGL::Supports(ESCALINGMETHOD method)
   return false;
 }
 
+BYTE* CLinuxRendererGL::CreatePbo(GLuint pbo, int size)
+{
+  void* pboPtr;
+  glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo);
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+  if (m_pboPersistent)
+  {
+    // immutable storage that stays mapped for the lifetime of the buffer, the decoder
+    // writes straight into it and reuse is guarded by a fence, see IsBufferBusy
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER_ARB, size + PBO_OFFSET, NULL, flags);
+    pboPtr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_ARB, 0, size + PBO_OFFSET, flags);
+  }
+  else
+#endif
+  {
+    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
+    pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+  }
+
+  if (!pboPtr)
+    return NULL;
+  return (BYTE*)pboPtr + PBO_OFFSET;
+}
+
 void CLinuxRendererGL::BindPbo(YUVBUFFER& buff)
 {
   bool pbo = false;
@@ -2525,6 +2589,13 @@ void CLinuxRendererGL::BindPbo(YUVBUFFER& buff)
   {
     if(!buff.pbo[plane] || buff.image.plane[plane] == (BYTE*)PBO_OFFSET)
       continue;
+
+    // persistent buffers are never unmapped, switch to the offset used by glTexSubImage2D
+    if(buff.pboMap[plane])
+    {
+      buff.image.plane[plane] = (BYTE*)PBO_OFFSET;
+      continue;
+    }
     pbo = true;
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.pbo[plane]);
@@ -2542,6 +2613,12 @@ void CLinuxRendererGL::UnBindPbo(YUVBUFFER& buff)
   {
     if(!buff.pbo[plane] || buff.image.plane[plane] != (BYTE*)PBO_OFFSET)
       continue;
+
+    if(buff.pboMap[plane])
+    {
+      buff.image.plane[plane] = buff.pboMap[plane];
+      continue;
+    }
     pbo = true;
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.pbo[plane]);
@@ -2552,11 +2629,64 @@ void CLinuxRendererGL::UnBindPbo(YUVBUFFER& buff)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 }
 
+void CLinuxRendererGL::FencePbo(YUVBUFFER& buff)
+{
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+  if (!buff.pboMap[0])
+    return;
+
+  DeleteFence(buff);
+  buff.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+void CLinuxRendererGL::DeleteFence(YUVBUFFER& buff)
+{
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+  if (buff.fence)
+  {
+    glDeleteSync(buff.fence);
+    buff.fence = NULL;
+  }
+#endif
+}
+
+bool CLinuxRendererGL::IsBufferBusy(int idx)
+{
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+  // keep persistent pbos away from the decoder until the gpu has read them,
+  // only poll, the render thread must not stall on a pending upload
+  YUVBUFFER &buf = m_buffers[idx];
+  if (buf.fence)
+  {
+    if (glClientWaitSync(buf.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+      return true;
+    DeleteFence(buf);
+  }
+#endif
+  return false;
+}
+
+void CLinuxRendererGL::GetDebugInfo(std::string &info)
+{
+  double avg = 0.0;
+  if (m_uploadFrames > 0)
+    avg = (double)m_uploadTotal * 1000 / CurrentHostFrequency() / m_uploadFrames;
+  double max = (double)m_uploadMax * 1000 / CurrentHostFrequency();
+
+  info = StringUtils::Format("Upload cpu: %.2f/%.2f ms (%s)", avg, max,
+                             !m_pboUsed ? "sync" : m_pboPersistent ? "pbo persistent" : "pbo");
+
+  m_uploadTotal = 0;
+  m_uploadMax = 0;
+  m_uploadFrames = 0;
+}
+
 CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
   info.formats = m_formats;
-  info.max_buffer_size = NUM_BUFFERS;
+  info.max_buffer_size = MAX_RENDER_BUFFERS;
   info.optimal_buffer_size = 4;
   return info;
 }
@@ -23,6 +23,7 @@
 #include "system.h"
 
 #ifdef HAS_GL
+#include <string>
 #include <vector>
 
 #include "system_gl.h"
@@ -128,10 +129,12 @@ public:
   virtual void Reset(); /* resets renderer after seek for example */
   virtual void Flush();
   virtual void SetBufferSize(int numBuffers) { m_NumYV12Buffers = numBuffers; }
+  virtual bool IsBufferBusy(int idx);
   virtual void RenderUpdate(bool clear, DWORD flags = 0, DWORD alpha = 255);
   virtual void Update();
   virtual bool RenderCapture(CRenderCapture* capture);
   virtual CRenderInfo GetRenderInfo();
+  virtual void GetDebugInfo(std::string &info);
 
   // Feature support
   virtual bool SupportsMultiPassRendering();
@@ -237,11 +240,15 @@ protected:
     YV12Image image;
     unsigned  flipindex; /* used to decide if this has been uploaded */
     GLuint    pbo[MAX_PLANES];
+    BYTE*     pboMap[MAX_PLANES]; /* persistent mapping of pbo, stays valid while bound */
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+    GLsync    fence; /* signals that the gpu is done reading the persistent pbos */
+#endif
 
     void *hwDec;
   };
 
-  typedef YUVBUFFER          YUVBUFFERS[NUM_BUFFERS];
+  typedef YUVBUFFER          YUVBUFFERS[MAX_RENDER_BUFFERS];
 
   // YV12 decoder textures
   // field index 0 is full image, 1 is odd scanlines, 2 is even scanlines
@@ -270,10 +277,21 @@ protected:
   GLuint             m_rgbPbo;
   struct SwsContext *m_context;
 
+  BYTE* CreatePbo(GLuint pbo, int size);
   void BindPbo(YUVBUFFER& buff);
   void UnBindPbo(YUVBUFFER& buff);
+  void FencePbo(YUVBUFFER& buff);
+  void DeleteFence(YUVBUFFER& buff);
   bool m_pboSupported;
   bool m_pboUsed;
+  bool m_pboPersistent;
+
+  // cpu time spent issuing the texture uploads for the debug overlay,
+  // the transfer itself runs asynchronously on the gpu and isn't included
+  int64_t m_uploadFrame;
+  int64_t m_uploadTotal;
+  int64_t m_uploadMax;
+  int m_uploadFrames;
 
   bool  m_nonLinStretch;
   bool  m_nonLinStretchGui;
@@ -98,7 +98,7 @@ void CRenderer::Flush()
 {
   CSingleLock lock(m_section);
 
-  for(int i = 0; i < NUM_BUFFERS; i++)
+  for(int i = 0; i < MAX_RENDER_BUFFERS; i++)
     Release(m_buffers[i]);
 
   ReleaseCache();
@@ -120,6 +120,7 @@ void CRenderer::ReleaseCache()
     delete overlay.second;
   }
   m_textureCache.clear();
+  m_assCache.clear();
   m_textureid++;
 }
 
@@ -144,6 +145,7 @@ void CRenderer::ReleaseUnused()
     if (!found)
     {
       delete it->second;
+      m_assCache.erase(it->first);
       it = m_textureCache.erase(it);
     }
     else
@@ -355,16 +357,64 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
+
+  SAssState state;
+  state.pts = pts;
+  state.targetWidth = targetWidth;
+  state.targetHeight = targetHeight;
+  state.videoWidth = videoWidth;
+  state.videoHeight = videoHeight;
+  state.useMargin = useMargin;
+  state.position = position;
+  state.hash = 0;
+
+  std::map<unsigned int, COverlay*>::iterator cached = m_textureCache.end();
+  std::map<unsigned int, SAssState>::iterator cachedState = m_assCache.end();
+  if(o->m_textureid)
+  {
+    cached = m_textureCache.find(o->m_textureid);
+    cachedState = m_assCache.find(o->m_textureid);
+  }
+
+  bool sameLayout = false;
+  if (cached != m_textureCache.end() && cachedState != m_assCache.end())
+  {
+    const SAssState &last = cachedState->second;
+    sameLayout = last.targetWidth == targetWidth && last.targetHeight == targetHeight &&
+                 last.videoWidth == videoWidth && last.videoHeight == videoHeight &&
+                 last.useMargin == useMargin && last.position == position;
+
+    // same frame again, a repeated vsync or the second eye in stereo modes
+    if (sameLayout && last.pts == pts)
+      return cached->second;
+  }
+
   int changes = 0;
   ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
 
-  if(o->m_textureid)
+  state.hash = hash_images(images);
+  state.bitmapHash = 0;
+  if (cached != m_textureCache.end())
   {
-    if(changes == 0)
+    if (changes == 0)
     {
-      std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-      if (it != m_textureCache.end())
-        return it->second;
+      if (cachedState != m_assCache.end())
+        cachedState->second.pts = pts;
+      return cached->second;
+    }
+
+    // libass flags a change on every event boundary, also when the composed
+    // images are the same, e.g. karaoke timing tags without a visible effect.
+    // the pixels are only read once the image list matches, a texture built
+    // after a layout change has no bitmap hash yet and is rebuilt once more
+    if (sameLayout && cachedState->second.hash == state.hash)
+    {
+      state.bitmapHash = hash_bitmaps(images);
+      if (cachedState->second.bitmapHash == state.bitmapHash)
+      {
+        cachedState->second.pts = pts;
+        return cached->second;
+      }
     }
   }
 
@@ -383,6 +433,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
   m_textureCache[m_textureid] = overlay;
+  m_assCache[m_textureid] = state;
   o->m_textureid = m_textureid;
   m_textureid++;
   return overlay;
@@ -110,8 +110,24 @@ namespace OVERLAY {
     void ReleaseUnused();
 
     CCriticalSection m_section;
-    std::vector<SElement> m_buffers[NUM_BUFFERS];
+    std::vector<SElement> m_buffers[MAX_RENDER_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+
+    // parameters and content of the last libass render per texture, a repeated
+    // vsync of the same frame skips libass, identical output keeps the texture
+    struct SAssState
+    {
+      double pts;
+      int targetWidth;
+      int targetHeight;
+      int videoWidth;
+      int videoHeight;
+      int useMargin;
+      double position;
+      uint64_t hash;        // position, size and colour of the images
+      uint64_t bitmapHash;  // content of the glyph bitmaps, 0 until the image list repeated
+    };
+    std::map<unsigned int, SAssState> m_assCache;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
@@ -27,6 +27,9 @@
 #include "guilib/GraphicContext.h"
 #include "settings/Settings.h"
 
+#include <map>
+#include <vector>
+
 namespace OVERLAY {
 
 static uint32_t build_rgba(int a, int r, int g, int b, bool mergealpha)
@@ -189,62 +192,77 @@ bool convert_quad(ASS_Image* images, SQuads& quads, int max_x)
   if (!images)
     return false;
 
-  // first calculate how many glyph we have and the total x length
+  // place the glyphs in the texture, libass hands out the same cached bitmap
+  // for repeated glyphs (karaoke fill and outline passes, duplicated lines),
+  // those are packed once and share the texture coordinates
 
-  for(img = images; img; img = img->next)
+  struct SPlacement
   {
-    // fully transparent or width or height is 0 -> not displayed
-    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
-      continue;
-
-    quads.size_x += img->w + 1;
-    quads.count++;
-  }
-
-  if (quads.count == 0)
-    return false;
-
-  if (quads.size_x > max_x)
-    quads.size_x = max_x;
+    int u, v;
+    bool copy;
+  };
+  std::vector<SPlacement> placement;
+  std::map<const unsigned char*, std::pair<ASS_Image*, size_t> > packed;
 
   int curr_x = 0;
   int curr_y = 0;
-
-  // calculate the y size of the texture
+  int y = 0;
 
   for(img = images; img; img = img->next)
   {
+    // fully transparent or width or height is 0 -> not displayed
     if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
       continue;
 
+    SPlacement place;
+    auto it = packed.find(img->bitmap);
+    if (it != packed.end())
+    {
+      ASS_Image* first = it->second.first;
+      if (first->w == img->w && first->h == img->h && first->stride == img->stride)
+      {
+        place = placement[it->second.second];
+        place.copy = false;
+        placement.push_back(place);
+        quads.count++;
+        continue;
+      }
+    }
+
     // check if we need to split to new line
-    if (curr_x + img->w >= quads.size_x)
+    if (curr_x > 0 && curr_x + img->w >= max_x)
     {
-      quads.size_y += curr_y + 1;
-      curr_x = 0;
-      curr_y = 0;
+      curr_y += y + 1;
+      curr_x  = 0;
+      y       = 0;
     }
 
-    curr_x += img->w + 1;
+    place.u = curr_x;
+    place.v = curr_y;
+    place.copy = true;
+    packed[img->bitmap] = std::make_pair(img, placement.size());
+    placement.push_back(place);
+    quads.count++;
 
-    if (img->h > curr_y)
-      curr_y = img->h;
+    curr_x += img->w + 1;
+    if (curr_x > quads.size_x)
+      quads.size_x = curr_x;
+    if (img->h > y)
+      y = img->h;
   }
 
-  quads.size_y += curr_y + 1;
+  if (quads.count == 0)
+    return false;
+
+  quads.size_y = curr_y + y + 1;
 
   // allocate space for the glyph positions and texturedata
 
   quads.quad = (SQuad*)  calloc(quads.count, sizeof(SQuad));
   quads.data = (uint8_t*)calloc(quads.size_x * quads.size_y, 1);
 
-  SQuad*   v    = quads.quad;
-  uint8_t* data = quads.data;
-
-  int y = 0;
-
-  curr_x = 0;
-  curr_y = 0;
+  SQuad* v = quads.quad;
+  std::vector<SPlacement>::const_iterator place = placement.begin();
 
   for(img = images; img; img = img->next)
   {
@@ -254,14 +272,6 @@ bool convert_quad(ASS_Image* images, SQuads& quads, int max_x)
     unsigned int color = img->color;
     unsigned int alpha = (color & 0xff);
 
-    if (curr_x + img->w >= quads.size_x)
-    {
-      curr_y += y + 1;
-      curr_x  = 0;
-      y       = 0;
-      data    = quads.data + curr_y * quads.size_x;
-    }
-
     unsigned int r = ((color >> 24) & 0xff);
     unsigned int g = ((color >> 16) & 0xff);
     unsigned int b = ((color >> 8 ) & 0xff);
@@ -271,8 +281,8 @@ bool convert_quad(ASS_Image* images, SQuads& quads, int max_x)
     v->g = g;
     v->b = b;
 
-    v->u = curr_x;
-    v->v = curr_y;
+    v->u = place->u;
+    v->v = place->v;
 
     v->x = img->dst_x;
     v->y = img->dst_y;
@@ -280,20 +290,60 @@ bool convert_quad(ASS_Image* images, SQuads& quads, int max_x)
     v->w = img->w;
     v->h = img->h;
 
+    if (place->copy)
+    {
+      uint8_t* data = quads.data + place->v * quads.size_x + place->u;
+      for(int i=0; i<img->h; i++)
+        memcpy(data        + quads.size_x * i
+             , img->bitmap + img->stride  * i
+             , img->w);
+    }
+
     v++;
+    ++place;
+  }
+  return true;
+}
 
-    for(int i=0; i<img->h; i++)
-      memcpy(data        + quads.size_x * i
-           , img->bitmap + img->stride  * i
-           , img->w);
+// 64 bit FNV-1a
+static void hash_add(uint64_t& hash, const uint8_t* data, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+}
 
-    if (img->h > y)
-      y = img->h;
+uint64_t hash_images(ASS_Image* images)
+{
+  // the layout of the image list, the bitmaps are left to hash_bitmaps
+  uint64_t hash = 14695981039346656037ULL;
+  for(ASS_Image* img = images; img; img = img->next)
+  {
+    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
 
-    curr_x += img->w + 1;
-    data   += img->w + 1;
+    int header[] = { img->w, img->h, img->dst_x, img->dst_y, (int)img->color };
+    hash_add(hash, (const uint8_t*)header, sizeof(header));
   }
-  return true;
+  return hash;
+}
+
+uint64_t hash_bitmaps(ASS_Image* images)
+{
+  // the pixels have to be read, libass frees glyphs from its cache and hands
+  // the memory out again, the same pointer doesn't mean the same glyph
+  uint64_t hash = 14695981039346656037ULL;
+  for(ASS_Image* img = images; img; img = img->next)
+  {
+    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+
+    for(int i=0; i<img->h; i++)
+      hash_add(hash, img->bitmap + img->stride * i, img->w);
+  }
+  return hash;
 }
 
 int GetStereoscopicDepth()
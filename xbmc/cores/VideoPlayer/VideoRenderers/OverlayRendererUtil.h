@@ -64,6 +64,8 @@ namespace OVERLAY {
                        , int& min_x, int& max_x
                        , int& min_y, int& max_y);
   bool      convert_quad(ASS_Image* images, SQuads& quads, int max_x);
+  uint64_t  hash_images(ASS_Image* images);
+  uint64_t  hash_bitmaps(ASS_Image* images);
   int       GetStereoscopicDepth();
 
 }
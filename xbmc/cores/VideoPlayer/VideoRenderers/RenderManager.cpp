@@ -26,6 +26,8 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
 #include "windowing/WindowingFactory.h"
 
 #include "Application.h"
@@ -124,6 +126,25 @@ void CRenderManager::CClockSync::Reset()
   m_enabled = false;
 }
 
+void CRenderManager::CWaitStats::Reset()
+{
+  m_total = 0;
+  m_max = 0;
+  m_waits = 0;
+  m_frames = 0;
+}
+
+void CRenderManager::CWaitStats::AddWait(int64_t start)
+{
+  if (!start)
+    return;
+
+  int64_t elapsed = CurrentHostCounter() - start;
+  m_total += elapsed;
+  m_max = std::max(m_max, elapsed);
+  m_waits++;
+}
+
 unsigned int CRenderManager::m_nextCaptureId = 0;
 
 CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) :
@@ -158,6 +179,10 @@ CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) :
   m_captureWaitCounter(0),
   m_hasCaptures(false)
 {
+  m_waitStats.Reset();
+  m_pacingPending = false;
+  m_pacingFlipped = false;
+  m_pacingClock = DVD_NOPTS_VALUE;
 }
 
 CRenderManager::~CRenderManager()
@@ -283,13 +308,13 @@ bool CRenderManager::Configure()
   if (result)
   {
     CRenderInfo info = m_pRenderer->GetRenderInfo();
-    int renderbuffers = info.optimal_buffer_size;
+    int renderbuffers = GetQueueDepth(info);
     m_QueueSize = renderbuffers;
     if (m_NumberBuffers > 0)
       m_QueueSize = std::min(m_NumberBuffers, renderbuffers);
 
     m_QueueSize = std::min(m_QueueSize, (int)info.max_buffer_size);
-    m_QueueSize = std::min(m_QueueSize, NUM_BUFFERS);
+    m_QueueSize = std::min(m_QueueSize, MAX_RENDER_BUFFERS);
     if(m_QueueSize < 2)
     {
       m_QueueSize = 2;
@@ -319,6 +344,10 @@ bool CRenderManager::Configure()
     m_renderDebug = false;
     m_clockSync.Reset();
     m_dvdClock.SetVsyncAdjust(0);
+    m_waitStats.Reset();
+    m_framePacing.Reset();
+    m_pacingPending = false;
+    m_pacingClock = DVD_NOPTS_VALUE;
 
     m_renderState = STATE_CONFIGURED;
 
@@ -332,6 +361,51 @@ bool CRenderManager::Configure()
   return result;
 }
 
+int CRenderManager::GetQueueDepth(const CRenderInfo &info)
+{
+  int depth = info.optimal_buffer_size;
+
+  if (g_advancedSettings.m_videoRenderQueueDepth > 0)
+    depth = g_advancedSettings.m_videoRenderQueueDepth;
+  else if (m_fps > 30.0f)
+  {
+    // at high frame rates the renderer holds each frame for a larger share of the
+    // decode time, give the decoder some slack so it does not block in WaitForBuffer
+    depth += 2;
+  }
+
+  // frames beyond the renderer's preference must fit into the memory budget
+  if (depth > (int)info.optimal_buffer_size)
+  {
+    uint64_t frameSize = (uint64_t)m_width * m_height;
+    switch (m_format)
+    {
+    case RENDER_FMT_YUV420P10:
+    case RENDER_FMT_YUV420P16:
+      frameSize *= 3;
+      break;
+    case RENDER_FMT_YUYV422:
+    case RENDER_FMT_UYVY422:
+      frameSize *= 2;
+      break;
+    default:
+      frameSize = frameSize * 3 / 2;
+      break;
+    }
+
+    if (frameSize > 0)
+    {
+      uint64_t budget = (uint64_t)g_advancedSettings.m_videoRenderQueueMemory * 1024 * 1024;
+      int frames = (int)std::min(budget / frameSize, (uint64_t)MAX_RENDER_BUFFERS);
+      depth = std::max((int)info.optimal_buffer_size, std::min(depth, frames));
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "CRenderManager::%s - %d buffers, renderer optimal: %d max: %d, %dx%d@%.2f",
+            __FUNCTION__, depth, info.optimal_buffer_size, info.max_buffer_size, m_width, m_height, m_fps);
+  return depth;
+}
+
 bool CRenderManager::IsConfigured() const
 {
   CSingleLock lock(m_statelock);
@@ -389,13 +463,30 @@ void CRenderManager::FrameMove()
   {
     CSingleLock lock2(m_presentlock);
 
+    // a frame that never made it to FrameFinish, e.g. while the gui doesn't render
+    if (m_pacingPending)
+      AddPacingSample();
+
+    // time of the vsync this tick aims at, the reference clock follows the display
+    CFramePacing::SSample sample = {};
+    sample.vsync = m_dvdClock.GetVblankTime();
+    if (!sample.vsync)
+      sample.vsync = CurrentHostCounter();
+    sample.clock = m_dvdClock.GetClock();
+    sample.decision = CFramePacing::REPEAT;
+
     if (m_queued.empty())
     {
       m_presentstep = PRESENT_IDLE;
+
+      // the frame on screen has run out and there is nothing to replace it
+      if (m_presentpts != DVD_NOPTS_VALUE && m_fps > 0.0f &&
+          sample.clock > m_presentpts + DVD_TIME_BASE / m_fps)
+        sample.decision = CFramePacing::UNDERRUN;
     }
 
     if (m_presentstep == PRESENT_READY)
-      PrepareNextRender();
+      PrepareNextRender(sample);
 
     if (m_presentstep == PRESENT_FLIP)
     {
@@ -403,13 +494,27 @@ void CRenderManager::FrameMove()
       m_presentstep = PRESENT_FRAME;
       m_presentevent.notifyAll();
       m_presentTimer.Set(1000);
+      m_pacingFlipped = true;
+    }
+    else
+      m_pacingFlipped = false;
+
+    // a stopped clock repeats frames by intent, only account ticks while playing
+    if (sample.clock != m_pacingClock)
+    {
+      sample.pts = m_Queue[m_presentsource].pts;
+      m_pacingSample = sample;
+      m_pacingPending = true;
+      m_pacingClock = sample.clock;
     }
 
     // release all previous
     for (std::deque<int>::iterator it = m_discard.begin(); it != m_discard.end(); )
     {
       // renderer may want to keep the frame for postprocessing
-      if (!m_pRenderer->NeedBuffer(*it) || !m_bRenderGUI)
+      if (m_pRenderer->IsBufferBusy(*it))
+        ++it;
+      else if (!m_pRenderer->NeedBuffer(*it) || !m_bRenderGUI)
       {
         m_pRenderer->ReleaseBuffer(*it);
         m_overlays.Release(*it);
@@ -491,6 +596,9 @@ bool CRenderManager::Flush()
       m_pRenderer->Flush();
       m_overlays.Flush();
       m_debugRenderer.Flush();
+      m_framePacing.Reset();
+      m_pacingPending = false;
+      m_pacingClock = DVD_NOPTS_VALUE;
 
       m_queued.clear();
       m_discard.clear();
@@ -928,7 +1036,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
     if (m_renderDebug)
     {
-      std::string acodec, audio, vcodec, video, player, vsync;
+      std::string acodec, audio, vcodec, video, player, vsync, pacing;
 
       m_playerPort->GetDebugInfo(acodec, audio, vcodec, video, player);
 
@@ -943,7 +1051,24 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                      clockspeed * 100);
       }
 
-      m_debugRenderer.SetInfo(acodec, audio, vcodec, video, player, vsync);
+      std::string renderer;
+      m_pRenderer->GetDebugInfo(renderer);
+      if (!renderer.empty())
+        vsync += "  " + renderer;
+
+      {
+        CSingleLock lock(m_presentlock);
+        double frequency = CurrentHostFrequency() / 1000.0;
+        vsync += StringUtils::Format("  Queue: %d wait:%d/%d avg:%.2fms max:%.2fms",
+                                     m_QueueSize, m_waitStats.m_waits, m_waitStats.m_frames,
+                                     m_waitStats.m_waits ? m_waitStats.m_total / frequency / m_waitStats.m_waits : 0.0,
+                                     m_waitStats.m_max / frequency);
+        m_waitStats.Reset();
+      }
+
+      pacing = m_framePacing.GetSummary();
+
+      m_debugRenderer.SetInfo(acodec, audio, vcodec, video, player, vsync, pacing);
       m_debugRenderer.Render(src, dst, view);
 
       m_debugTimer.Set(1000);
@@ -977,6 +1102,24 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
   }
 }
 
+void CRenderManager::FrameFinish()
+{
+  CSingleLock lock(m_presentlock);
+
+  if (m_pacingPending)
+    AddPacingSample();
+}
+
+void CRenderManager::AddPacingSample()
+{
+  // the buffers have been swapped, the flipped frame is on screen from here
+  if (m_pacingFlipped)
+    m_pacingSample.flip = CurrentHostCounter();
+  m_framePacing.Add(m_pacingSample);
+  m_pacingPending = false;
+  m_pacingFlipped = false;
+}
+
 bool CRenderManager::IsGuiLayer()
 {
   { CSingleLock lock(m_statelock);
@@ -1232,11 +1375,13 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
   }
 
   XbmcThreads::EndTime endtime(timeout);
+  int64_t waitStart = m_free.empty() ? CurrentHostCounter() : 0;
   while(m_free.empty())
   {
     m_presentevent.wait(lock, std::min(50, timeout));
     if(endtime.IsTimePast() || bStop)
     {
+      m_waitStats.AddWait(waitStart);
       if (timeout != 0 && !bStop)
       {
         CLog::Log(LOGWARNING, "CRenderManager::WaitForBuffer - timeout waiting for buffer");
@@ -1251,6 +1396,8 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
   }
 
   m_waitForBufferCount = 0;
+  m_waitStats.AddWait(waitStart);
+  m_waitStats.m_frames++;
 
   // make sure overlay buffer is released, this won't happen on AddOverlay
   m_overlays.Release(m_free.front());
@@ -1259,7 +1406,7 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
   return m_queued.size() + m_discard.size();
 }
 
-void CRenderManager::PrepareNextRender()
+void CRenderManager::PrepareNextRender(CFramePacing::SSample &sample)
 {
   if (m_queued.empty())
   {
@@ -1277,6 +1424,7 @@ void CRenderManager::PrepareNextRender()
   double totalLatency = DVD_SEC_TO_TIME(m_displayLatency) - DVD_MSEC_TO_TIME(m_videoDelay) + 2* frametime;
 
   double renderPts = frameOnScreen + totalLatency;
+  sample.target = renderPts;
 
   double nextFramePts = m_Queue[m_queued.front()].pts;
   if (m_dvdClock.GetClockSpeed() < 0)
@@ -1327,6 +1475,7 @@ void CRenderManager::PrepareNextRender()
     {
       requeue(m_discard, m_queued);
       m_QueueSkip++;
+      sample.skipped++;
     }
 
     int lateframes = (renderPts - m_Queue[idx].pts) * m_fps / DVD_TIME_BASE;
@@ -1336,6 +1485,7 @@ void CRenderManager::PrepareNextRender()
       m_lateframes = 0;
 
     m_presentstep = PRESENT_FLIP;
+    sample.decision = CFramePacing::FLIP;
     m_discard.push_back(m_presentsource);
     m_presentsource = idx;
     m_queued.pop_front();
@@ -1346,6 +1496,18 @@ void CRenderManager::PrepareNextRender()
   }
 }
 
+bool CRenderManager::GetFramePacing(CVariant &pacing)
+{
+  CSingleLock lock(m_statelock);
+  if (m_renderState != STATE_CONFIGURED)
+    return false;
+
+  m_framePacing.Serialize(pacing);
+  pacing["fps"] = m_fps;
+  pacing["refreshrate"] = g_graphicsContext.GetFPS();
+  return true;
+}
+
 void CRenderManager::DiscardBuffer()
 {
   CSingleLock lock2(m_presentlock);
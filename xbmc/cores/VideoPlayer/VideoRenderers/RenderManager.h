@@ -30,6 +30,7 @@
 #include "settings/VideoSettings.h"
 #include "OverlayRenderer.h"
 #include "DebugRenderer.h"
+#include "FramePacing.h"
 #include <deque>
 #include <map>
 #include <atomic>
@@ -38,6 +39,7 @@
 #include "DVDClock.h"
 
 class CRenderCapture;
+class CVariant;
 
 namespace DXVA { class CProcessor; }
 namespace VAAPI { class CSurfaceHolder; }
@@ -74,6 +76,7 @@ public:
   void FrameMove();
   void FrameWait(int ms);
   void Render(bool clear, DWORD flags = 0, DWORD alpha = 255, bool gui = true);
+  void FrameFinish();
   bool IsGuiLayer();
   bool IsVideoLayer();
   RESOLUTION GetResolution();
@@ -153,6 +156,12 @@ public:
    */
   void DiscardBuffer();
 
+  /**
+   * Dumps the recent per vsync presentation decisions and the judder histogram,
+   * see CFramePacing
+   */
+  bool GetFramePacing(CVariant &pacing);
+
   void SetDelay(int delay) { m_videoDelay = delay; };
   int GetDelay() { return m_videoDelay; };
 
@@ -162,10 +171,12 @@ protected:
   void PresentFields(bool clear, DWORD flags, DWORD alpha);
   void PresentBlend(bool clear, DWORD flags, DWORD alpha);
 
-  void PrepareNextRender();
+  void PrepareNextRender(CFramePacing::SSample &sample);
+  void AddPacingSample();
   bool IsPresenting();
 
   bool Configure();
+  int GetQueueDepth(const CRenderInfo &info);
   void CreateRenderer();
   void DeleteRenderer();
   void ManageCaptures();
@@ -225,7 +236,7 @@ protected:
     double         pts;
     EFIELDSYNC     presentfield;
     EPRESENTMETHOD presentmethod;
-  } m_Queue[NUM_BUFFERS];
+  } m_Queue[MAX_RENDER_BUFFERS];
 
   std::deque<int> m_free;
   std::deque<int> m_queued;
@@ -260,6 +271,24 @@ protected:
   };
   CClockSync m_clockSync;
 
+  // time the decoder spent in WaitForBuffer, reported on the debug overlay
+  struct CWaitStats
+  {
+    void Reset();
+    void AddWait(int64_t start);
+    int64_t m_total;
+    int64_t m_max;
+    int m_waits;
+    int m_frames;
+  };
+  CWaitStats m_waitStats;
+
+  CFramePacing m_framePacing;
+  CFramePacing::SSample m_pacingSample; ///< tick of the last FrameMove, added once the frame is on screen
+  bool m_pacingPending;
+  bool m_pacingFlipped;
+  double m_pacingClock;
+
   void RenderCapture(CRenderCapture* capture);
   void RemoveCaptures();
   CCriticalSection m_captCritSect;
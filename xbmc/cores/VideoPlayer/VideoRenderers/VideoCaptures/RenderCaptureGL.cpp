@@ -23,6 +23,7 @@
 #include "windowing/WindowingFactory.h"
 #include "settings/AdvancedSettings.h"
 #include "cores/IPlayer.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDCodecUtils.h"
 extern "C" {
 #include "libavutil/mem.h"
 }
@@ -179,7 +180,8 @@ void CRenderCaptureGL::PboToBuffer()
 
   if (pboPtr)
   {
-    memcpy(m_pixels, pboPtr, m_bufferSize);
+    // the mapped pbo is usually write combined memory, copy with streaming loads
+    CDVDCodecUtils::CopyPlane(m_pixels, m_bufferSize, (const uint8_t*)pboPtr, m_bufferSize, m_bufferSize, 1, true);
     SetState(CAPTURESTATE_DONE);
   }
   else
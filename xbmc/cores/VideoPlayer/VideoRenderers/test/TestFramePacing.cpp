@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/VideoPlayer/VideoRenderers/FramePacing.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+void AddFrame(CFramePacing &pacing, int vsyncs, int skipped = 0)
+{
+  static int64_t counter = 0;
+  CFramePacing::SSample sample = {};
+  for (int i = 0; i < vsyncs; i++)
+  {
+    sample.vsync = ++counter;
+    sample.decision = i ? CFramePacing::REPEAT : CFramePacing::FLIP;
+    sample.flip = i ? 0 : counter;
+    sample.skipped = i ? 0 : skipped;
+    pacing.Add(sample);
+  }
+}
+
+}
+
+TEST(TestFramePacing, Histogram)
+{
+  // 24p on 60Hz, 3:2 cadence
+  CFramePacing pacing;
+  for (int i = 0; i < 10; i++)
+  {
+    AddFrame(pacing, 3);
+    AddFrame(pacing, 2);
+  }
+  // the last frame is still on screen and not accounted yet
+  AddFrame(pacing, 1);
+
+  unsigned int bins[FRAMEPACING_HISTOGRAM];
+  pacing.GetHistogram(bins);
+  EXPECT_EQ(0U, bins[0]);
+  EXPECT_EQ(10U, bins[1]);
+  EXPECT_EQ(10U, bins[2]);
+  for (int i = 3; i < FRAMEPACING_HISTOGRAM; i++)
+    EXPECT_EQ(0U, bins[i]);
+}
+
+TEST(TestFramePacing, LongFramesAndUnderrun)
+{
+  CFramePacing pacing;
+  AddFrame(pacing, FRAMEPACING_HISTOGRAM + 4, 2);
+
+  CFramePacing::SSample sample = {};
+  sample.decision = CFramePacing::UNDERRUN;
+  pacing.Add(sample);
+  AddFrame(pacing, 1);
+
+  unsigned int bins[FRAMEPACING_HISTOGRAM];
+  pacing.GetHistogram(bins);
+  EXPECT_EQ(1U, bins[FRAMEPACING_HISTOGRAM - 1]);
+
+  CVariant value;
+  pacing.Serialize(value);
+  EXPECT_EQ(2U, value["flips"].asUnsignedInteger());
+  EXPECT_EQ(FRAMEPACING_HISTOGRAM + 3U, value["repeats"].asUnsignedInteger());
+  EXPECT_EQ(1U, value["underruns"].asUnsignedInteger());
+  EXPECT_EQ(2U, value["skipped"].asUnsignedInteger());
+  EXPECT_EQ(FRAMEPACING_HISTOGRAM + 6U, value["samples"].size());
+  EXPECT_EQ("underrun", value["samples"][FRAMEPACING_HISTOGRAM + 4]["decision"].asString());
+}
+
+TEST(TestFramePacing, Ring)
+{
+  CFramePacing pacing;
+  AddFrame(pacing, FRAMEPACING_SAMPLES + 10);
+
+  std::vector<CFramePacing::SSample> samples = pacing.GetSamples();
+  ASSERT_EQ((size_t)FRAMEPACING_SAMPLES, samples.size());
+  for (size_t i = 1; i < samples.size(); i++)
+    EXPECT_EQ(samples[i - 1].vsync + 1, samples[i].vsync);
+
+  pacing.Reset();
+  EXPECT_TRUE(pacing.GetSamples().empty());
+}
@@ -0,0 +1,177 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/OverlayRendererUtil.h"
+
+extern "C" {
+#include <ass/ass.h>
+}
+
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace OVERLAY;
+
+namespace
+{
+
+ASS_Image MakeImage(int w, int h, unsigned char *bitmap, int x, int y, uint32_t color, ASS_Image *next = NULL)
+{
+  ASS_Image img;
+  memset(&img, 0, sizeof(img));
+  img.w = w;
+  img.h = h;
+  img.stride = w;
+  img.bitmap = bitmap;
+  img.dst_x = x;
+  img.dst_y = y;
+  img.color = color;
+  img.next = next;
+  return img;
+}
+
+}
+
+TEST(TestOverlayRendererUtil, ConvertQuad)
+{
+  std::vector<unsigned char> glyph(4 * 2, 0x80);
+  std::vector<unsigned char> other(3 * 3, 0x40);
+
+  ASS_Image third = MakeImage(3, 3, other.data(), 30, 40, 0x11223300);
+  ASS_Image second = MakeImage(4, 2, glyph.data(), 20, 10, 0x445566ff, &third);  // transparent
+  ASS_Image first = MakeImage(4, 2, glyph.data(), 0, 10, 0xaabbcc40, &second);
+
+  SQuads quads;
+  ASSERT_TRUE(convert_quad(&first, quads, 1024));
+  ASSERT_EQ(2, quads.count);
+  EXPECT_EQ(4 + 1 + 3 + 1, quads.size_x);
+  EXPECT_EQ(3 + 1, quads.size_y);
+
+  EXPECT_EQ(0xaa, quads.quad[0].r);
+  EXPECT_EQ(0xbb, quads.quad[0].g);
+  EXPECT_EQ(0xcc, quads.quad[0].b);
+  EXPECT_EQ(0xff - 0x40, quads.quad[0].a);
+  EXPECT_EQ(0, quads.quad[0].x);
+  EXPECT_EQ(10, quads.quad[0].y);
+  EXPECT_EQ(5, quads.quad[1].u);
+  EXPECT_EQ(30, quads.quad[1].x);
+
+  EXPECT_EQ(0x80, quads.data[0]);
+  EXPECT_EQ(0x80, quads.data[quads.size_x + 3]);
+  EXPECT_EQ(0x40, quads.data[5]);
+  EXPECT_EQ(0x40, quads.data[2 * quads.size_x + 7]);
+}
+
+TEST(TestOverlayRendererUtil, ConvertQuadSharedBitmap)
+{
+  // karaoke passes and repeated glyphs come with the same cached bitmap, it's packed once
+  std::vector<unsigned char> glyph(4 * 2, 0x80);
+  ASS_Image second = MakeImage(4, 2, glyph.data(), 40, 10, 0x00000000);
+  ASS_Image first = MakeImage(4, 2, glyph.data(), 0, 10, 0xffffff00, &second);
+
+  SQuads quads;
+  ASSERT_TRUE(convert_quad(&first, quads, 1024));
+  ASSERT_EQ(2, quads.count);
+  EXPECT_EQ(4 + 1, quads.size_x);
+  EXPECT_EQ(quads.quad[0].u, quads.quad[1].u);
+  EXPECT_EQ(quads.quad[0].v, quads.quad[1].v);
+  EXPECT_EQ(40, quads.quad[1].x);
+}
+
+TEST(TestOverlayRendererUtil, ConvertQuadWraps)
+{
+  std::vector<unsigned char> a(6 * 2, 1), b(6 * 3, 2);
+  ASS_Image second = MakeImage(6, 3, b.data(), 0, 0, 0);
+  ASS_Image first = MakeImage(6, 2, a.data(), 0, 0, 0, &second);
+
+  SQuads quads;
+  ASSERT_TRUE(convert_quad(&first, quads, 10));
+  EXPECT_EQ(0, quads.quad[1].u);
+  EXPECT_EQ(2 + 1, quads.quad[1].v);
+  EXPECT_EQ(2 + 1 + 3 + 1, quads.size_y);
+}
+
+TEST(TestOverlayRendererUtil, ConvertQuadNothingVisible)
+{
+  std::vector<unsigned char> glyph(4 * 2, 0x80);
+  ASS_Image second = MakeImage(0, 2, glyph.data(), 0, 0, 0);
+  ASS_Image first = MakeImage(4, 2, glyph.data(), 0, 0, 0x000000ff, &second);
+
+  SQuads quads;
+  EXPECT_FALSE(convert_quad(NULL, quads, 1024));
+  EXPECT_FALSE(convert_quad(&first, quads, 1024));
+}
+
+TEST(TestOverlayRendererUtil, HashImages)
+{
+  std::vector<unsigned char> glyph(4 * 2, 0x80);
+  std::vector<unsigned char> other(4 * 2, 0x80);
+  ASS_Image second = MakeImage(4, 2, glyph.data(), 20, 10, 0x11223300);
+  ASS_Image first = MakeImage(4, 2, glyph.data(), 0, 10, 0x11223300, &second);
+  uint64_t hash = hash_images(&first);
+
+  EXPECT_EQ(hash, hash_images(&first));
+  EXPECT_NE(hash, hash_images(&second));
+
+  // invisible images don't change what is drawn
+  ASS_Image hidden = MakeImage(4, 2, other.data(), 0, 0, 0x000000ff);
+  second.next = &hidden;
+  EXPECT_EQ(hash, hash_images(&first));
+  second.next = NULL;
+
+  second.dst_x++;
+  EXPECT_NE(hash, hash_images(&first));
+  second.dst_x--;
+
+  second.color = 0x11223400;
+  EXPECT_NE(hash, hash_images(&first));
+  second.color = 0x11223300;
+
+  // the pixels are left to hash_bitmaps
+  second.bitmap = other.data();
+  EXPECT_EQ(hash, hash_images(&first));
+}
+
+TEST(TestOverlayRendererUtil, HashBitmaps)
+{
+  std::vector<unsigned char> glyph(4 * 2, 0x80);
+  std::vector<unsigned char> copy(4 * 2, 0x80);
+  ASS_Image second = MakeImage(4, 2, glyph.data(), 20, 10, 0x11223300);
+  ASS_Image first = MakeImage(4, 2, glyph.data(), 0, 10, 0x11223300, &second);
+  uint64_t hash = hash_bitmaps(&first);
+
+  // the same pixels at another address
+  second.bitmap = copy.data();
+  EXPECT_EQ(hash, hash_bitmaps(&first));
+
+  // libass hands out the memory of a freed glyph again for another one
+  copy[5] = 0x40;
+  EXPECT_NE(hash, hash_bitmaps(&first));
+  copy[5] = 0x80;
+
+  // padding beyond the width isn't drawn
+  std::vector<unsigned char> padded(8 * 2, 0x80);
+  padded[6] = 0;
+  second.bitmap = padded.data();
+  second.stride = 8;
+  EXPECT_EQ(hash, hash_bitmaps(&first));
+}
@@ -0,0 +1,55 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/VideoPlayer/VideoPlayerBenchmark.h"
+#include "test/TestUtils.h"
+
+#include <stdio.h>
+
+#include "gtest/gtest.h"
+
+/* headless throughput of the files given with --add-videoplayer-benchmark-file,
+ * run with --gtest_also_run_disabled_tests */
+static void RunBenchmark(bool render)
+{
+  std::vector<std::string> &files = CXBMCTestUtils::Instance().getVideoPlayerBenchmarkFiles();
+  ASSERT_FALSE(files.empty()) << "no files given with --add-videoplayer-benchmark-file";
+
+  CVideoPlayerBenchmark::SOptions options;
+  options.render = render;
+  for (const std::string &file : files)
+  {
+    CVideoPlayerBenchmark::SResult result;
+    EXPECT_TRUE(CVideoPlayerBenchmark::Run(file, options, result)) << file;
+    EXPECT_EQ(0, result.errors) << file;
+    printf("CVideoPlayerBenchmark %s: %s\n", render ? "decode+render" : "decode", result.ToString().c_str());
+  }
+}
+
+TEST(TestVideoPlayerBenchmark, DISABLED_Decode)
+{
+  RunBenchmark(false);
+}
+
+TEST(TestVideoPlayerBenchmark, DISABLED_DecodeRender)
+{
+  RunBenchmark(true);
+}
@@ -19,9 +19,15 @@
  */
 
 #include "PAPlayer.h"
+
+#include <algorithm>
+
 #include "CodecFactory.h"
 #include "FileItem.h"
+#include "PlayListPlayer.h"
 #include "ServiceBroker.h"
+#include "URL.h"
+#include "playlists/PlayList.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
@@ -53,6 +59,21 @@ public:
   }
 };
 
+class CPrefetchFileJob : public CJob
+{
+  CFileItem m_item;
+  PAPlayer &m_player;
+
+public:
+                CPrefetchFileJob(const CFileItem& item, PAPlayer &player)
+                  : m_item(item), m_player(player) {}
+  virtual       ~CPrefetchFileJob() {}
+  virtual bool  DoWork()
+  {
+    return m_player.PrefetchFileEx(m_item);
+  }
+};
+
 // PAP: Psycho-acoustic Audio Player
 // Supporting all open  audio codec standards.
 // First one being nullsoft's nsv audio decoder format
@@ -73,7 +94,10 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_jobCounter         (0),
   m_continueStream     (false),
   m_newForcedPlayerTime(-1),
-  m_newForcedTotalTime (-1)
+  m_newForcedTotalTime (-1),
+  m_prefetchEvent      (true),
+  m_prefetchAbort      (false),
+  m_prefetchRequested  (false)
 {
   memset(&m_playerGUIData, 0, sizeof(m_playerGUIData));
   m_processInfo.reset(CProcessInfo::CreateInstance());
@@ -344,8 +368,13 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     m_continueStream = false;
   }
 
-  StreamInfo *si = new StreamInfo();
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  StreamInfo *si = TakePrefetchedStream(file);
+  if (si)
+    CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - Using prefetched decoder for %s", CURL::GetRedacted(file.GetPath()).c_str());
+  else
+    si = new StreamInfo();
+
+  if (!si->m_decoder.GetCodec() && !si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -466,6 +495,181 @@ void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int cros
   }
 }
 
+void PAPlayer::PrefetchUpcoming()
+{
+  int tracks = g_advancedSettings.m_audioPrefetchTracks;
+  if (tracks <= 0 || g_playlistPlayer.GetCurrentPlaylist() != PLAYLIST_MUSIC)
+    return;
+
+  std::string currentURL = m_FileItem->GetMusicInfoTag() ? m_FileItem->GetMusicInfoTag()->GetURL() : m_FileItem->GetPath();
+
+  std::vector<CFileItem> upcoming;
+  const PLAYLIST::CPlayList& playlist = g_playlistPlayer.GetPlaylist(PLAYLIST_MUSIC);
+  for (int i = 1; i <= tracks; i++)
+  {
+    int song = g_playlistPlayer.GetNextSong(i);
+    if (song < 0 || song >= playlist.size())
+      break;
+
+    const CFileItemPtr item = playlist[song];
+    // cd drives don't like to be accessed concurrently, tracks of the current
+    // cue sheet are continued without opening a new decoder
+    std::string url = item->GetMusicInfoTag() ? item->GetMusicInfoTag()->GetURL() : item->GetPath();
+    if (item->IsCDDA() || item->IsInternetStream() || url == currentURL)
+      continue;
+
+    upcoming.push_back(*item);
+  }
+
+  CSingleLock lock(m_streamsLock);
+
+  // drop prefetched streams that are not upcoming anymore, i.e. after the user skipped tracks
+  for (PrefetchList::iterator it = m_prefetched.begin(); it != m_prefetched.end();)
+  {
+    bool wanted = std::find_if(upcoming.begin(), upcoming.end(), [&it](const CFileItem &item)
+    {
+      return item.GetPath() == it->m_path && item.m_lStartOffset == it->m_startOffset;
+    }) != upcoming.end();
+
+    if (!wanted && (!it->m_pending || !it->m_started))
+    {
+      /* a job that didn't start yet finds its file gone and returns */
+      if (it->m_stream)
+      {
+        it->m_stream->m_decoder.Destroy();
+        delete it->m_stream;
+      }
+      it = m_prefetched.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  for (std::vector<CFileItem>::const_iterator item = upcoming.begin(); item != upcoming.end(); ++item)
+  {
+    bool known = std::find_if(m_prefetched.begin(), m_prefetched.end(), [&item](const PrefetchInfo &info)
+    {
+      return item->GetPath() == info.m_path && item->m_lStartOffset == info.m_startOffset;
+    }) != m_prefetched.end();
+
+    if (known)
+      continue;
+
+    PrefetchInfo info;
+    info.m_path = item->GetPath();
+    info.m_startOffset = item->m_lStartOffset;
+    info.m_stream = NULL;
+    info.m_pending = true;
+    info.m_started = false;
+    m_prefetched.push_back(info);
+
+    m_jobCounter++;
+    CJobManager::GetInstance().AddJob(new CPrefetchFileJob(*item, *this), this, CJob::PRIORITY_LOW);
+  }
+}
+
+bool PAPlayer::PrefetchFileEx(const CFileItem &file)
+{
+  {
+    /* the file may have been taken or dropped while the job was queued */
+    CSingleLock lock(m_streamsLock);
+    PrefetchList::iterator it = std::find_if(m_prefetched.begin(), m_prefetched.end(), [&file](const PrefetchInfo &info)
+    {
+      return file.GetPath() == info.m_path && file.m_lStartOffset == info.m_startOffset;
+    });
+    if (it == m_prefetched.end() || m_prefetchAbort)
+      return false;
+    it->m_started = true;
+  }
+
+  CLog::Log(LOGDEBUG, "PAPlayer::PrefetchFileEx - Prefetching %s", CURL::GetRedacted(file.GetPath()).c_str());
+
+  /* open the codec and fill the decoder's buffer without starting it */
+  StreamInfo *si = new StreamInfo();
+  bool success = si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75);
+  while (success && !m_prefetchAbort && si->m_decoder.GetStatus() == STATUS_QUEUING)
+  {
+    int ret = si->m_decoder.ReadSamples(PACKET_SIZE);
+    if (ret == RET_ERROR)
+      success = false;
+    else if (ret == RET_SLEEP)
+      break;
+  }
+
+  CSingleLock lock(m_streamsLock);
+  PrefetchList::iterator it = std::find_if(m_prefetched.begin(), m_prefetched.end(), [&file](const PrefetchInfo &info)
+  {
+    return file.GetPath() == info.m_path && file.m_lStartOffset == info.m_startOffset;
+  });
+
+  if (!success || m_prefetchAbort || it == m_prefetched.end())
+  {
+    si->m_decoder.Destroy();
+    delete si;
+    /* a failed prefetch is retried by QueueNextFileEx which reports the error */
+    if (it != m_prefetched.end())
+      m_prefetched.erase(it);
+    success = false;
+  }
+  else
+  {
+    it->m_stream = si;
+    it->m_pending = false;
+  }
+
+  m_prefetchEvent.Set();
+  return success;
+}
+
+PAPlayer::StreamInfo* PAPlayer::TakePrefetchedStream(const CFileItem &file)
+{
+  CSingleLock lock(m_streamsLock);
+  while (true)
+  {
+    PrefetchList::iterator it = std::find_if(m_prefetched.begin(), m_prefetched.end(), [&file](const PrefetchInfo &info)
+    {
+      return file.GetPath() == info.m_path && file.m_lStartOffset == info.m_startOffset;
+    });
+
+    if (it == m_prefetched.end())
+      return NULL;
+
+    if (!it->m_pending)
+    {
+      StreamInfo *si = it->m_stream;
+      m_prefetched.erase(it);
+      return si;
+    }
+
+    if (!it->m_started)
+    {
+      /* still queued, opening the file here is quicker than waiting for a worker */
+      m_prefetched.erase(it);
+      return NULL;
+    }
+
+    /* the job already started opening the file, waiting for it is cheaper than starting over.
+       it sets the event while holding the lock, so it can't be missed after the reset */
+    m_prefetchEvent.Reset();
+    CSingleExit exit(m_streamsLock);
+    m_prefetchEvent.Wait();
+  }
+}
+
+void PAPlayer::ClearPrefetched()
+{
+  CSingleLock lock(m_streamsLock);
+  for (PrefetchList::iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+  {
+    if (it->m_stream)
+    {
+      it->m_stream->m_decoder.Destroy();
+      delete it->m_stream;
+    }
+  }
+  m_prefetched.clear();
+}
+
 inline bool PAPlayer::PrepareStream(StreamInfo *si)
 {
   /* if we have a stream we are already prepared */
@@ -540,6 +744,7 @@ bool PAPlayer::CloseFile(bool reopen)
   StopThread(true);//true - wait for end of thread
 
   // wait for any pending jobs to complete
+  m_prefetchAbort = true;
   {
     CSingleLock lock(m_streamsLock);
     while (m_jobCounter > 0)
@@ -549,6 +754,8 @@ bool PAPlayer::CloseFile(bool reopen)
       lock.Enter();
     }
   }
+  ClearPrefetched();
+  m_prefetchAbort = false;
 
   return true;
 }
@@ -571,6 +778,12 @@ void PAPlayer::Process()
       m_signalSpeedChange = false;
     }
 
+    if (m_prefetchRequested)
+    {
+      m_prefetchRequested = false;
+      PrefetchUpcoming();
+    }
+
     double freeBufferTime = 0.0;
     ProcessStreams(freeBufferTime);
 
@@ -735,6 +948,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       si->m_stream->Resume();
     si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
     m_callback.OnPlayBackStarted();
+    m_prefetchRequested = true;
   }
 
   /* if we have not started yet and the stream has been primed */
@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <list>
+#include <string>
 #include <vector>
 
 #include "cores/IPlayer.h"
@@ -40,6 +41,8 @@ class CProcessInfo;
 class PAPlayer : public IPlayer, public CThread, public IJobCallback
 {
 friend class CQueueNextFileJob;
+friend class CPrefetchFileJob;
+friend class TestPAPlayer;
 public:
   PAPlayer(IPlayerCallback& callback);
   virtual ~PAPlayer();
@@ -126,6 +129,17 @@ private:
 
   typedef std::list<StreamInfo*> StreamList;
 
+  typedef struct
+  {
+    std::string m_path;                  /* path of the prefetched file */
+    int64_t m_startOffset;               /* start offset of the prefetched file */
+    StreamInfo* m_stream;                /* opened and primed stream, NULL while pending */
+    bool m_pending;                      /* if the prefetch job is still queued or running */
+    bool m_started;                      /* if the prefetch job started opening the file */
+  } PrefetchInfo;
+
+  typedef std::list<PrefetchInfo> PrefetchList;
+
   bool                m_signalSpeedChange;   /* true if OnPlaybackSpeedChange needs to be called */
   std::atomic_int m_playbackSpeed;           /* the playback speed (1 = normal) */
   bool                m_isPlaying;
@@ -148,8 +162,16 @@ private:
   int64_t             m_newForcedPlayerTime;
   int64_t             m_newForcedTotalTime;
   std::unique_ptr<CProcessInfo> m_processInfo;
+  PrefetchList        m_prefetched;          /* decoders opened ahead of time for upcoming tracks */
+  CEvent              m_prefetchEvent;       /* set when a prefetch job finishes, reset by its waiters */
+  std::atomic_bool    m_prefetchAbort;       /* tells running prefetch jobs to give up */
+  bool                m_prefetchRequested;   /* true if PrefetchUpcoming needs to be called */
 
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true, bool job = false);
+  void PrefetchUpcoming();
+  bool PrefetchFileEx(const CFileItem &file);
+  StreamInfo* TakePrefetchedStream(const CFileItem &file);
+  void ClearPrefetched();
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
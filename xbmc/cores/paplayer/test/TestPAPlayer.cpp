@@ -0,0 +1,174 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/IPlayerCallback.h"
+#include "cores/paplayer/PAPlayer.h"
+#include "filesystem/File.h"
+#include "FileItem.h"
+#include "threads/SingleLock.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+class CDummyPlayerCallback : public IPlayerCallback
+{
+public:
+  virtual void OnPlayBackEnded() {}
+  virtual void OnPlayBackStarted() {}
+  virtual void OnPlayBackStopped() {}
+  virtual void OnQueueNextItem() {}
+};
+
+void PutLE(std::vector<uint8_t> &data, uint32_t value, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    data.push_back((value >> (8 * i)) & 0xff);
+}
+
+// writes a 16 bit stereo wav of a sine tone
+bool CreateWav(const std::string &path, unsigned int sampleRate, unsigned int seconds)
+{
+  uint32_t frames = sampleRate * seconds;
+  std::vector<uint8_t> data;
+  data.insert(data.end(), { 'R', 'I', 'F', 'F' });
+  PutLE(data, 36 + frames * 4, 4);
+  data.insert(data.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+  PutLE(data, 16, 4);
+  PutLE(data, 1, 2);               // PCM
+  PutLE(data, 2, 2);               // channels
+  PutLE(data, sampleRate, 4);
+  PutLE(data, sampleRate * 4, 4);  // bytes per second
+  PutLE(data, 4, 2);               // block align
+  PutLE(data, 16, 2);              // bits per sample
+  data.insert(data.end(), { 'd', 'a', 't', 'a' });
+  PutLE(data, frames * 4, 4);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    int16_t sample = (int16_t)(8000 * sin(2 * M_PI * 440 * i / sampleRate));
+    PutLE(data, (uint16_t)sample, 2);
+    PutLE(data, (uint16_t)sample, 2);
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  bool success = file.Write(data.data(), data.size()) == (ssize_t)data.size();
+  file.Close();
+  return success;
+}
+
+}
+
+/* Runs the prefetch of upcoming tracks on local files, PrefetchUpcoming would
+ * queue them from the music playlist.
+ */
+class TestPAPlayer : public testing::Test
+{
+protected:
+  TestPAPlayer() :
+    player(callback),
+    track("special://temp/TestPAPlayer.wav", false),
+    missing("special://temp/TestPAPlayerMissing.wav", false)
+  {
+    CreateWav(track.GetPath(), 44100, 5);
+  }
+
+  ~TestPAPlayer()
+  {
+    XFILE::CFile::Delete(track.GetPath());
+  }
+
+  void Queue(const CFileItem &item, bool started = false)
+  {
+    CSingleLock lock(player.m_streamsLock);
+    PAPlayer::PrefetchInfo info;
+    info.m_path = item.GetPath();
+    info.m_startOffset = item.m_lStartOffset;
+    info.m_stream = NULL;
+    info.m_pending = true;
+    info.m_started = started;
+    player.m_prefetched.push_back(info);
+  }
+
+  bool Prefetch(const CFileItem &item)
+  {
+    return player.PrefetchFileEx(item);
+  }
+
+  // returns the status of the prefetched decoder, or -1 if there is none
+  int Take(const CFileItem &item)
+  {
+    PAPlayer::StreamInfo *si = player.TakePrefetchedStream(item);
+    if (!si)
+      return -1;
+
+    int status = si->m_decoder.GetCodec() ? si->m_decoder.GetStatus() : -1;
+    si->m_decoder.Destroy();
+    delete si;
+    return status;
+  }
+
+  CDummyPlayerCallback callback;
+  PAPlayer player;
+  CFileItem track;
+  CFileItem missing;
+};
+
+TEST_F(TestPAPlayer, PrefetchesLocalFile)
+{
+  Queue(track);
+  ASSERT_TRUE(Prefetch(track));
+
+  // opened with the first seconds decoded
+  EXPECT_EQ(STATUS_QUEUED, Take(track));
+  EXPECT_EQ(-1, Take(track));
+}
+
+TEST_F(TestPAPlayer, WaitsForRunningPrefetch)
+{
+  Queue(track, true);
+  std::thread job([this]() { Prefetch(track); });
+
+  // blocks until the job is done instead of opening the file a second time
+  EXPECT_EQ(STATUS_QUEUED, Take(track));
+  job.join();
+}
+
+TEST_F(TestPAPlayer, SkipsQueuedPrefetch)
+{
+  // the player opens the file itself rather than wait for a worker, the job then gives up
+  Queue(track);
+  EXPECT_EQ(-1, Take(track));
+  EXPECT_FALSE(Prefetch(track));
+}
+
+TEST_F(TestPAPlayer, DropsFailedPrefetch)
+{
+  Queue(missing);
+  EXPECT_FALSE(Prefetch(missing));
+  EXPECT_EQ(-1, Take(missing));
+}
@@ -23,6 +23,7 @@
 #include "XBTF.h"
 #include "utils/log.h"
 #include <string.h>
+#include <vector>
 
 #ifndef NO_XBMC_FILESYSTEM
 #include "filesystem/File.h"
@@ -108,13 +109,87 @@ bool CDDSImage::ReadFile(const std::string &inputFile)
     return false;
 
   // and read it in
-  if (file.Read(m_data, m_desc.linearSize) != m_desc.linearSize)
+  uint32_t packedSize = m_desc.reserved[0];
+  if (packedSize)
+  {
+    if (packedSize > CXBTFLZ4::CompressBound(m_desc.linearSize))
+      return false;
+    std::vector<uint8_t> packed(packedSize);
+    if (file.Read(packed.data(), packedSize) != packedSize)
+      return false;
+    if (!CXBTFLZ4::Decompress(packed.data(), packedSize, m_data, m_desc.linearSize))
+      return false;
+    m_desc.reserved[0] = 0;
+  }
+  else if (file.Read(m_data, m_desc.linearSize) != m_desc.linearSize)
+    return false;
+
+  file.Close();
+  return true;
+}
+
+bool CDDSImage::WriteFile(const std::string &outputFile, bool compress /* = false */) const
+{
+  if (!m_data)
+    return false;
+
+  ddsurfacedesc2 desc = m_desc;
+  const unsigned char *data = m_data;
+  std::vector<uint8_t> packed;
+  if (compress)
+  {
+    // only worth it if it saves a good part of the file, LZ4 unpacks at memory speed
+    packed.resize(CXBTFLZ4::CompressBound(m_desc.linearSize));
+    size_t packedSize = CXBTFLZ4::Compress(m_data, m_desc.linearSize, packed.data(), packed.size());
+    if (packedSize && packedSize < m_desc.linearSize - m_desc.linearSize / 8)
+    {
+      desc.reserved[0] = packedSize;
+      data = packed.data();
+    }
+  }
+  uint32_t size = desc.reserved[0] ? desc.reserved[0] : desc.linearSize;
+
+  // open the file
+  CFile file;
+  if (!file.OpenForWrite(outputFile, true))
+    return false;
+
+  // write the header and the data
+  if (file.Write("DDS ", 4) != 4 ||
+      file.Write(&desc, sizeof(desc)) != sizeof(desc) ||
+      file.Write(data, size) != size)
+  {
+    // don't leave a truncated image behind for the loader
+    file.Close();
+    CFile::Delete(outputFile);
     return false;
+  }
 
   file.Close();
   return true;
 }
 
+bool CDDSImage::Create(unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *argb)
+{
+  if (!argb || !width || !height)
+    return false;
+
+  Allocate(width, height, XB_FMT_A8R8G8B8);
+  if (!m_data)
+    return false;
+
+  // store tightly packed so the loader can take the pixels as they are
+  unsigned int linePitch = width * 4;
+  if (pitch == linePitch)
+    memcpy(m_data, argb, linePitch * height);
+  else
+  {
+    for (unsigned int y = 0; y < height; y++)
+      memcpy(m_data + y * linePitch, argb + y * pitch, linePitch);
+  }
+  return true;
+}
+
 unsigned int CDDSImage::GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format)
 {
   switch (format)
@@ -38,6 +38,23 @@ public:
 
   bool ReadFile(const std::string &file);
 
+  /*! \brief Write the image to a file
+   A partially written file is removed again.
+   \param file the file to write
+   \param compress pack the data with LZ4 if that makes it smaller, only ReadFile understands such files
+   \return true if successful, false otherwise
+   */
+  bool WriteFile(const std::string &file, bool compress = false) const;
+
+  /*! \brief Create an uncompressed image from the given pixels
+   \param width width of the image
+   \param height height of the image
+   \param pitch pitch of the pixels
+   \param argb pixels in XB_FMT_A8R8G8B8 format
+   \return true if successful, false otherwise
+   */
+  bool Create(unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *argb);
+
 private:
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
   static const char *GetFourCC(unsigned int format);
@@ -102,7 +119,7 @@ private:
     uint32_t      linearSize;
     uint32_t      depth;
     uint32_t      mipmapcount;
-    uint32_t      reserved[11];
+    uint32_t      reserved[11]; ///< reserved[0] is the LZ4 packed size of the data, 0 if stored as is
     ddpixelformat pixelFormat;
     ddcaps2       caps;
     uint32_t      reserved2;
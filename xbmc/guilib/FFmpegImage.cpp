@@ -165,7 +165,9 @@ CFFmpegImage::~CFFmpegImage()
 bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize,
                                       unsigned int width, unsigned int height)
 {
-    
+  m_idealWidth = width;
+  m_idealHeight = height;
+
   if (!Initialize(buffer, bufSize))
   {
     //log
@@ -174,8 +176,74 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
 
   av_frame_free(&m_pFrame);
   m_pFrame = ExtractFrame();
+  if (m_pFrame == nullptr)
+    return false;
+
+  // decode straight to the size that was asked for rather than to the full image
+  FitInto(m_width, m_height, m_idealWidth, m_idealHeight);
+  return true;
+}
+
+bool CFFmpegImage::GetJpegSize(const unsigned char* buffer, unsigned int bufSize, unsigned int& width, unsigned int& height)
+{
+  if (bufSize < 4 || buffer[0] != 0xFF || buffer[1] != 0xD8)
+    return false;
+
+  // walk the markers up to the frame header, the exif thumbnail is skipped along with its APP1 segment
+  unsigned int pos = 2;
+  while (pos + 4 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+    unsigned char marker = buffer[pos + 1];
+    if (marker == 0xFF)
+    { // fill byte
+      pos++;
+      continue;
+    }
+    pos += 2;
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+      continue; // markers without a segment
+    if (marker == 0xD9 || marker == 0xDA)
+      return false; // no frame header before the image data
+
+    unsigned int length = (buffer[pos] << 8) | buffer[pos + 1];
+    if (length < 2)
+      return false;
+
+    // only baseline, extended and progressive huffman coded frames can be decoded at a lower resolution
+    if (marker == 0xC0 || marker == 0xC1 || marker == 0xC2)
+    {
+      if (length < 7 || pos + 7 > bufSize)
+        return false;
+      height = (buffer[pos + 3] << 8) | buffer[pos + 4];
+      width = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      return width > 0 && height > 0;
+    }
+    if (marker >= 0xC3 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+      return false; // lossless or arithmetic coded
+
+    pos += length;
+  }
+  return false;
+}
 
-  return !(m_pFrame == nullptr);
+void CFFmpegImage::FitInto(unsigned int& width, unsigned int& height, unsigned int maxWidth, unsigned int maxHeight)
+{
+  if (width == 0 || height == 0)
+    return;
+
+  float ratio = width / (float)height;
+  if (maxHeight && height > maxHeight)
+  {
+    height = maxHeight;
+    width = std::max(1u, (unsigned int)(height * ratio + 0.5f));
+  }
+  if (maxWidth && width > maxWidth)
+  {
+    width = maxWidth;
+    height = std::max(1u, (unsigned int)(width / ratio + 0.5f));
+  }
 }
 
 bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
@@ -257,6 +325,36 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
   }
   AVCodecContext* codec_ctx = m_fctx->streams[0]->codec;
   AVCodec* codec = avcodec_find_decoder(codec_ctx->codec_id);
+
+  // jpegs can be decoded at 1/2, 1/4 or 1/8 of their size by dropping the higher frequencies of
+  // the DCT, which is much cheaper than decoding the full image and scaling it down afterwards.
+  // Pick the smallest of those that is still at least as large as the size asked for.
+  m_fullWidth = m_fullHeight = 0;
+  unsigned int jpegWidth, jpegHeight;
+  if (is_jpeg && codec && codec->max_lowres > 0 && (m_idealWidth || m_idealHeight) &&
+      GetJpegSize(buffer, bufSize, jpegWidth, jpegHeight))
+  {
+    unsigned int width = jpegWidth, height = jpegHeight;
+    FitInto(width, height, m_idealWidth, m_idealHeight);
+
+    int lowres = 0;
+    while (lowres < std::min(3, (int)codec->max_lowres))
+    {
+      unsigned int scale = 1 << (lowres + 1);
+      if ((jpegWidth + scale - 1) / scale < width || (jpegHeight + scale - 1) / scale < height)
+        break;
+      lowres++;
+    }
+    if (lowres > 0)
+    {
+      codec_ctx->lowres = lowres;
+      m_fullWidth = jpegWidth;
+      m_fullHeight = jpegHeight;
+      CLog::Log(LOGDEBUG, "CFFmpegImage::%s - decoding %ux%u jpeg at 1/%i for %ux%u", __FUNCTION__,
+                jpegWidth, jpegHeight, 1 << lowres, width, height);
+    }
+  }
+
   if (avcodec_open2(codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -293,8 +391,8 @@ AVFrame* CFFmpegImage::ExtractFrame()
       av_frame_set_pkt_duration(frame, av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 }));
       m_height = frame->height;
       m_width = frame->width;
-      m_originalWidth = m_width;
-      m_originalHeight = m_height;
+      m_originalWidth = m_fullWidth ? m_fullWidth : m_width;
+      m_originalHeight = m_fullHeight ? m_fullHeight : m_height;
 
       const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
       if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -439,22 +537,13 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
   AVColorRange range = av_frame_get_color_range(frame);
   AVPixelFormat pixFormat = ConvertFormats(frame);
 
-  // assumption quadratic maximums e.g. 2048x2048
-  float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
-  if (nHeight > height)
-  {
-    nHeight = height;
-    nWidth = (unsigned int)(nHeight * ratio + 0.5f);
-  }
-  if (nWidth > width)
-  {
-    nWidth = width;
-    nHeight = (unsigned int)(nWidth / ratio + 0.5f);
-  }
+  // the frame may already be smaller than the original image when decoded at a lower resolution,
+  // and is scaled to the size worked out by LoadImageFromMemory as far as the buffer allows
+  unsigned int nWidth = m_width;
+  unsigned int nHeight = m_height;
+  FitInto(nWidth, nHeight, width, height);
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -467,7 +556,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
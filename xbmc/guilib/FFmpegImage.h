@@ -64,6 +64,8 @@ struct AVFormatContext;
 
 class CFFmpegImage : public IImage
 {
+  friend class TestFFmpegImage;
+
 public:
   explicit CFFmpegImage(const std::string& strMimeType);
   virtual ~CFFmpegImage();
@@ -88,6 +90,8 @@ private:
   AVFrame* ExtractFrame();
   bool DecodeFrame(AVFrame* m_pFrame, unsigned int width, unsigned int height, unsigned int pitch, unsigned char * const pixels);
   static AVPixelFormat ConvertFormats(AVFrame* frame);
+  static bool GetJpegSize(const unsigned char* buffer, unsigned int bufSize, unsigned int& width, unsigned int& height);
+  static void FitInto(unsigned int& width, unsigned int& height, unsigned int maxWidth, unsigned int maxHeight);
   std::string m_strMimeType;
   void CleanupLocalOutputBuffer();
 
@@ -100,4 +104,9 @@ private:
 
   AVFrame* m_pFrame;
   uint8_t* m_outputBuffer;
+
+  unsigned int m_idealWidth = 0;  ///< size asked for by LoadImageFromMemory, 0 if unlimited
+  unsigned int m_idealHeight = 0;
+  unsigned int m_fullWidth = 0;   ///< size of a jpeg decoded at a fraction of it, 0 otherwise
+  unsigned int m_fullHeight = 0;
 };
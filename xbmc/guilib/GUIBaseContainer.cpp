@@ -32,6 +32,8 @@
 #include "listproviders/IListProvider.h"
 #include "settings/Settings.h"
 #include "guiinfo/GUIInfoLabels.h"
+#include "settings/AdvancedSettings.h"
+#include "GUILargeTextureManager.h"
 
 #define HOLD_TIME_START 100
 #define HOLD_TIME_END   3000
@@ -59,6 +61,12 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_autoScrollMoveTime = 0;
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
+  m_prefetchValue = 0.0f;
+  m_prefetchTime = 0;
+  m_prefetchVelocity = 0.0f;
+  m_prefetchDirection = 1;
+  m_prefetchStart = 0;
+  m_prefetchEnd = 0;
   m_lastRenderTime = 0;
 }
 
@@ -867,6 +875,10 @@ void CGUIBaseContainer::FreeResources(bool immediately)
       m_listProvider->Reset();
     }
   }
+  g_largeTextureManager.CancelPrefetch(this);
+  m_prefetchStart = m_prefetchEnd = 0;
+  m_prefetchTime = 0;
+  m_prefetchVelocity = 0.0f;
   m_scroller.Stop();
 }
 
@@ -1120,6 +1132,66 @@ void CGUIBaseContainer::UpdateScrollOffset(unsigned int currentTime)
     m_scrollTimer.Stop();
     m_lastScrollStartTimer.Stop();
   }
+  UpdatePrefetch(currentTime);
+}
+
+void CGUIBaseContainer::UpdatePrefetch(unsigned int currentTime)
+{
+  if (!g_advancedSettings.m_imagePrefetchMemory || !m_layout || m_items.empty() || m_itemsPerPage <= 0)
+    return;
+  float size = m_layout->Size(m_orientation);
+  if (size <= 0)
+    return;
+
+  float value = m_scroller.GetValue() / size;
+  if (m_prefetchTime && currentTime > m_prefetchTime)
+  {
+    float velocity = (value - m_prefetchValue) * 1000.0f / (currentTime - m_prefetchTime);
+    m_prefetchVelocity = 0.8f * m_prefetchVelocity + 0.2f * velocity;
+  }
+  m_prefetchValue = value;
+  m_prefetchTime = currentTime;
+  // keep the last direction while idle, the user most likely continues that way
+  if (m_prefetchVelocity > 0.5f)
+    m_prefetchDirection = 1;
+  else if (m_prefetchVelocity < -0.5f)
+    m_prefetchDirection = -1;
+
+  // the faster we scroll, the further ahead we look
+  int pages = std::min(3, 1 + (int)(fabs(m_prefetchVelocity) / m_itemsPerPage));
+  int cacheBefore, cacheAfter;
+  GetCacheOffsets(cacheBefore, cacheAfter);
+  int offset = (int)floorf(value);
+  int start, end;
+  if (m_prefetchDirection > 0)
+  {
+    start = offset + m_itemsPerPage + 1 + cacheAfter;
+    end = start + pages * m_itemsPerPage;
+  }
+  else
+  {
+    end = offset - cacheBefore;
+    start = end - pages * m_itemsPerPage;
+  }
+  if (start == m_prefetchStart && end == m_prefetchEnd)
+    return;
+  m_prefetchStart = start;
+  m_prefetchEnd = end;
+
+  // nearest rows first, so that the budget is spent on what is shown next
+  std::vector<std::string> images;
+  int itemsPerRow = std::max(1, CorrectOffset(1, 0) - CorrectOffset(0, 0));
+  for (int i = 0; i < end - start; i++)
+  {
+    int row = m_prefetchDirection > 0 ? start + i : end - 1 - i;
+    for (int col = 0; col < itemsPerRow; col++)
+    {
+      int itemNo = CorrectOffset(row, col);
+      if (itemNo >= 0 && itemNo < (int)m_items.size())
+        m_layout->GetPrefetchImages(m_items[itemNo].get(), images);
+    }
+  }
+  g_largeTextureManager.PrefetchImages(this, images);
 }
 
 int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
@@ -1133,6 +1205,7 @@ void CGUIBaseContainer::Reset()
   m_items.clear();
   m_lastItem.reset();
   ResetAutoScrolling();
+  m_prefetchStart = m_prefetchEnd = 0;
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
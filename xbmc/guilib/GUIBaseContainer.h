@@ -163,6 +163,13 @@ protected:
   void SetContainerMoving(int direction);
   void UpdateScrollOffset(unsigned int currentTime);
 
+  /*! \brief Prefetch images for the rows about to scroll into view
+   The window of rows extends up to 3 pages beyond the cached items in the direction of scrolling,
+   depending on the scroll velocity, and is handed to the large texture manager when it changes.
+   \sa CGUILargeTextureManager::PrefetchImages
+   */
+  void UpdatePrefetch(unsigned int currentTime);
+
   CScroller m_scroller;
 
   IListProvider *m_listProvider;
@@ -233,6 +240,14 @@ private:
   std::string m_match;
   float m_scrollItemsPerFrame;
 
+  // viewport prefetch
+  float m_prefetchValue;      ///< scroller position at the last update, in rows
+  unsigned int m_prefetchTime;
+  float m_prefetchVelocity;   ///< smoothed scroll velocity, in rows per second
+  int m_prefetchDirection;
+  int m_prefetchStart;        ///< current window of prefetched rows
+  int m_prefetchEnd;
+
   static const int letter_match_timeout = 1000;
 };
 
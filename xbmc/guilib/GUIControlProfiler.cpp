@@ -19,6 +19,7 @@
  */
 
 #include "GUIControlProfiler.h"
+#include "TextureBudget.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
@@ -341,5 +342,24 @@ bool CGUIControlProfiler::SaveResults(void)
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
+
+  // texture memory at the end of the profiled frames, in bytes
+  CTextureBudget::Stats stats;
+  CTextureBudget::GetInstance().GetStats(stats);
+  TiXmlElement *textures = new TiXmlElement("texturememory");
+  textures->SetAttribute("budget", StringUtils::Format("%" PRIuS, stats.budget).c_str());
+  textures->SetAttribute("used", StringUtils::Format("%" PRIuS, stats.used).c_str());
+  textures->SetAttribute("peak", StringUtils::Format("%" PRIuS, stats.peak).c_str());
+  textures->SetAttribute("gpu", StringUtils::Format("%" PRIuS, stats.gpu).c_str());
+  textures->SetAttribute("evictions", StringUtils::Format("%u", stats.evictions).c_str());
+  for (std::vector<CTextureBudget::PoolStats>::const_iterator it = stats.pools.begin(); it != stats.pools.end(); ++it)
+  {
+    TiXmlElement *pool = new TiXmlElement("pool");
+    pool->SetAttribute("name", it->name.c_str());
+    pool->SetAttribute("used", StringUtils::Format("%" PRIuS, it->used).c_str());
+    pool->SetAttribute("unused", StringUtils::Format("%" PRIuS, it->unused).c_str());
+    textures->LinkEndChild(pool);
+  }
+  root->LinkEndChild(textures);
   return doc.SaveFile(m_strOutputFile);
 }
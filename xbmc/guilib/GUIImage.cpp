@@ -80,6 +80,13 @@ void CGUIImage::UpdateInfo(const CGUIListItem *item)
     SetFileName(m_info.GetLabel(m_parentID, true, &m_currentFallback));
 }
 
+std::string CGUIImage::GetItemFileName(const CGUIListItem *item) const
+{
+  if (!item || m_info.IsConstant())
+    return "";
+  return m_info.GetItemLabel(item, true);
+}
+
 void CGUIImage::AllocateOnDemand()
 {
   // if we're hidden, we can free our resources and return
@@ -95,6 +95,10 @@ public:
   void SetCrossFade(unsigned int time);
 
   const std::string& GetFileName() const;
+  /*!
+   \brief Image this control would show for the given list item, empty if it doesn't depend on the item.
+   */
+  std::string GetItemFileName(const CGUIListItem *item) const;
   float GetTextureWidth() const;
   float GetTextureHeight() const;
 
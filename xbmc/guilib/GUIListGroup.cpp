@@ -19,6 +19,7 @@
  */
 
 #include "GUIListGroup.h"
+#include "GUIImage.h"
 #include "GUIListLabel.h"
 #include "utils/log.h"
 
@@ -188,6 +189,22 @@ unsigned int CGUIListGroup::GetFocusedItem() const
   return 0;
 }
 
+void CGUIListGroup::GetPrefetchImages(const CGUIListItem *item, std::vector<std::string> &images) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); it++)
+  {
+    CGUIControl::GUICONTROLTYPES type = (*it)->GetControlType();
+    if (type == CGUIControl::GUICONTROL_LISTGROUP)
+      ((CGUIListGroup *)(*it))->GetPrefetchImages(item, images);
+    else if (type == CGUIControl::GUICONTROL_IMAGE || type == CGUIControl::GUICONTROL_BORDEREDIMAGE)
+    {
+      std::string image = ((CGUIImage *)(*it))->GetItemFileName(item);
+      if (!image.empty())
+        images.push_back(image);
+    }
+  }
+}
+
 bool CGUIListGroup::MoveLeft()
 {
   for (iControls it = m_children.begin(); it != m_children.end(); it++)
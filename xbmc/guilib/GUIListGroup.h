@@ -55,6 +55,7 @@ public:
   bool MoveRight();
   void SetState(bool selected, bool focused);
   void SelectItemFromPoint(const CPoint &point);
+  void GetPrefetchImages(const CGUIListItem *item, std::vector<std::string> &images) const;
 
 protected:
   const CGUIListItem *m_item;
@@ -128,6 +128,11 @@ void CGUIListItemLayout::SelectItemFromPoint(const CPoint &point)
   m_group.SelectItemFromPoint(point);
 }
 
+void CGUIListItemLayout::GetPrefetchImages(const CGUIListItem *item, std::vector<std::string> &images) const
+{
+  m_group.GetPrefetchImages(item, images);
+}
+
 bool CGUIListItemLayout::MoveLeft()
 {
   return m_group.MoveLeft();
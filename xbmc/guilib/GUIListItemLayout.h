@@ -52,6 +52,7 @@ public:
   void SetWidth(float width);
   void SetHeight(float height);
   void SelectItemFromPoint(const CPoint &point);
+  void GetPrefetchImages(const CGUIListItem *item, std::vector<std::string> &images) const;
   bool MoveLeft();
   bool MoveRight();
 
@@ -39,6 +39,10 @@
 #include "linux/XMemUtils.h"
 #endif
 
+#include <atomic>
+
+static std::atomic<size_t> s_gpuMemory(0);
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -47,12 +51,14 @@ CBaseTexture::CBaseTexture(unsigned int width, unsigned int height, unsigned int
    m_mipmapping( false )
 {
   m_pixels = NULL;
+  m_gpuMemory = 0;
   m_loadedToGPU = false;
   Allocate(width, height, format);
 }
 
 CBaseTexture::~CBaseTexture()
 {
+  s_gpuMemory -= m_gpuMemory;
   _aligned_free(m_pixels);
   m_pixels = NULL;
 }
@@ -154,6 +160,20 @@ void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int
     LoadToGPU();
 }
 
+void CBaseTexture::SetLoadedToGPU()
+{
+  m_loadedToGPU = true;
+  // uploads after an Update() replace the previous texture data, which may have had another size
+  size_t memory = GetPitch() * GetRows();
+  s_gpuMemory += memory - m_gpuMemory;
+  m_gpuMemory = memory;
+}
+
+size_t CBaseTexture::GetGPUMemory()
+{
+  return s_gpuMemory;
+}
+
 void CBaseTexture::ClampToEdge()
 {
   if (m_pixels == nullptr)
@@ -330,7 +350,7 @@ bool CBaseTexture::LoadIImage(IImage *pImage, unsigned char* buffer, unsigned in
   return false;
 }
 
-bool CBaseTexture::LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, unsigned char* pixels)
+bool CBaseTexture::LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, const unsigned char* pixels)
 {
   m_imageWidth = m_originalWidth = width;
   m_imageHeight = m_originalHeight = height;
@@ -73,7 +73,7 @@ public:
   static CBaseTexture *LoadFromFileInMemory(unsigned char* buffer, size_t bufferSize, const std::string& mimeType,
                                             unsigned int idealWidth = 0, unsigned int idealHeight = 0);
 
-  bool LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, unsigned char* pixels);
+  bool LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, const unsigned char* pixels);
   bool LoadPaletted(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, const COLOR *palette);
 
   bool HasAlpha() const;
@@ -108,6 +108,9 @@ public:
   static unsigned int PadPow2(unsigned int x);
   static bool SwapBlueRed(unsigned char *pixels, unsigned int height, unsigned int pitch, unsigned int elements = 4, unsigned int offset=0);
 
+  /*! \brief memory of all textures currently uploaded to the GPU */
+  static size_t GetGPUMemory();
+
 private:
   // no copy constructor
   CBaseTexture(const CBaseTexture &copy);
@@ -121,6 +124,8 @@ protected:
   unsigned int GetPitch(unsigned int width) const;
   unsigned int GetRows(unsigned int height) const;
   unsigned int GetBlockSize() const;
+  /*! \brief mark the texture as uploaded, accounting its memory to GetGPUMemory */
+  void SetLoadedToGPU();
 
   unsigned int m_imageWidth;
   unsigned int m_imageHeight;
@@ -131,6 +136,7 @@ protected:
 
   unsigned char* m_pixels;
   bool m_loadedToGPU;
+  size_t m_gpuMemory;
   unsigned int m_format;
   int m_orientation;
   bool m_hasAlpha;
@@ -0,0 +1,164 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureBudget.h"
+#include "Texture.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+CTextureBudget::CTextureBudget()
+{
+  m_used = 0;
+  m_peak = 0;
+  m_evictions = 0;
+  m_evicted = 0;
+  m_warned = false;
+}
+
+CTextureBudget &CTextureBudget::GetInstance()
+{
+  static CTextureBudget sTextureBudget;
+  return sTextureBudget;
+}
+
+void CTextureBudget::RegisterPool(const std::string &name, ITextureBudgetPool *pool)
+{
+  CSingleLock lock(m_section);
+  m_pools.push_back(std::make_pair(name, pool));
+}
+
+void CTextureBudget::UnregisterPool(ITextureBudgetPool *pool)
+{
+  CSingleLock lock(m_section);
+  for (std::vector< std::pair<std::string, ITextureBudgetPool *> >::iterator it = m_pools.begin(); it != m_pools.end(); ++it)
+  {
+    if (it->second == pool)
+    {
+      m_pools.erase(it);
+      return;
+    }
+  }
+}
+
+void CTextureBudget::Allocated(size_t memory)
+{
+  CSingleLock lock(m_section);
+  m_used += memory;
+  m_peak = std::max(m_peak, m_used);
+}
+
+void CTextureBudget::Freed(size_t memory)
+{
+  CSingleLock lock(m_section);
+  m_used -= std::min(m_used, memory);
+}
+
+size_t CTextureBudget::GetUsage() const
+{
+  CSingleLock lock(m_section);
+  return m_used;
+}
+
+size_t CTextureBudget::GetBudget() const
+{
+  return (size_t)g_advancedSettings.m_textureMemoryBudget * 1024 * 1024;
+}
+
+bool CTextureBudget::Enforce()
+{
+  return Enforce(GetBudget());
+}
+
+bool CTextureBudget::Enforce(size_t budget)
+{
+  if (!budget || GetUsage() <= budget)
+    return false;
+
+  // the pools take their own locks while freeing and report back through Freed(), so they are
+  // called without holding ours
+  std::vector< std::pair<std::string, ITextureBudgetPool *> > pools;
+  {
+    CSingleLock lock(m_section);
+    pools = m_pools;
+  }
+
+  bool evicted = false;
+  while (GetUsage() > budget)
+  {
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    ITextureBudgetPool *oldest = NULL;
+    unsigned int oldestAge = 0;
+    for (std::vector< std::pair<std::string, ITextureBudgetPool *> >::const_iterator it = pools.begin(); it != pools.end(); ++it)
+    {
+      unsigned int releaseTime;
+      if (it->second->GetLeastRecentlyUsed(releaseTime) && (!oldest || now - releaseTime >= oldestAge))
+      {
+        oldest = it->second;
+        oldestAge = now - releaseTime;
+      }
+    }
+
+    if (!oldest)
+    {
+      CSingleLock lock(m_section);
+      if (!m_warned)
+        CLog::Log(LOGWARNING, "CTextureBudget::%s - %" PRIuS" bytes of textures in use exceed the budget of %" PRIuS" bytes",
+                  __FUNCTION__, m_used, budget);
+      m_warned = true;
+      break;
+    }
+
+    size_t freed = oldest->FreeLeastRecentlyUsed();
+    CSingleLock lock(m_section);
+    m_evictions++;
+    m_evicted += freed;
+    m_warned = false;
+    evicted = true;
+  }
+  return evicted;
+}
+
+void CTextureBudget::GetStats(Stats &stats) const
+{
+  std::vector< std::pair<std::string, ITextureBudgetPool *> > pools;
+  {
+    CSingleLock lock(m_section);
+    stats.budget = GetBudget();
+    stats.used = m_used;
+    stats.peak = m_peak;
+    stats.evictions = m_evictions;
+    stats.evicted = m_evicted;
+    pools = m_pools;
+  }
+  stats.gpu = CBaseTexture::GetGPUMemory();
+
+  stats.pools.clear();
+  for (std::vector< std::pair<std::string, ITextureBudgetPool *> >::const_iterator it = pools.begin(); it != pools.end(); ++it)
+  {
+    PoolStats pool;
+    pool.name = it->first;
+    it->second->GetMemoryUsage(pool.used, pool.unused);
+    stats.pools.push_back(pool);
+  }
+}
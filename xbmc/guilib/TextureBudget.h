@@ -0,0 +1,127 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+/*!
+ \ingroup textures
+ \brief A cache of textures whose memory is accounted against the texture budget.
+
+ Unreferenced textures are kept around for a while in case they are needed again, these are
+ the candidates for eviction when the budget is exceeded.
+ */
+class ITextureBudgetPool
+{
+public:
+  virtual ~ITextureBudgetPool() {}
+
+  /*!
+   \brief Time the least recently used unreferenced texture was released.
+   \param releaseTime set to the XbmcThreads::SystemClockMillis() at release.
+   \return false if all textures in the pool are in use.
+   */
+  virtual bool GetLeastRecentlyUsed(unsigned int &releaseTime) = 0;
+
+  /*!
+   \brief Free the least recently used unreferenced texture.
+   \return the amount of memory freed.
+   */
+  virtual size_t FreeLeastRecentlyUsed() = 0;
+
+  /*!
+   \brief Memory held by the pool, and how much of it is unreferenced.
+   */
+  virtual void GetMemoryUsage(size_t &used, size_t &unused) = 0;
+};
+
+/*!
+ \ingroup textures
+ \brief Accounts the memory of the textures held by the texture managers against a global budget.
+
+ The managers report the textures they allocate and free. When the total exceeds the budget set
+ with <texturememorybudget> in advancedsettings, unreferenced textures are evicted least
+ recently used first, across all pools, instead of waiting for their timeout to expire.
+ */
+class CTextureBudget
+{
+public:
+  struct PoolStats
+  {
+    std::string name;
+    size_t used;
+    size_t unused;
+  };
+
+  struct Stats
+  {
+    size_t budget;       ///< budget in bytes, 0 if unlimited
+    size_t used;         ///< memory held by the pools
+    size_t peak;         ///< highest usage seen
+    size_t gpu;          ///< memory of all textures uploaded to the GPU, including those outside the pools
+    unsigned int evictions;
+    size_t evicted;      ///< memory freed by evictions
+    std::vector<PoolStats> pools;
+  };
+
+  static CTextureBudget &GetInstance();
+
+  void RegisterPool(const std::string &name, ITextureBudgetPool *pool);
+  void UnregisterPool(ITextureBudgetPool *pool);
+
+  void Allocated(size_t memory);
+  void Freed(size_t memory);
+
+  size_t GetUsage() const;
+  size_t GetBudget() const;
+
+  /*!
+   \brief Evict unreferenced textures until the usage is within budget.
+   Must be called from the application thread.
+   \return true if textures were evicted.
+   */
+  bool Enforce();
+
+  /*!
+   \brief Evict unreferenced textures until the usage is within the given budget.
+   \param budget budget in bytes, 0 for unlimited.
+   \return true if textures were evicted.
+   */
+  bool Enforce(size_t budget);
+
+  void GetStats(Stats &stats) const;
+
+private:
+  CTextureBudget();
+  CTextureBudget(const CTextureBudget&);
+  CTextureBudget const& operator=(CTextureBudget const&);
+
+  std::vector< std::pair<std::string, ITextureBudgetPool *> > m_pools;
+  size_t m_used;
+  size_t m_peak;
+  unsigned int m_evictions;
+  size_t m_evicted;
+  bool m_warned;
+  mutable CCriticalSection m_section;
+};
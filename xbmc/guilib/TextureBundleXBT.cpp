@@ -216,23 +216,29 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // the packed data is used in place when the bundle is memory mapped
+  const unsigned char *packed = m_XBTFReader->GetFrameData(frame);
+  unsigned char *buffer = nullptr;
+  if (packed == nullptr)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
+    buffer = new unsigned char [(size_t)frame.GetPackedSize()];
+    if (buffer == NULL)
+    {
+      CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
+      return false;
+    }
 
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
-  {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
+    // load the compressed texture
+    if (!m_XBTFReader->Load(frame, buffer))
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+      delete[] buffer;
+      return false;
+    }
+    packed = buffer;
   }
 
-  // check if it's packed with lzo
+  // check if it's packed with lzo or lz4
   if (frame.IsPacked())
   { // unpack
     unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
@@ -242,9 +248,7 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFram
       delete[] buffer;
       return false;
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+    if (!Unpack(frame, packed, unpacked))
     {
       CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
       delete[] buffer;
@@ -253,17 +257,35 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFram
     }
     delete[] buffer;
     buffer = unpacked;
+    packed = unpacked;
   }
 
-  // create an xbmc texture
+  // create an xbmc texture, unpacked frames are copied straight from the mapped pages
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), packed);
 
   delete[] buffer;
 
   return true;
 }
 
+bool CTextureBundleXBT::Unpack(const CXBTFFrame& frame, const uint8_t* packed, uint8_t* unpacked)
+{
+  if (frame.IsLZ4())
+    return CXBTFLZ4::Decompress(packed, static_cast<size_t>(frame.GetPackedSize()), unpacked, static_cast<size_t>(frame.GetUnpackedSize()));
+
+  // make sure lzo is initialized
+  if (lzo_init() != LZO_E_OK)
+  {
+    CLog::Log(LOGERROR, "CTextureBundleXBT: failed to initialize lzo");
+    return false;
+  }
+
+  lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
+  return lzo1x_decompress_safe(packed, static_cast<lzo_uint>(frame.GetPackedSize()), unpacked, &size, nullptr) == LZO_E_OK &&
+         size == frame.GetUnpackedSize();
+}
+
 void CTextureBundleXBT::SetThemeBundle(bool themeBundle)
 {
   m_themeBundle = themeBundle;
@@ -284,6 +306,20 @@ std::string CTextureBundleXBT::Normalize(const std::string &name)
 
 uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame)
 {
+  // callers own the returned buffer, so mapped frames that aren't packed are still copied
+  const uint8_t* mapped = reader.GetFrameData(frame);
+  if (mapped != nullptr && frame.IsPacked())
+  {
+    uint8_t* unpackedBuffer = new uint8_t[static_cast<size_t>(frame.GetUnpackedSize())];
+    if (!Unpack(frame, mapped, unpackedBuffer))
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
+      delete[] unpackedBuffer;
+      return nullptr;
+    }
+    return unpackedBuffer;
+  }
+
   uint8_t* packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
   if (packedBuffer == nullptr)
   {
@@ -311,17 +347,7 @@ uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFr
     return nullptr;
   }
 
-  // make sure lzo is initialized
-  if (lzo_init() != LZO_E_OK)
-  {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: failed to initialize lzo");
-    delete[] packedBuffer;
-    delete[] unpackedBuffer;
-    return nullptr;
-  }
-
-  lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
-  if (lzo1x_decompress_safe(packedBuffer, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
+  if (!Unpack(frame, packedBuffer, unpackedBuffer))
   {
     CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
     delete[] packedBuffer;
@@ -54,6 +54,7 @@ public:
 private:
   bool OpenBundle();
   bool ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
+  static bool Unpack(const CXBTFFrame& frame, const uint8_t* packed, uint8_t* unpacked);
 
   time_t m_TimeStamp;
 
@@ -186,7 +186,7 @@ void CDXTexture::LoadToGPU()
   _aligned_free(m_pixels);
   m_pixels = nullptr;
 
-  m_loadedToGPU = true;
+  SetLoadedToGPU();
 }
 
 void CDXTexture::BindToUnit(unsigned int unit)
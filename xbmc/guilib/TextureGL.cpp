@@ -201,7 +201,7 @@ void CGLTexture::LoadToGPU()
   _aligned_free(m_pixels);
   m_pixels = NULL;
 
-  m_loadedToGPU = true;
+  SetLoadedToGPU();
 }
 
 void CGLTexture::BindToUnit(unsigned int unit)
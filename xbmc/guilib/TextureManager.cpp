@@ -195,6 +195,8 @@ void CTextureMap::Flush()
 void CTextureMap::FreeTexture()
 {
   m_texture.Free();
+  CTextureBudget::GetInstance().Freed(m_memUsage);
+  m_memUsage = 0;
 }
 
 void CTextureMap::SetHeight(int height)
@@ -217,7 +219,11 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
   m_texture.Add(texture, delay);
 
   if (texture)
-    m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
+  {
+    uint32_t memUsage = sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
+    m_memUsage += memUsage;
+    CTextureBudget::GetInstance().Allocated(memUsage);
+  }
 }
 
 /************************************************************************/
@@ -227,11 +233,13 @@ CGUITextureManager::CGUITextureManager(void)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
+  CTextureBudget::GetInstance().RegisterPool("skin", this);
 }
 
 CGUITextureManager::~CGUITextureManager(void)
 {
   Cleanup();
+  CTextureBudget::GetInstance().UnregisterPool(this);
 }
 
 /************************************************************************/
@@ -527,6 +535,50 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
   m_unusedHwTextures.clear();
 }
 
+CGUITextureManager::ilistUnused CGUITextureManager::FindLeastRecentlyUsed()
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  ilistUnused oldest = m_unusedTextures.end();
+  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  {
+    if (oldest == m_unusedTextures.end() || now - i->second > now - oldest->second)
+      oldest = i;
+  }
+  return oldest;
+}
+
+bool CGUITextureManager::GetLeastRecentlyUsed(unsigned int &releaseTime)
+{
+  CSingleLock lock(g_graphicsContext);
+  ilistUnused oldest = FindLeastRecentlyUsed();
+  if (oldest == m_unusedTextures.end())
+    return false;
+  releaseTime = oldest->second;
+  return true;
+}
+
+size_t CGUITextureManager::FreeLeastRecentlyUsed()
+{
+  CSingleLock lock(g_graphicsContext);
+  ilistUnused oldest = FindLeastRecentlyUsed();
+  if (oldest == m_unusedTextures.end())
+    return 0;
+  size_t memUsage = oldest->first->GetMemoryUsage();
+  delete oldest->first;
+  m_unusedTextures.erase(oldest);
+  return memUsage;
+}
+
+void CGUITextureManager::GetMemoryUsage(size_t &used, size_t &unused)
+{
+  CSingleLock lock(g_graphicsContext);
+  used = GetMemoryUsage();
+  unused = 0;
+  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+    unused += i->first->GetMemoryUsage();
+  used += unused;
+}
+
 void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
 {
   CSingleLock lock(g_graphicsContext);
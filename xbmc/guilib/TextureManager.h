@@ -29,6 +29,7 @@
 #include <utility>
 
 #include "TextureBundle.h"
+#include "TextureBudget.h"
 #include "threads/CriticalSection.h"
 
 /************************************************************************/
@@ -101,7 +102,7 @@ protected:
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
-class CGUITextureManager
+class CGUITextureManager : public ITextureBudgetPool
 {
 public:
   CGUITextureManager(void);
@@ -124,12 +125,18 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  // ITextureBudgetPool implementation
+  virtual bool GetLeastRecentlyUsed(unsigned int &releaseTime);
+  virtual size_t FreeLeastRecentlyUsed();
+  virtual void GetMemoryUsage(size_t &used, size_t &unused);
 protected:
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
   std::vector<unsigned int> m_unusedHwTextures;
   typedef std::vector<CTextureMap*>::iterator ivecTextures;
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
+  ilistUnused FindLeastRecentlyUsed();
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
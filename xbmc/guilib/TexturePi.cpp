@@ -97,7 +97,7 @@ void CPiTexture::LoadToGPU()
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
       glGenerateMipmap(GL_TEXTURE_2D);
     }
-    m_loadedToGPU = true;
+    SetLoadedToGPU();
     return;
   }
   CGLTexture::LoadToGPU();
@@ -21,6 +21,7 @@
 #include "XBTF.h"
 
 #include <cstring>
+#include <vector>
 #include <utility>
 
 CXBTFFrame::CXBTFFrame()
@@ -69,6 +70,11 @@ bool CXBTFFrame::IsPacked() const
   return m_unpackedSize != m_packedSize;
 }
 
+bool CXBTFFrame::IsLZ4() const
+{
+  return (m_format & XB_FMT_LZ4) != 0;
+}
+
 bool CXBTFFrame::HasAlpha() const
 {
   return (m_format & XB_FMT_OPAQUE) == 0;
@@ -252,3 +258,177 @@ void CXBTFBase::UpdateFile(const CXBTFFile& file)
 
   it->second = file;
 }
+
+// LZ4 block format: sequences of a token holding the literal and match lengths, the literals,
+// a 16 bit little endian match offset and the match length extension. The last sequence only
+// holds literals, and ends at least 5 bytes after the last match.
+static const size_t LZ4_MINMATCH = 4;
+static const size_t LZ4_LASTLITERALS = 5;
+static const size_t LZ4_MFLIMIT = 12;
+static const size_t LZ4_MAXOFFSET = 65535;
+static const unsigned int LZ4_HASHLOG = 16;
+
+static inline uint32_t LZ4Read32(const uint8_t* p)
+{
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline uint32_t LZ4Hash(uint32_t sequence)
+{
+  return (sequence * 2654435761U) >> (32 - LZ4_HASHLOG);
+}
+
+static bool LZ4WriteLength(uint8_t*& op, const uint8_t* end, size_t length)
+{
+  for (; length >= 255; length -= 255)
+  {
+    if (op >= end)
+      return false;
+    *op++ = 255;
+  }
+  if (op >= end)
+    return false;
+  *op++ = static_cast<uint8_t>(length);
+  return true;
+}
+
+static bool LZ4WriteSequence(uint8_t*& op, const uint8_t* end, const uint8_t* literals, size_t literalLength,
+                             size_t offset, size_t matchLength)
+{
+  if (op >= end)
+    return false;
+  uint8_t* token = op++;
+  *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+  if (literalLength >= 15 && !LZ4WriteLength(op, end, literalLength - 15))
+    return false;
+  if (static_cast<size_t>(end - op) < literalLength)
+    return false;
+  memcpy(op, literals, literalLength);
+  op += literalLength;
+
+  if (!matchLength)
+    return true;
+
+  if (end - op < 2)
+    return false;
+  *op++ = static_cast<uint8_t>(offset);
+  *op++ = static_cast<uint8_t>(offset >> 8);
+  matchLength -= LZ4_MINMATCH;
+  *token |= matchLength >= 15 ? 15 : matchLength;
+  return matchLength < 15 || LZ4WriteLength(op, end, matchLength - 15);
+}
+
+size_t CXBTFLZ4::Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity)
+{
+  uint8_t* op = dst;
+  const uint8_t* end = dst + capacity;
+  size_t anchor = 0;
+
+  if (size > LZ4_MFLIMIT)
+  {
+    // positions are stored + 1 so that 0 marks an empty slot
+    std::vector<uint32_t> table(1 << LZ4_HASHLOG, 0);
+    const size_t matchStartLimit = size - LZ4_MFLIMIT;
+    const size_t matchEndLimit = size - LZ4_LASTLITERALS;
+
+    size_t ip = 0;
+    while (ip < matchStartLimit)
+    {
+      uint32_t sequence = LZ4Read32(src + ip);
+      uint32_t& slot = table[LZ4Hash(sequence)];
+      size_t ref = slot;
+      slot = static_cast<uint32_t>(ip + 1);
+
+      if (!ref || ip + 1 - ref > LZ4_MAXOFFSET || LZ4Read32(src + ref - 1) != sequence)
+      {
+        ip++;
+        continue;
+      }
+      ref--;
+
+      size_t length = LZ4_MINMATCH;
+      while (ip + length < matchEndLimit && src[ref + length] == src[ip + length])
+        length++;
+
+      if (!LZ4WriteSequence(op, end, src + anchor, ip - anchor, ip - ref, length))
+        return 0;
+      ip += length;
+      anchor = ip;
+    }
+  }
+
+  if (!LZ4WriteSequence(op, end, src + anchor, size - anchor, 0, 0))
+    return 0;
+  return op - dst;
+}
+
+bool CXBTFLZ4::Decompress(const uint8_t* src, size_t packedSize, uint8_t* dst, size_t unpackedSize)
+{
+  size_t ip = 0;
+  size_t op = 0;
+
+  while (ip < packedSize)
+  {
+    uint8_t token = src[ip++];
+
+    size_t length = token >> 4;
+    if (length == 15)
+    {
+      uint8_t byte;
+      do
+      {
+        if (ip >= packedSize)
+          return false;
+        byte = src[ip++];
+        length += byte;
+      } while (byte == 255);
+    }
+    if (length > packedSize - ip || length > unpackedSize - op)
+      return false;
+    memcpy(dst + op, src + ip, length);
+    ip += length;
+    op += length;
+
+    // the last sequence has no match
+    if (ip == packedSize)
+      break;
+
+    if (packedSize - ip < 2)
+      return false;
+    size_t offset = src[ip] | (src[ip + 1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > op)
+      return false;
+
+    length = token & 15;
+    if (length == 15)
+    {
+      uint8_t byte;
+      do
+      {
+        if (ip >= packedSize)
+          return false;
+        byte = src[ip++];
+        length += byte;
+      } while (byte == 255);
+    }
+    length += LZ4_MINMATCH;
+    if (length > unpackedSize - op)
+      return false;
+
+    // matches may overlap their own output
+    const uint8_t* match = dst + op - offset;
+    if (offset >= length)
+      memcpy(dst + op, match, length);
+    else
+    {
+      for (size_t i = 0; i < length; i++)
+        dst[op + i] = match[i];
+    }
+    op += length;
+  }
+
+  return op == unpackedSize;
+}
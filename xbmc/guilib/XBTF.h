@@ -40,6 +40,7 @@ static const std::string XBTF_VERSION = "2";
 #define XB_FMT_RGBA8      64
 #define XB_FMT_RGB8      128
 #define XB_FMT_OPAQUE  65536
+#define XB_FMT_LZ4    131072 ///< frame is packed with LZ4 rather than LZO
 
 class CXBTFFrame
 {
@@ -70,6 +71,7 @@ public:
   void SetDuration(uint32_t duration);
 
   bool IsPacked() const;
+  bool IsLZ4() const;
   bool HasAlpha() const;
 
 private:
@@ -127,3 +129,28 @@ protected:
 
   std::map<std::string, CXBTFFile> m_files;
 };
+
+/*!
+ \brief LZ4 block format codec for frames flagged with XB_FMT_LZ4.
+
+ Decompresses several times faster than LZO at a slightly lower ratio. Kept here rather than
+ using liblz4 so that TexturePacker and the reader share it without another dependency.
+ */
+class CXBTFLZ4
+{
+public:
+  /*!
+   \brief Compress a buffer.
+   \return the compressed size, 0 if it doesn't fit within capacity.
+   */
+  static size_t Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+  /*!
+   \brief Decompress a buffer, validating all lengths and offsets against both buffers.
+   \return true if exactly unpackedSize bytes were produced.
+   */
+  static bool Decompress(const uint8_t* src, size_t packedSize, uint8_t* dst, size_t unpackedSize);
+
+  /*! \brief Worst case compressed size. */
+  static size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+};
@@ -177,6 +177,10 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+  // frames are read straight from the mapped pages when possible, which avoids a seek and copy
+  // per texture and lets the OS share and drop the pages. Fall back to reading the file otherwise.
+  m_mapping.Open(m_path);
+
   return true;
 }
 
@@ -192,6 +196,7 @@ void CXBTFReader::Close()
     fclose(m_file);
     m_file = nullptr;
   }
+  m_mapping.Close();
 
   m_path.clear();
   m_files.clear();
@@ -214,6 +219,13 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
   if (m_file == nullptr)
     return false;
 
+  const uint8_t* data = GetFrameData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
   if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
 #elif defined(TARGET_ANDROID)
@@ -228,3 +240,15 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 
   return true;
 }
+
+const uint8_t* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  if (!m_mapping.IsOpen())
+    return nullptr;
+
+  uint64_t size = m_mapping.GetSize();
+  if (frame.GetOffset() > size || frame.GetPackedSize() > size - frame.GetOffset())
+    return nullptr;
+
+  return m_mapping.GetData() + frame.GetOffset();
+}
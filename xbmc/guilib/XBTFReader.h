@@ -26,6 +26,7 @@
 #include <stdint.h>
 
 #include "XBTF.h"
+#include "utils/MappedFile.h"
 
 class CXBTFReader : public CXBTFBase
 {
@@ -41,9 +42,16 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Direct access to the packed data of a frame in the memory mapped bundle.
+   \return pointer to GetPackedSize() bytes valid until Close(), nullptr if the bundle isn't mapped.
+   */
+  const uint8_t* GetFrameData(const CXBTFFrame& frame) const;
+
 private:
   std::string m_path;
   FILE* m_file;
+  CMappedFile m_mapping;
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
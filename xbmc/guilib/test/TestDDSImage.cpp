@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "guilib/DDSImage.h"
+#include "guilib/XBTF.h"
+
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestDDSImage, RoundTrip)
+{
+  // padded source lines are stored tightly packed
+  const unsigned int width = 37, height = 11, pitch = width * 4 + 12;
+  std::vector<unsigned char> pixels(pitch * height);
+  for (size_t i = 0; i < pixels.size(); i++)
+    pixels[i] = (unsigned char)(i * 7 + (i >> 8));
+
+  CDDSImage image;
+  ASSERT_TRUE(image.Create(width, height, pitch, pixels.data()));
+  EXPECT_EQ(XB_FMT_A8R8G8B8, image.GetFormat());
+  EXPECT_EQ(width * height * 4, image.GetSize());
+
+  const std::string file = "special://temp/TestDDSImage.dds";
+  ASSERT_TRUE(image.WriteFile(file));
+
+  CDDSImage loaded;
+  EXPECT_TRUE(loaded.ReadFile(file));
+  XFILE::CFile::Delete(file);
+
+  EXPECT_EQ(width, loaded.GetWidth());
+  EXPECT_EQ(height, loaded.GetHeight());
+  EXPECT_EQ(XB_FMT_A8R8G8B8, loaded.GetFormat());
+  ASSERT_EQ(width * height * 4, loaded.GetSize());
+  for (unsigned int y = 0; y < height; y++)
+    EXPECT_EQ(0, memcmp(loaded.GetData() + y * width * 4, pixels.data() + y * pitch, width * 4)) << "line " << y;
+}
+
+TEST(TestDDSImage, RoundTripCompressed)
+{
+  // flat areas as in artwork pack well
+  const unsigned int width = 64, height = 32, pitch = width * 4;
+  std::vector<unsigned char> pixels(pitch * height);
+  for (size_t i = 0; i < pixels.size(); i++)
+    pixels[i] = (unsigned char)(i / 256);
+
+  CDDSImage image;
+  ASSERT_TRUE(image.Create(width, height, pitch, pixels.data()));
+
+  const std::string file = "special://temp/TestDDSImage.dds";
+  ASSERT_TRUE(image.WriteFile(file, true));
+  struct __stat64 st;
+  ASSERT_EQ(0, XFILE::CFile::Stat(file, &st));
+  EXPECT_LT(st.st_size, (int64_t)image.GetSize());
+
+  CDDSImage loaded;
+  EXPECT_TRUE(loaded.ReadFile(file));
+  XFILE::CFile::Delete(file);
+
+  EXPECT_EQ(width, loaded.GetWidth());
+  EXPECT_EQ(height, loaded.GetHeight());
+  ASSERT_EQ(width * height * 4, loaded.GetSize());
+  EXPECT_EQ(0, memcmp(loaded.GetData(), pixels.data(), pixels.size()));
+}
+
+TEST(TestDDSImage, CreateInvalid)
+{
+  CDDSImage image;
+  EXPECT_FALSE(image.Create(0, 10, 0, NULL));
+  EXPECT_FALSE(image.WriteFile("special://temp/TestDDSImage.dds"));
+}
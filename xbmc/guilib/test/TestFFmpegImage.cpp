@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "guilib/FFmpegImage.h"
+#include "guilib/XBTF.h"
+
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "libavutil/frame.h"
+}
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// encodes a jpeg of a solid colour through the thumbnail encoder
+std::vector<unsigned char> CreateJpeg(unsigned int width, unsigned int height, uint32_t colour)
+{
+  std::vector<uint32_t> pixels(width * height, colour);
+  CFFmpegImage encoder("image/jpeg");
+  unsigned char *buffer = nullptr;
+  unsigned int size = 0;
+  std::vector<unsigned char> jpeg;
+  if (encoder.CreateThumbnailFromSurface((unsigned char *)pixels.data(), width, height, XB_FMT_A8R8G8B8,
+                                         width * 4, "test.jpg", buffer, size))
+    jpeg.assign(buffer, buffer + size);
+  encoder.ReleaseThumbnailBuffer();
+  return jpeg;
+}
+
+}
+
+class TestFFmpegImage : public testing::Test
+{
+protected:
+  // size of the frame as it came out of the decoder, before it is scaled to the size asked for
+  static unsigned int FrameWidth(const CFFmpegImage &image) { return image.m_pFrame->width; }
+  static unsigned int FrameHeight(const CFFmpegImage &image) { return image.m_pFrame->height; }
+};
+
+TEST_F(TestFFmpegImage, DecodesJpegAtReducedSize)
+{
+  std::vector<unsigned char> jpeg = CreateJpeg(1024, 768, 0xff2060a0);
+  ASSERT_FALSE(jpeg.empty());
+
+  CFFmpegImage image("image/jpeg");
+  ASSERT_TRUE(image.LoadImageFromMemory(jpeg.data(), jpeg.size(), 256, 256));
+  EXPECT_EQ(256U, image.Width());
+  EXPECT_EQ(192U, image.Height());
+  EXPECT_EQ(1024U, image.originalWidth());
+  EXPECT_EQ(768U, image.originalHeight());
+
+  // decoded at 1/4 by the jpeg decoder, not in full and scaled down
+  EXPECT_EQ(256U, FrameWidth(image));
+  EXPECT_EQ(192U, FrameHeight(image));
+
+  std::vector<uint32_t> pixels(256 * 192);
+  ASSERT_TRUE(image.Decode((unsigned char *)pixels.data(), 256, 192, 256 * 4, XB_FMT_A8R8G8B8));
+  uint32_t pixel = pixels[96 * 256 + 128];
+  EXPECT_LE(abs((int)((pixel >> 16) & 0xff) - 0x20), 4);
+  EXPECT_LE(abs((int)((pixel >> 8) & 0xff) - 0x60), 4);
+  EXPECT_LE(abs((int)(pixel & 0xff) - 0xa0), 4);
+}
+
+TEST_F(TestFFmpegImage, DecodesJpegInFull)
+{
+  std::vector<unsigned char> jpeg = CreateJpeg(320, 240, 0xff808080);
+  ASSERT_FALSE(jpeg.empty());
+
+  // no size asked for, or one larger than the image
+  CFFmpegImage image("image/jpeg");
+  ASSERT_TRUE(image.LoadImageFromMemory(jpeg.data(), jpeg.size(), 0, 0));
+  EXPECT_EQ(320U, image.Width());
+  EXPECT_EQ(240U, image.Height());
+  EXPECT_EQ(320U, FrameWidth(image));
+
+  CFFmpegImage larger("image/jpeg");
+  ASSERT_TRUE(larger.LoadImageFromMemory(jpeg.data(), jpeg.size(), 1920, 1080));
+  EXPECT_EQ(320U, larger.Width());
+  EXPECT_EQ(240U, larger.Height());
+  EXPECT_EQ(320U, larger.originalWidth());
+}
@@ -0,0 +1,170 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/TextureBudget.h"
+#include "threads/SystemClock.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+const size_t MB = 1024 * 1024;
+
+// textures are (release time, size) pairs, a release time of 0 marks a texture in use
+class CTestPool : public ITextureBudgetPool
+{
+public:
+  CTestPool(const std::string &name, std::vector<std::string> &evicted)
+    : m_name(name), m_evicted(evicted)
+  {
+    CTextureBudget::GetInstance().RegisterPool(name, this);
+  }
+
+  virtual ~CTestPool()
+  {
+    for (std::list< std::pair<unsigned int, size_t> >::iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+      CTextureBudget::GetInstance().Freed(it->second);
+    CTextureBudget::GetInstance().UnregisterPool(this);
+  }
+
+  void Add(unsigned int age, size_t size)
+  {
+    m_textures.push_back(std::make_pair(age ? XbmcThreads::SystemClockMillis() - age : 0, size));
+    CTextureBudget::GetInstance().Allocated(size);
+  }
+
+  virtual bool GetLeastRecentlyUsed(unsigned int &releaseTime)
+  {
+    std::list< std::pair<unsigned int, size_t> >::iterator oldest = FindOldest();
+    if (oldest == m_textures.end())
+      return false;
+    releaseTime = oldest->first;
+    return true;
+  }
+
+  virtual size_t FreeLeastRecentlyUsed()
+  {
+    std::list< std::pair<unsigned int, size_t> >::iterator oldest = FindOldest();
+    if (oldest == m_textures.end())
+      return 0;
+    size_t size = oldest->second;
+    m_textures.erase(oldest);
+    CTextureBudget::GetInstance().Freed(size);
+    m_evicted.push_back(m_name);
+    return size;
+  }
+
+  virtual void GetMemoryUsage(size_t &used, size_t &unused)
+  {
+    used = unused = 0;
+    for (std::list< std::pair<unsigned int, size_t> >::iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+    {
+      used += it->second;
+      if (it->first)
+        unused += it->second;
+    }
+  }
+
+private:
+  std::list< std::pair<unsigned int, size_t> >::iterator FindOldest()
+  {
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    std::list< std::pair<unsigned int, size_t> >::iterator oldest = m_textures.end();
+    for (std::list< std::pair<unsigned int, size_t> >::iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+    {
+      if (it->first && (oldest == m_textures.end() || now - it->first > now - oldest->first))
+        oldest = it;
+    }
+    return oldest;
+  }
+
+  std::string m_name;
+  std::vector<std::string> &m_evicted;
+  std::list< std::pair<unsigned int, size_t> > m_textures;
+};
+
+}
+
+TEST(TestTextureBudget, EvictsLeastRecentlyUsedAcrossPools)
+{
+  CTextureBudget &budget = CTextureBudget::GetInstance();
+  size_t base = budget.GetUsage();
+
+  std::vector<std::string> evicted;
+  CTestPool skin("testskin", evicted), large("testlarge", evicted);
+  skin.Add(3000, MB);
+  skin.Add(1000, MB);
+  large.Add(2000, MB);
+  large.Add(0, MB / 2);
+  EXPECT_EQ(base + 3 * MB + MB / 2, budget.GetUsage());
+
+  EXPECT_TRUE(budget.Enforce(base + 2 * MB));
+  ASSERT_EQ(2U, evicted.size());
+  EXPECT_EQ("testskin", evicted[0]);
+  EXPECT_EQ("testlarge", evicted[1]);
+  EXPECT_EQ(base + MB + MB / 2, budget.GetUsage());
+
+  CTextureBudget::Stats stats;
+  budget.GetStats(stats);
+  EXPECT_GE(stats.peak, base + 3 * MB + MB / 2);
+  bool found = false;
+  for (std::vector<CTextureBudget::PoolStats>::const_iterator it = stats.pools.begin(); it != stats.pools.end(); ++it)
+  {
+    if (it->name == "testlarge")
+    {
+      EXPECT_EQ(MB / 2, it->used);
+      EXPECT_EQ(0U, it->unused);
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(TestTextureBudget, TexturesInUseAreKept)
+{
+  CTextureBudget &budget = CTextureBudget::GetInstance();
+  size_t base = budget.GetUsage();
+
+  std::vector<std::string> evicted;
+  CTestPool pool("testpool", evicted);
+  pool.Add(0, 2 * MB);
+  pool.Add(0, MB);
+
+  EXPECT_FALSE(budget.Enforce(base + MB));
+  EXPECT_TRUE(evicted.empty());
+  EXPECT_EQ(base + 3 * MB, budget.GetUsage());
+}
+
+TEST(TestTextureBudget, Unlimited)
+{
+  CTextureBudget &budget = CTextureBudget::GetInstance();
+
+  std::vector<std::string> evicted;
+  CTestPool pool("testpool", evicted);
+  pool.Add(1000, 4 * MB);
+
+  EXPECT_FALSE(budget.Enforce(0));
+  EXPECT_TRUE(evicted.empty());
+}
@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "guilib/XBTF.h"
+#include "utils/TimeUtils.h"
+
+#include <lzo/lzo1x.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// a skin-like BGRA texture: flat areas, gradients and some noise
+std::vector<uint8_t> CreateTexture(unsigned int width, unsigned int height)
+{
+  std::vector<uint8_t> pixels(width * height * 4);
+  uint32_t seed = 12345;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      uint8_t *p = &pixels[(y * width + x) * 4];
+      seed = seed * 1103515245 + 12345;
+      if (y < height / 3)
+        p[0] = p[1] = p[2] = 0x20;
+      else if (y < 2 * height / 3)
+      {
+        p[0] = x * 255 / width;
+        p[1] = y * 255 / height;
+        p[2] = 0x80;
+      }
+      else
+      {
+        p[0] = (seed >> 16) & 0xff;
+        p[1] = (seed >> 8) & 0xff;
+        p[2] = seed & 0x0f;
+      }
+      p[3] = x < 16 ? x * 16 : 0xff;
+    }
+  }
+  return pixels;
+}
+
+}
+
+TEST(TestXBTF, LZ4RoundTrip)
+{
+  std::vector<uint8_t> pixels = CreateTexture(256, 96);
+  std::vector<uint8_t> packed(CXBTFLZ4::CompressBound(pixels.size()));
+  size_t packedSize = CXBTFLZ4::Compress(pixels.data(), pixels.size(), packed.data(), packed.size());
+  ASSERT_GT(packedSize, 0U);
+  EXPECT_LT(packedSize, pixels.size());
+
+  std::vector<uint8_t> unpacked(pixels.size());
+  ASSERT_TRUE(CXBTFLZ4::Decompress(packed.data(), packedSize, unpacked.data(), unpacked.size()));
+  EXPECT_EQ(pixels, unpacked);
+
+  // tiny and incompressible inputs are stored as literals
+  const uint8_t small[] = { 1, 2, 3 };
+  uint8_t smallPacked[32], smallUnpacked[3];
+  packedSize = CXBTFLZ4::Compress(small, sizeof(small), smallPacked, sizeof(smallPacked));
+  ASSERT_GT(packedSize, 0U);
+  ASSERT_TRUE(CXBTFLZ4::Decompress(smallPacked, packedSize, smallUnpacked, sizeof(smallUnpacked)));
+  EXPECT_EQ(0, memcmp(small, smallUnpacked, sizeof(small)));
+}
+
+TEST(TestXBTF, LZ4RejectsCorruptData)
+{
+  std::vector<uint8_t> pixels = CreateTexture(64, 64);
+  std::vector<uint8_t> packed(CXBTFLZ4::CompressBound(pixels.size()));
+  size_t packedSize = CXBTFLZ4::Compress(pixels.data(), pixels.size(), packed.data(), packed.size());
+  ASSERT_GT(packedSize, 0U);
+
+  std::vector<uint8_t> unpacked(pixels.size());
+  EXPECT_FALSE(CXBTFLZ4::Decompress(packed.data(), packedSize - 1, unpacked.data(), unpacked.size()));
+  EXPECT_FALSE(CXBTFLZ4::Decompress(packed.data(), packedSize, unpacked.data(), unpacked.size() - 1));
+
+  // the first sequence can't reference data before the start of the output
+  const uint8_t badOffset[] = { 0x14, 'a', 0x10, 0x00, 0x00 };
+  uint8_t out[16];
+  EXPECT_FALSE(CXBTFLZ4::Decompress(badOffset, sizeof(badOffset), out, sizeof(out)));
+
+  // capacity too small to hold the output
+  EXPECT_EQ(0U, CXBTFLZ4::Compress(pixels.data(), pixels.size(), packed.data(), 16));
+}
+
+/* time taken to get the frames of a skin sized set of textures into memory, stored raw,
+ * packed with lzo as TexturePacker does by default and packed with lz4. Disabled by
+ * default, run it with --gtest_also_run_disabled_tests */
+TEST(TestXBTF, DISABLED_UnpackBenchmark)
+{
+  ASSERT_EQ(LZO_E_OK, lzo_init());
+
+  const unsigned int frames = 64;
+  std::vector<uint8_t> pixels = CreateTexture(512, 512);
+
+  std::vector<uint8_t> lzo(pixels.size() + pixels.size() / 16 + 64 + 3);
+  std::vector<uint8_t> working(LZO1X_999_MEM_COMPRESS);
+  lzo_uint lzoSize = lzo.size();
+  ASSERT_EQ(LZO_E_OK, lzo1x_999_compress(pixels.data(), pixels.size(), lzo.data(), &lzoSize, working.data()));
+
+  std::vector<uint8_t> lz4(CXBTFLZ4::CompressBound(pixels.size()));
+  size_t lz4Size = CXBTFLZ4::Compress(pixels.data(), pixels.size(), lz4.data(), lz4.size());
+  ASSERT_GT(lz4Size, 0U);
+
+  std::vector<uint8_t> unpacked(pixels.size());
+  double total = (double)frames * pixels.size() / (1024 * 1024);
+
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < frames; i++)
+    memcpy(unpacked.data(), pixels.data(), pixels.size());
+  double rawSeconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    lzo_uint size = unpacked.size();
+    ASSERT_EQ(LZO_E_OK, lzo1x_decompress_safe(lzo.data(), lzoSize, unpacked.data(), &size, NULL));
+  }
+  double lzoSeconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < frames; i++)
+    ASSERT_TRUE(CXBTFLZ4::Decompress(lz4.data(), lz4Size, unpacked.data(), unpacked.size()));
+  double lz4Seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+  EXPECT_EQ(pixels, unpacked);
+
+  printf("CXBTF: %u frames of %.1f MB, raw %.0f MB/s, lzo %.0f MB/s (%.0f%%), lz4 %.0f MB/s (%.0f%%)\n",
+         frames, total / frames,
+         rawSeconds > 0 ? total / rawSeconds : 0,
+         lzoSeconds > 0 ? total / lzoSeconds : 0, 100.0 * lzoSize / pixels.size(),
+         lz4Seconds > 0 ? total / lz4Seconds : 0, 100.0 * lz4Size / pixels.size());
+}
@@ -30,6 +30,7 @@
 #include "settings/Settings.h"
 #include "utils/Variant.h"
 #include "guilib/StereoscopicsManager.h"
+#include "guilib/TextureBudget.h"
 #include "windowing/WindowingFactory.h"
 
 using namespace JSONRPC;
@@ -152,6 +153,26 @@ JSONRPC_STATUS CGUIOperations::GetPropertyValue(const std::string &property, CVa
     result = g_application.IsFullScreen();
   else if (property == "stereoscopicmode")
     result = GetStereoModeObjectFromGuiMode( CStereoscopicsManager::GetInstance().GetStereoMode() );
+  else if (property == "texturememory")
+  {
+    CTextureBudget::Stats stats;
+    CTextureBudget::GetInstance().GetStats(stats);
+    result["budget"] = (uint64_t)stats.budget;
+    result["used"] = (uint64_t)stats.used;
+    result["peak"] = (uint64_t)stats.peak;
+    result["gpu"] = (uint64_t)stats.gpu;
+    result["evictions"] = stats.evictions;
+    result["evicted"] = (uint64_t)stats.evicted;
+    result["pools"] = CVariant(CVariant::VariantTypeArray);
+    for (std::vector<CTextureBudget::PoolStats>::const_iterator it = stats.pools.begin(); it != stats.pools.end(); ++it)
+    {
+      CVariant pool(CVariant::VariantTypeObject);
+      pool["name"] = it->name;
+      pool["used"] = (uint64_t)it->used;
+      pool["unused"] = (uint64_t)it->unused;
+      result["pools"].push_back(pool);
+    }
+  }
   else
     return InvalidParams;
 
@@ -259,6 +259,24 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetFramePacing(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  switch (GetPlayer(parameterObject["playerid"]))
+  {
+    case Video:
+      if (!g_application.m_pPlayer->GetFramePacing(result))
+        return FailedToExecute;
+      break;
+
+    case Audio:
+    case Picture:
+    default:
+      return FailedToExecute;
+  }
+
+  return OK;
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
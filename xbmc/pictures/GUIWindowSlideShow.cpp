@@ -46,6 +46,8 @@
 #include "interfaces/AnnouncementManager.h"
 #include "pictures/GUIViewStatePictures.h"
 #include "pictures/PictureThumbLoader.h"
+#include "pictures/SlideShowDecodeAhead.h"
+#include "settings/AdvancedSettings.h"
 #include "PlayListPlayer.h"
 #ifdef TARGET_POSIX
 #include "linux/XTimeUtils.h"
@@ -58,6 +60,8 @@
 #include "platform/darwin/DarwinUtils.h"
 #endif
 
+#include <algorithm>
+
 using namespace XFILE;
 using namespace KODI::MESSAGING;
 
@@ -88,6 +92,7 @@ CBackgroundPicLoader::CBackgroundPicLoader()
   , m_maxHeight{0}
   , m_isLoading{false}
   , m_pCallback{nullptr}
+  , m_pDecodeAhead{nullptr}
 {
 }
 
@@ -96,9 +101,10 @@ CBackgroundPicLoader::~CBackgroundPicLoader()
   StopThread();
 }
 
-void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
+void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback, CSlideShowDecodeAhead *pDecodeAhead)
 {
   m_pCallback = pCallback;
+  m_pDecodeAhead = pDecodeAhead;
   m_isLoading = false;
   CThread::Create(false);
 }
@@ -114,7 +120,11 @@ void CBackgroundPicLoader::Process()
       if (m_pCallback)
       {
         unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
+        CBaseTexture* texture = NULL;
+        if (m_pDecodeAhead)
+          texture = m_pDecodeAhead->Take(m_iSlideNumber, m_strFileName, m_maxWidth, m_maxHeight);
+        if (!texture)
+          texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
         totalTime += XbmcThreads::SystemClockMillis() - start;
         count++;
         // tell our parent
@@ -158,6 +168,7 @@ CGUIWindowSlideShow::CGUIWindowSlideShow(void)
     : CGUIDialog(WINDOW_SLIDESHOW, "SlideShow.xml")
 {
   m_pBackgroundLoader = NULL;
+  m_pDecodeAhead = NULL;
   m_Resolution = RES_INVALID;
   m_loadType = KEEP_IN_MEMORY;
   m_bLoadNextPic = false;
@@ -242,7 +253,10 @@ void CGUIWindowSlideShow::Reset()
   m_iCurrentPic = 0;
   m_iDirection = 1;
   m_iLastFailedNextSlide = -1;
+  m_bReloadImage = false;
   m_slides.clear();
+  if (m_pDecodeAhead)
+    m_pDecodeAhead->Clear();
   AnnouncePlaylistClear();
   m_Resolution = g_graphicsContext.GetVideoResolution();
 }
@@ -270,6 +284,8 @@ void CGUIWindowSlideShow::OnDeinitWindow(int nextWindowID)
       delete m_pBackgroundLoader;
       m_pBackgroundLoader = NULL;
     }
+    delete m_pDecodeAhead;
+    m_pDecodeAhead = NULL;
     // and close the images.
     m_Image[0].Close();
     m_Image[1].Close();
@@ -430,7 +446,9 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     {
       throw 1;
     }
-    m_pBackgroundLoader->Create(this);
+    if (g_advancedSettings.m_slideshowDecodeAhead && g_advancedSettings.m_slideshowDecodeAheadMemory)
+      m_pDecodeAhead = new CSlideShowDecodeAhead((size_t)g_advancedSettings.m_slideshowDecodeAheadMemory * 1024 * 1024);
+    m_pBackgroundLoader->Create(this, m_pDecodeAhead);
   }
 
   bool bSlideShow = m_bSlideShow && !m_bPause && !m_bPlayingVideo;
@@ -550,6 +568,30 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     }
   }
 
+  // pictures are loaded at display size with decode ahead, once zoomed in load the current one at full size
+  if (m_pDecodeAhead && m_fZoom > 1.0f && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[m_iCurrentPic].FullSize() &&
+      m_Image[m_iCurrentPic].SlideNumber() == m_iCurrentSlide && !m_pBackgroundLoader->IsLoading())
+  {
+    std::string picturePath = GetPicturePath(m_slides.at(m_iCurrentSlide).get());
+    if (!picturePath.empty())
+    {
+      CLog::Log(LOGDEBUG, "Loading the current image %d at full size: %s", m_iCurrentSlide, m_slides.at(m_iCurrentSlide)->GetPath().c_str());
+      int maxWidth, maxHeight;
+      GetCheckedSize((float)res.iWidth * m_fZoom,
+                     (float)res.iHeight * m_fZoom,
+                     maxWidth, maxHeight);
+      m_bReloadImage = true;
+      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, maxWidth, maxHeight);
+    }
+  }
+
+  // decode the pictures around the current one while it is shown, at the size they are shown at
+  if (m_pDecodeAhead && m_Image[m_iCurrentPic].IsLoaded())
+  {
+    int maxTextureSize = g_Windowing.GetMaxTextureSize();
+    UpdateDecodeAhead(std::min(res.iWidth, maxTextureSize), std::min(res.iHeight, maxTextureSize));
+  }
+
   if (m_slides.at(m_iCurrentSlide)->IsVideo() && bSlideShow)
   {
     if (!PlayVideo())
@@ -703,6 +745,52 @@ int CGUIWindowSlideShow::GetNextSlide()
   return m_iCurrentSlide;
 }
 
+void CGUIWindowSlideShow::UpdateDecodeAhead(int maxWidth, int maxHeight)
+{
+  // the slides in each direction in the order they are shown, skipping those that can't
+  // be shown and videos, which are played rather than decoded
+  std::vector<CSlideShowDecodeAhead::Slide> directions[2];
+  int size = m_slides.size();
+  for (int d = 0; d < 2; d++)
+  {
+    int step = (d == 0) == (m_iDirection >= 0) ? 1 : -1;
+    int slide = m_iCurrentSlide;
+    for (int i = 0; i < size && directions[d].size() < g_advancedSettings.m_slideshowDecodeAhead; i++)
+    {
+      slide = (slide + step + size) % size;
+      if (slide == m_iCurrentSlide)
+        break;
+      const CFileItemPtr &item = m_slides.at(slide);
+      if (item->IsVideo() || item->HasProperty("unplayable"))
+        continue;
+      // already loaded
+      if (m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() == slide)
+        continue;
+      // the background loader may not have taken its decoded picture yet
+      bool loading = m_pBackgroundLoader->IsLoading() && m_pBackgroundLoader->SlideNumber() == slide;
+      CSlideShowDecodeAhead::Slide ahead = { slide, GetPicturePath(item.get()), loading };
+      directions[d].push_back(ahead);
+    }
+  }
+
+  // nearest first, those in the current direction before those behind
+  std::vector<CSlideShowDecodeAhead::Slide> slides;
+  for (size_t i = 0; i < directions[0].size() || i < directions[1].size(); i++)
+  {
+    for (int d = 0; d < 2; d++)
+    {
+      if (i >= directions[d].size())
+        continue;
+      bool duplicate = false;
+      for (std::vector<CSlideShowDecodeAhead::Slide>::const_iterator it = slides.begin(); it != slides.end() && !duplicate; ++it)
+        duplicate = it->number == directions[d][i].number;
+      if (!duplicate)
+        slides.push_back(directions[d][i]);
+    }
+  }
+  m_pDecodeAhead->Update(slides, maxWidth, maxHeight);
+}
+
 EVENT_RESULT CGUIWindowSlideShow::OnMouseEvent(const CPoint &point, const CMouseEvent &event)
 {
   if (event.m_id == ACTION_GESTURE_NOTIFY)
@@ -1165,6 +1253,25 @@ CSlideShowPic::DISPLAY_EFFECT CGUIWindowSlideShow::GetDisplayEffect(int iSlideNu
 
 void CGUIWindowSlideShow::OnLoadPic(int iPic, int iSlideNumber, const std::string &strFileName, CBaseTexture* pTexture, bool bFullSize)
 {
+  if (m_bReloadImage)
+  { // the full size picture of the zoomed in slide
+    m_bReloadImage = false;
+    if (m_Image[iPic].IsLoaded() && m_Image[iPic].SlideNumber() == iSlideNumber)
+    {
+      if (pTexture)
+      {
+        CLog::Log(LOGDEBUG, "Finished loading slot %d, %d at full size: %s", iPic, iSlideNumber, strFileName.c_str());
+        m_Image[iPic].UpdateTexture(pTexture);
+        m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
+        return;
+      }
+      // keep the picture shown and don't try again
+      m_Image[iPic].SetOriginalSize(m_Image[iPic].GetOriginalWidth(), m_Image[iPic].GetOriginalHeight(), true);
+    }
+    delete pTexture;
+    return;
+  }
+
   if (pTexture)
   {
     // set the pic's texture + size etc.
@@ -1324,6 +1431,13 @@ void CGUIWindowSlideShow::GetCheckedSize(float width, float height, int &maxWidt
 {
   maxWidth = g_Windowing.GetMaxTextureSize();
   maxHeight = g_Windowing.GetMaxTextureSize();
+
+  // with decode ahead the pictures are loaded at the size they are shown at
+  if (m_pDecodeAhead && m_fZoom <= 1.0f)
+  {
+    maxWidth = std::min(maxWidth, (int)width);
+    maxHeight = std::min(maxHeight, (int)height);
+  }
 }
 
 std::string CGUIWindowSlideShow::GetPicturePath(CFileItem *item)
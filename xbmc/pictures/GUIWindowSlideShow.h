@@ -32,6 +32,7 @@ class CFileItemList;
 class CVariant;
 
 class CGUIWindowSlideShow;
+class CSlideShowDecodeAhead;
 
 class CBackgroundPicLoader : public CThread
 {
@@ -39,7 +40,7 @@ public:
   CBackgroundPicLoader();
   ~CBackgroundPicLoader();
 
-  void Create(CGUIWindowSlideShow *pCallback);
+  void Create(CGUIWindowSlideShow *pCallback, CSlideShowDecodeAhead *pDecodeAhead = NULL);
   void LoadPic(int iPic, int iSlideNumber, const std::string &strFileName, const int maxWidth, const int maxHeight);
   bool IsLoading() { return m_isLoading;};
   int SlideNumber() const { return m_iSlideNumber; }
@@ -57,6 +58,7 @@ private:
   bool m_isLoading;
 
   CGUIWindowSlideShow *m_pCallback;
+  CSlideShowDecodeAhead *m_pDecodeAhead;
 };
 
 class CGUIWindowSlideShow : public CGUIDialog
@@ -124,6 +126,7 @@ private:
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
   std::string GetPicturePath(CFileItem *item);
   int  GetNextSlide();
+  void UpdateDecodeAhead(int maxWidth, int maxHeight);
 
   void AnnouncePlayerPlay(const CFileItemPtr& item);
   void AnnouncePlayerPause(const CFileItemPtr& item);
@@ -156,8 +159,11 @@ private:
   int m_iCurrentPic;
   // background loader
   CBackgroundPicLoader* m_pBackgroundLoader;
+  // pictures decoded ahead around the current slide
+  CSlideShowDecodeAhead* m_pDecodeAhead;
   int m_iLastFailedNextSlide;
   bool m_bLoadNextPic;
+  bool m_bReloadImage;  ///< the current slide is being loaded again at full size
   RESOLUTION m_Resolution;
   CPoint m_firstGesturePoint;
 };
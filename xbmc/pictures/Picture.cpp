@@ -33,9 +33,14 @@
 #include "filesystem/File.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "guilib/DDSImage.h"
 #include "guilib/Texture.h"
 #include "guilib/imagefactory.h"
 #include "cores/FFmpeg.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #if defined(HAS_OMXPLAYER)
 #include "cores/omxplayer/OMXImage.h"
 #endif
@@ -44,8 +49,364 @@ extern "C" {
 #include "libswscale/swscale.h"
 }
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 using namespace XFILE;
 
+namespace
+{
+
+/* Setting up a swscale context computes the filter coefficients, which for the large images
+ * from cameras costs about as much as the scaling itself. Thumbnails and slideshows mostly
+ * scale between a handful of sizes, so contexts are kept for reuse. A context can only be
+ * used by one thread at a time and is taken out of the cache while scaling. */
+class CScalerCache
+{
+public:
+  struct Key
+  {
+    unsigned int in_width;
+    unsigned int in_height;
+    unsigned int out_width;
+    unsigned int out_height;
+    int flags;
+
+    bool operator==(const Key &right) const
+    {
+      return in_width == right.in_width && in_height == right.in_height &&
+             out_width == right.out_width && out_height == right.out_height && flags == right.flags;
+    }
+  };
+
+  ~CScalerCache()
+  {
+    for (std::vector< std::pair<Key, struct SwsContext*> >::iterator it = m_contexts.begin(); it != m_contexts.end(); ++it)
+      sws_freeContext(it->second);
+  }
+
+  struct SwsContext* Acquire(const Key &key)
+  {
+    {
+      CSingleLock lock(m_section);
+      for (std::vector< std::pair<Key, struct SwsContext*> >::reverse_iterator it = m_contexts.rbegin(); it != m_contexts.rend(); ++it)
+      {
+        if (it->first == key)
+        {
+          struct SwsContext *context = it->second;
+          m_contexts.erase(std::next(it).base());
+          return context;
+        }
+      }
+    }
+    return sws_getContext(key.in_width, key.in_height, AV_PIX_FMT_BGRA,
+                          key.out_width, key.out_height, AV_PIX_FMT_BGRA,
+                          key.flags, NULL, NULL, NULL);
+  }
+
+  void Release(const Key &key, struct SwsContext *context)
+  {
+    struct SwsContext *oldest = NULL;
+    {
+      CSingleLock lock(m_section);
+      if (m_contexts.size() >= MaxContexts)
+      {
+        oldest = m_contexts.front().second;
+        m_contexts.erase(m_contexts.begin());
+      }
+      m_contexts.push_back(std::make_pair(key, context));
+    }
+    sws_freeContext(oldest);
+  }
+
+private:
+  static const size_t MaxContexts = 8;
+
+  std::vector< std::pair<Key, struct SwsContext*> > m_contexts; ///< least recently used first
+  CCriticalSection m_section;
+};
+
+CScalerCache g_scalerCache;
+
+// reverses the pixels in [first, last), working inwards from both ends
+void ReversePixels(uint32_t *first, uint32_t *last)
+{
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  while (last - first >= 8)
+  {
+    last -= 4;
+    __m128i front = _mm_loadu_si128((const __m128i*)first);
+    __m128i back = _mm_loadu_si128((const __m128i*)last);
+    _mm_storeu_si128((__m128i*)first, _mm_shuffle_epi32(back, _MM_SHUFFLE(0, 1, 2, 3)));
+    _mm_storeu_si128((__m128i*)last, _mm_shuffle_epi32(front, _MM_SHUFFLE(0, 1, 2, 3)));
+    first += 4;
+  }
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  while (last - first >= 8)
+  {
+    last -= 4;
+    uint32x4_t front = vrev64q_u32(vld1q_u32(first));
+    uint32x4_t back = vrev64q_u32(vld1q_u32(last));
+    vst1q_u32(first, vcombine_u32(vget_high_u32(back), vget_low_u32(back)));
+    vst1q_u32(last, vcombine_u32(vget_high_u32(front), vget_low_u32(front)));
+    first += 4;
+  }
+#endif
+  std::reverse(first, last);
+}
+
+/* Writes the d_width x d_height image with dst(x, y) = src[start + x * colStep + y * rowStep],
+ * where rowStep is +-1 and colStep is +- the source width, ie. a transpose combined with flips.
+ * Reading a column of the source touches a new cache line per pixel, so the work is done in
+ * tiles that stay in cache, and 4x4 blocks are transposed in registers where possible. */
+void TransposeTiled(const uint32_t *src, ptrdiff_t start, ptrdiff_t rowStep, ptrdiff_t colStep,
+                    uint32_t *dst, unsigned int d_width, unsigned int d_height)
+{
+  static const unsigned int tile = 32;
+
+  for (unsigned int ty = 0; ty < d_height; ty += tile)
+  {
+    unsigned int ey = std::min(ty + tile, d_height);
+    for (unsigned int tx = 0; tx < d_width; tx += tile)
+    {
+      unsigned int ex = std::min(tx + tile, d_width);
+      unsigned int y = ty;
+#if defined(HAVE_SSE2) && defined(__SSE2__) || defined(__ARM_NEON__) || defined(__aarch64__)
+      // 4 consecutive rows of a destination column are 4 consecutive source pixels
+      ptrdiff_t load = rowStep > 0 ? 0 : -3;
+      for (; y + 4 <= ey; y += 4)
+      {
+        unsigned int x = tx;
+        for (; x + 4 <= ex; x += 4)
+        {
+          const uint32_t *column = src + start + (ptrdiff_t)x * colStep + (ptrdiff_t)y * rowStep + load;
+          uint32_t *out = dst + y * d_width + x;
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+          __m128i c0 = _mm_loadu_si128((const __m128i*)column);
+          __m128i c1 = _mm_loadu_si128((const __m128i*)(column + colStep));
+          __m128i c2 = _mm_loadu_si128((const __m128i*)(column + 2 * colStep));
+          __m128i c3 = _mm_loadu_si128((const __m128i*)(column + 3 * colStep));
+          if (rowStep < 0)
+          {
+            c0 = _mm_shuffle_epi32(c0, _MM_SHUFFLE(0, 1, 2, 3));
+            c1 = _mm_shuffle_epi32(c1, _MM_SHUFFLE(0, 1, 2, 3));
+            c2 = _mm_shuffle_epi32(c2, _MM_SHUFFLE(0, 1, 2, 3));
+            c3 = _mm_shuffle_epi32(c3, _MM_SHUFFLE(0, 1, 2, 3));
+          }
+          __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+          __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+          __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+          __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+          _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi64(t0, t1));
+          _mm_storeu_si128((__m128i*)(out + d_width), _mm_unpackhi_epi64(t0, t1));
+          _mm_storeu_si128((__m128i*)(out + 2 * d_width), _mm_unpacklo_epi64(t2, t3));
+          _mm_storeu_si128((__m128i*)(out + 3 * d_width), _mm_unpackhi_epi64(t2, t3));
+#else
+          uint32x4_t c0 = vld1q_u32(column);
+          uint32x4_t c1 = vld1q_u32(column + colStep);
+          uint32x4_t c2 = vld1q_u32(column + 2 * colStep);
+          uint32x4_t c3 = vld1q_u32(column + 3 * colStep);
+          if (rowStep < 0)
+          {
+            c0 = vrev64q_u32(vcombine_u32(vget_high_u32(c0), vget_low_u32(c0)));
+            c1 = vrev64q_u32(vcombine_u32(vget_high_u32(c1), vget_low_u32(c1)));
+            c2 = vrev64q_u32(vcombine_u32(vget_high_u32(c2), vget_low_u32(c2)));
+            c3 = vrev64q_u32(vcombine_u32(vget_high_u32(c3), vget_low_u32(c3)));
+          }
+          uint32x4x2_t t0 = vtrnq_u32(c0, c1);
+          uint32x4x2_t t1 = vtrnq_u32(c2, c3);
+          vst1q_u32(out, vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0])));
+          vst1q_u32(out + d_width, vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1])));
+          vst1q_u32(out + 2 * d_width, vcombine_u32(vget_high_u32(t0.val[0]), vget_high_u32(t1.val[0])));
+          vst1q_u32(out + 3 * d_width, vcombine_u32(vget_high_u32(t0.val[1]), vget_high_u32(t1.val[1])));
+#endif
+        }
+        for (; x < ex; x++)
+        {
+          for (unsigned int i = 0; i < 4; i++)
+            dst[(y + i) * d_width + x] = src[start + (ptrdiff_t)x * colStep + (ptrdiff_t)(y + i) * rowStep];
+        }
+      }
+#endif
+      for (; y < ey; y++)
+      {
+        uint32_t *out = dst + y * d_width;
+        const uint32_t *in = src + start + (ptrdiff_t)y * rowStep;
+        for (unsigned int x = tx; x < ex; x++)
+          out[x] = in[(ptrdiff_t)x * colStep];
+      }
+    }
+  }
+}
+
+class CTileLoader;
+
+// loads one tile of a tiled thumb on a job manager worker. The result is handed over when the job
+// is freed, which also happens to queued jobs cancelled or dropped by the job manager on shutdown
+class CTileLoadJob : public CJob
+{
+public:
+  CTileLoadJob(CTileLoader &loader, unsigned int index, const std::string &file, unsigned int width, unsigned int height)
+    : m_loader(loader), m_index(index), m_file(file), m_width(width), m_height(height), m_pixels(NULL)
+  {
+  }
+
+  virtual ~CTileLoadJob();
+
+  virtual bool DoWork() override;
+
+  virtual const char* GetType() const override
+  {
+    return kJobTypeCacheImage;
+  }
+
+private:
+  CTileLoader &m_loader;
+  unsigned int m_index;
+  std::string m_file;
+  unsigned int m_width;
+  unsigned int m_height;
+  uint32_t *m_pixels;
+};
+
+class CTileLoader
+{
+public:
+  struct Tile
+  {
+    unsigned int width;
+    unsigned int height;
+    uint32_t *pixels;
+    unsigned int jobID;
+    bool started;
+    bool finished;
+    bool taken;
+  };
+
+  explicit CTileLoader(size_t count) : m_pending(0)
+  {
+    Tile empty = { 0, 0, NULL, 0, false, false, false };
+    m_tiles.resize(count, empty);
+  }
+
+  ~CTileLoader()
+  {
+    Wait();
+    for (std::vector<Tile>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+      delete[] it->pixels;
+  }
+
+  void Queue(unsigned int index, const std::string &file, unsigned int width, unsigned int height)
+  {
+    {
+      CSingleLock lock(m_section);
+      m_pending++;
+    }
+    unsigned int jobID = CJobManager::GetInstance().AddJob(new CTileLoadJob(*this, index, file, width, height), NULL, CJob::PRIORITY_NORMAL);
+    if (!jobID)
+    { // the job manager is shutting down and has freed the job already
+      CLog::Log(LOGDEBUG, "CPicture::%s - unable to queue %s", __FUNCTION__, CURL::GetRedacted(file).c_str());
+      return;
+    }
+    CSingleLock lock(m_section);
+    m_tiles[index].jobID = jobID;
+  }
+
+  void Load(unsigned int index, const std::string &file, unsigned int width, unsigned int height)
+  {
+    uint32_t *pixels = CPicture::LoadTile(file, width, height);
+    CSingleLock lock(m_section);
+    Set(m_tiles[index], pixels, width, height);
+  }
+
+  /*! \brief Take a tile back from a job no worker has started yet
+   The job is cancelled and the tile is loaded in this thread, as waiting for a busy worker would
+   take longer. Tiles already loading or loaded are left alone.
+   */
+  void TakeBack(unsigned int index, const std::string &file, unsigned int width, unsigned int height)
+  {
+    unsigned int jobID;
+    {
+      CSingleLock lock(m_section);
+      Tile &tile = m_tiles[index];
+      if (!tile.jobID || tile.started || tile.finished)
+        return;
+      tile.taken = true;
+      jobID = tile.jobID;
+    }
+    // the queued job is freed right away, one that got to a worker meanwhile bails out in Start()
+    CJobManager::GetInstance().CancelJob(jobID);
+    Load(index, file, width, height);
+  }
+
+  bool Start(unsigned int index)
+  {
+    CSingleLock lock(m_section);
+    Tile &tile = m_tiles[index];
+    if (tile.taken)
+      return false;
+    tile.started = true;
+    return true;
+  }
+
+  void Finished(unsigned int index, uint32_t *pixels, unsigned int width, unsigned int height)
+  {
+    CSingleLock lock(m_section);
+    Tile &tile = m_tiles[index];
+    tile.finished = true;
+    if (tile.taken)
+      delete[] pixels;
+    else
+      Set(tile, pixels, width, height);
+    if (m_pending && !--m_pending)
+      m_done.Set();
+  }
+
+  void Wait()
+  {
+    CSingleLock lock(m_section);
+    while (m_pending)
+    {
+      CSingleExit exit(m_section);
+      m_done.Wait();
+    }
+  }
+
+  const Tile &GetTile(unsigned int index) const { return m_tiles[index]; }
+
+private:
+  static void Set(Tile &tile, uint32_t *pixels, unsigned int width, unsigned int height)
+  {
+    tile.width = width;
+    tile.height = height;
+    tile.pixels = pixels;
+  }
+
+  std::vector<Tile> m_tiles;
+  unsigned int m_pending;
+  CCriticalSection m_section;
+  CEvent m_done;
+};
+
+CTileLoadJob::~CTileLoadJob()
+{
+  m_loader.Finished(m_index, m_pixels, m_width, m_height);
+}
+
+bool CTileLoadJob::DoWork()
+{
+  if (!m_loader.Start(m_index))
+    return false;
+  m_pixels = CPicture::LoadTile(m_file, m_width, m_height);
+  return m_pixels != NULL;
+}
+
+}
+
 bool CPicture::GetThumbnailFromSurface(const unsigned char* buffer, int width, int height, int stride, const std::string &thumbFile, uint8_t* &result, size_t& result_size)
 {
   unsigned char *thumb = NULL;
@@ -74,6 +435,14 @@ bool CPicture::GetThumbnailFromSurface(const unsigned char* buffer, int width, i
 bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width, int height, int stride, const std::string &thumbFile)
 {
   CLog::Log(LOGDEBUG, "cached image '%s' size %dx%d", CURL::GetRedacted(thumbFile).c_str(), width, height);
+  if (URIUtils::HasExtension(thumbFile, ".dds"))
+  { // raw pixels, LZ4 packed, loaded without image decoding
+    CDDSImage image;
+    if (image.Create(width, height, stride, buffer) && image.WriteFile(thumbFile, true))
+      return true;
+    CLog::Log(LOGERROR, "Failed to CreateThumbnailFromSurface for %s", CURL::GetRedacted(thumbFile).c_str());
+    return false;
+  }
   if (URIUtils::HasExtension(thumbFile, ".jpg"))
   {
 #if defined(HAS_OMXPLAYER)
@@ -215,6 +584,24 @@ bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, ui
   uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
   CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
 {
+  uint32_t *buffer = NULL;
+  if (!PrepareCacheTexture(pixels, width, height, pitch, orientation, dest_width, dest_height, buffer, scalingAlgorithm))
+    return false;
+
+  if (!buffer) // no resize or orientation needed
+    return CreateThumbnailFromSurface(pixels, width, height, pitch, dest);
+
+  bool success = CreateThumbnailFromSurface((unsigned char*)buffer, dest_width, dest_height, dest_width * 4, dest);
+  delete[] buffer;
+  return success;
+}
+
+bool CPicture::PrepareCacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pitch, int orientation,
+  uint32_t &dest_width, uint32_t &dest_height, uint32_t* &buffer,
+  CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
+{
+  buffer = NULL;
+
   // if no max width or height is specified, don't resize
   if (dest_width == 0)
     dest_width = width;
@@ -238,36 +625,54 @@ bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, ui
 
   if (width > dest_width || height > dest_height || orientation)
   {
-    bool success = false;
-
     dest_width = std::min(width, dest_width);
     dest_height = std::min(height, dest_height);
 
     // create a buffer large enough for the resulting image
     GetScale(width, height, dest_width, dest_height);
-    uint32_t *buffer = new uint32_t[dest_width * dest_height];
-    if (buffer)
+    uint32_t *scaled = new uint32_t[dest_width * dest_height];
+    if (ScaleImage(pixels, width, height, pitch,
+                   (uint8_t *)scaled, dest_width, dest_height, dest_width * 4,
+                   scalingAlgorithm))
     {
-      if (ScaleImage(pixels, width, height, pitch,
-                     (uint8_t *)buffer, dest_width, dest_height, dest_width * 4,
-                     scalingAlgorithm))
+      if (!orientation || OrientateImage(scaled, dest_width, dest_height, orientation))
       {
-        if (!orientation || OrientateImage(buffer, dest_width, dest_height, orientation))
-        {
-          success = CreateThumbnailFromSurface((unsigned char*)buffer, dest_width, dest_height, dest_width * 4, dest);
-        }
+        buffer = scaled;
+        return true;
       }
-      delete[] buffer;
     }
-    return success;
+    delete[] scaled;
+    return false;
   }
-  else
-  { // no orientation needed
-    dest_width = width;
-    dest_height = height;
-    return CreateThumbnailFromSurface(pixels, width, height, pitch, dest);
+
+  // no orientation needed
+  dest_width = width;
+  dest_height = height;
+  return true;
+}
+
+uint32_t *CPicture::LoadTile(const std::string &file, unsigned int &width, unsigned int &height)
+{
+  CBaseTexture *texture = CTexture::LoadFromFile(file, width, height, true);
+  if (!texture || !texture->GetWidth() || !texture->GetHeight())
+  {
+    delete texture;
+    return NULL;
   }
-  return false;
+
+  GetScale(texture->GetWidth(), texture->GetHeight(), width, height);
+
+  // scale appropriately
+  uint32_t *scaled = new uint32_t[width * height];
+  if (!ScaleImage(texture->GetPixels(), texture->GetWidth(), texture->GetHeight(), texture->GetPitch(),
+                  (uint8_t *)scaled, width, height, width * 4) ||
+      (texture->GetOrientation() && !OrientateImage(scaled, width, height, texture->GetOrientation())))
+  {
+    delete[] scaled;
+    scaled = NULL;
+  }
+  delete texture;
+  return scaled;
 }
 
 bool CPicture::CreateTiledThumb(const std::vector<std::string> &files, const std::string &thumb)
@@ -283,43 +688,38 @@ bool CPicture::CreateTiledThumb(const std::vector<std::string> &files, const std
   unsigned int tile_gap = 1;
   bool success = false;
 
+  // load the tiles concurrently, the first one in this thread while the others are queued for
+  // job manager workers. Tiles no worker got to by then are taken back and loaded here too
+  CTileLoader loader(files.size());
+  for (unsigned int i = 1; i < files.size(); ++i)
+    loader.Queue(i, files[i], tile_width - 2*tile_gap, tile_height - 2*tile_gap);
+  loader.Load(0, files[0], tile_width - 2*tile_gap, tile_height - 2*tile_gap);
+  for (unsigned int i = 1; i < files.size(); ++i)
+    loader.TakeBack(i, files[i], tile_width - 2*tile_gap, tile_height - 2*tile_gap);
+  loader.Wait();
+
   // create a buffer for the resulting thumb
   uint32_t *buffer = (uint32_t *)calloc(g_advancedSettings.m_imageRes * g_advancedSettings.m_imageRes, 4);
   for (unsigned int i = 0; i < files.size(); ++i)
   {
+    const CTileLoader::Tile &tile = loader.GetTile(i);
+    if (!tile.pixels)
+      continue;
+
+    success = true; // Flag that we at least had one succesfull image processed
+    // drop into the texture
     int x = i % num_across;
     int y = i / num_across;
-    // load in the image
-    unsigned int width = tile_width - 2*tile_gap, height = tile_height - 2*tile_gap;
-    CBaseTexture *texture = CTexture::LoadFromFile(files[i], width, height, true);
-    if (texture && texture->GetWidth() && texture->GetHeight())
+    unsigned int posX = x*tile_width + (tile_width - tile.width)/2;
+    unsigned int posY = y*tile_height + (tile_height - tile.height)/2;
+    uint32_t *dest = buffer + posX + posY*g_advancedSettings.m_imageRes;
+    const uint32_t *src = tile.pixels;
+    for (unsigned int y = 0; y < tile.height; ++y)
     {
-      GetScale(texture->GetWidth(), texture->GetHeight(), width, height);
-
-      // scale appropriately
-      uint32_t *scaled = new uint32_t[width * height];
-      if (ScaleImage(texture->GetPixels(), texture->GetWidth(), texture->GetHeight(), texture->GetPitch(),
-                     (uint8_t *)scaled, width, height, width * 4))
-      {
-        if (!texture->GetOrientation() || OrientateImage(scaled, width, height, texture->GetOrientation()))
-        {
-          success = true; // Flag that we at least had one succesfull image processed
-          // drop into the texture
-          unsigned int posX = x*tile_width + (tile_width - width)/2;
-          unsigned int posY = y*tile_height + (tile_height - height)/2;
-          uint32_t *dest = buffer + posX + posY*g_advancedSettings.m_imageRes;
-          uint32_t *src = scaled;
-          for (unsigned int y = 0; y < height; ++y)
-          {
-            memcpy(dest, src, width*4);
-            dest += g_advancedSettings.m_imageRes;
-            src += width;
-          }
-        }
-      }
-      delete[] scaled;
+      memcpy(dest, src, tile.width*4);
+      dest += g_advancedSettings.m_imageRes;
+      src += tile.width;
     }
-    delete texture;
   }
   // now save to a file
   if (success)
@@ -343,9 +743,16 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch,
                           CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
 {
-  struct SwsContext *context = sws_getContext(in_width, in_height, AV_PIX_FMT_BGRA,
-                                                         out_width, out_height, AV_PIX_FMT_BGRA,
-                                                         CPictureScalingAlgorithm::ToSwscale(scalingAlgorithm), NULL, NULL, NULL);
+  // images that only need orientating don't need to go through swscale
+  if (in_width == out_width && in_height == out_height)
+  {
+    for (unsigned int y = 0; y < in_height; y++)
+      memcpy(out_pixels + y * out_pitch, in_pixels + y * in_pitch, in_width * 4);
+    return true;
+  }
+
+  CScalerCache::Key key = { in_width, in_height, out_width, out_height, CPictureScalingAlgorithm::ToSwscale(scalingAlgorithm) };
+  struct SwsContext *context = g_scalerCache.Acquire(key);
 
   uint8_t *src[] = { in_pixels, 0, 0, 0 };
   int     srcStride[] = { (int)in_pitch, 0, 0, 0 };
@@ -355,7 +762,7 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
   if (context)
   {
     sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
-    sws_freeContext(context);
+    g_scalerCache.Release(key, context);
     return true;
   }
   return false;
@@ -363,7 +770,6 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
 
 bool CPicture::OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, int orientation)
 {
-  // ideas for speeding these functions up: http://cgit.freedesktop.org/pixman/tree/pixman/pixman-fast-path.c
   bool out = false;
   switch (orientation)
   {
@@ -401,8 +807,7 @@ bool CPicture::FlipHorizontal(uint32_t *&pixels, unsigned int &width, unsigned i
   for (unsigned int y = 0; y < height; ++y)
   {
     uint32_t *line = pixels + y * width;
-    for (unsigned int x = 0; x < width / 2; ++x)
-      std::swap(line[x], line[width - 1 - x]);
+    ReversePixels(line, line + width);
   }
   return true;
 }
@@ -414,72 +819,41 @@ bool CPicture::FlipVertical(uint32_t *&pixels, unsigned int &width, unsigned int
   {
     uint32_t *line1 = pixels + y * width;
     uint32_t *line2 = pixels + (height - 1 - y) * width;
-    for (unsigned int x = 0; x < width; ++x)
-      std::swap(*line1++, *line2++);
+    std::swap_ranges(line1, line1 + width, line2);
   }
   return true;
 }
 
 bool CPicture::Rotate180CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  // this can be done in-place easily enough
-  for (unsigned int y = 0; y < height / 2; ++y)
-  {
-    uint32_t *line1 = pixels + y * width;
-    uint32_t *line2 = pixels + (height - 1 - y) * width + width - 1;
-    for (unsigned int x = 0; x < width; ++x)
-      std::swap(*line1++, *line2--);
-  }
-  if (height % 2)
-  { // height is odd, so flip the middle row as well
-    uint32_t *line = pixels + (height - 1)/2 * width;
-    for (unsigned int x = 0; x < width / 2; ++x)
-      std::swap(line[x], line[width - 1 - x]);
-  }
+  // rotating by 180 degrees reverses the order of all pixels
+  ReversePixels(pixels, pixels + width * height);
   return true;
 }
 
 bool CPicture::Rotate90CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (dest)
-  {
-    unsigned int d_height = width, d_width = height;
-    for (unsigned int y = 0; y < d_height; y++)
-    {
-      const uint32_t *src = pixels + (d_height - 1 - y); // y-th col from right, starting at top
-      uint32_t *dst = dest + d_width * y;                // y-th row from top, starting at left
-      for (unsigned int x = 0; x < d_width; x++)
-      {
-        *dst++ = *src;
-        src += width;
-      }
-    }
-    delete[] pixels;
-    pixels = dest;
-    std::swap(width, height);
-    return true;
-  }
-  return false;
+  uint32_t *dest = new uint32_t[width * height];
+  if (!dest)
+    return false;
+
+  // y-th row from top is the y-th col from right, starting at top
+  TransposeTiled(pixels, width - 1, -1, width, dest, height, width);
+
+  delete[] pixels;
+  pixels = dest;
+  std::swap(width, height);
+  return true;
 }
 
 bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
+  uint32_t *dest = new uint32_t[width * height];
   if (!dest)
     return false;
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + y; // y-th col from left, starting at bottom
-    uint32_t *dst = dest + d_width * y;                       // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
+  // y-th row from top is the y-th col from left, starting at bottom
+  TransposeTiled(pixels, (ptrdiff_t)width * (height - 1), 1, -(ptrdiff_t)width, dest, height, width);
 
   delete[] pixels;
   pixels = dest;
@@ -489,21 +863,12 @@ bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int
 
 bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
+  uint32_t *dest = new uint32_t[width * height];
   if (!dest)
     return false;
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + y;   // y-th col from left, starting at top
-    uint32_t *dst = dest + d_width * y; // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src += width;
-    }
-  }
+  // y-th row from top is the y-th col from left, starting at top
+  TransposeTiled(pixels, 0, 1, width, dest, height, width);
 
   delete[] pixels;
   pixels = dest;
@@ -513,21 +878,12 @@ bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &h
 
 bool CPicture::TransposeOffAxis(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
+  uint32_t *dest = new uint32_t[width * height];
   if (!dest)
     return false;
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + (d_height - 1 - y); // y-th col from right, starting at bottom
-    uint32_t *dst = dest + d_width * y;                                        // y-th row, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
+  // y-th row from top is the y-th col from right, starting at bottom
+  TransposeTiled(pixels, (ptrdiff_t)width * (height - 1) + width - 1, -1, -(ptrdiff_t)width, dest, height, width);
 
   delete[] pixels;
   pixels = dest;
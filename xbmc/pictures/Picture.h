@@ -34,11 +34,21 @@ public:
   static bool CreateThumbnailFromSurface(const unsigned char* buffer, int width, int height, int stride, const std::string &thumbFile);
 
   /*! \brief Create a tiled thumb of the given files
+   The tiles are loaded concurrently on job manager workers.
    \param files the files to create the thumb from
    \param thumb the filename of the thumb
    */
   static bool CreateTiledThumb(const std::vector<std::string> &files, const std::string &thumb);
 
+  /*! \brief Load an image as a tile of a tiled thumb
+   The image is decoded at a reduced size where possible, scaled to fit and orientated.
+   \param file the image to load
+   \param width [in/out] maximum width of the tile - replaced with the actual width
+   \param height [in/out] maximum height of the tile - replaced with the actual height
+   \return the pixels with a pitch of width * 4, to be freed with delete[]. NULL on failure.
+   */
+  static uint32_t *LoadTile(const std::string &file, unsigned int &width, unsigned int &height);
+
   static bool ResizeTexture(const std::string &image, CBaseTexture *texture,
     uint32_t &dest_width, uint32_t &dest_height, uint8_t* &result, size_t& result_size,
     CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
@@ -59,11 +69,38 @@ public:
     uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
     CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
 
+  /*! \brief Resize, rotate and flip pixels as needed for caching, without saving them
+   Split out of CacheTexture so that the CPU bound part can run separately from the encode.
+   \param dest_width [in/out] maximum width in pixels of cached version - replaced with actual cached width
+   \param dest_height [in/out] maximum height in pixels of cached version - replaced with actual cached height
+   \param buffer [out] the resulting pixels with a pitch of dest_width * 4, to be freed with delete[].
+                  NULL if the source pixels may be cached as they are.
+   \return true if successful, false otherwise
+   */
+  static bool PrepareCacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pitch, int orientation,
+    uint32_t &dest_width, uint32_t &dest_height, uint32_t* &buffer,
+    CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
+
 private:
+  friend class TestPicture;
+
   static void GetScale(unsigned int width, unsigned int height, unsigned int &out_width, unsigned int &out_height);
+
+  /*! \brief Scale BGRA pixels
+   swscale contexts are reused between calls with the same dimensions and algorithm.
+   \return true if successful, false otherwise
+   */
   static bool ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
                          uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch,
                          CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
+
+  /*! \brief Rotate and flip pixels with a pitch of width * 4 according to the EXIF orientation
+   \param pixels [in/out] the pixels, allocated with new[]. May be replaced by a new buffer.
+   \param width [in/out] width of the image, swapped with height by rotations
+   \param height [in/out] height of the image, swapped with width by rotations
+   \param orientation the EXIF orientation - 1
+   \return true if successful, false otherwise
+   */
   static bool OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, int orientation);
 
   static bool FlipHorizontal(uint32_t *&pixels, unsigned int &width, unsigned int &height);
@@ -18,15 +18,21 @@
  *
  */
 
+#include <algorithm>
+#include <random>
+
 #include "PictureThumbLoader.h"
 #include "Picture.h"
 #include "filesystem/File.h"
 #include "FileItem.h"
 #include "TextureCache.h"
+#include "TextureCacheJob.h"
 #include "filesystem/Directory.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "guilib/GUIWindowManager.h"
 #include "GUIUserMessages.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -67,7 +73,9 @@ bool CPictureThumbLoader::LoadItemCached(CFileItem* pItem)
 
   if (pItem->HasArt("thumb") && m_regenerateThumbs)
   {
-    CTextureCache::GetInstance().ClearCachedImage(pItem->GetArt("thumb"));
+    // tiled folder thumbs are kept, they're only recreated if their images changed
+    if (CURL(pItem->GetArt("thumb")).GetUserName() != "picturefolder")
+      CTextureCache::GetInstance().ClearCachedImage(pItem->GetArt("thumb"));
     if (m_textureDatabase->Open())
     {
       m_textureDatabase->ClearTextureForPath(pItem->GetPath(), "thumb");
@@ -131,6 +139,17 @@ void CPictureThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob*
   CJobQueue::OnJobComplete(jobID, success, job);
 }
 
+std::string CPictureThumbLoader::GetTiledThumbHash(const std::vector<std::string> &files)
+{
+  Crc32 crc;
+  for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+  {
+    std::string file = *it + "|" + CTextureCacheJob::GetImageHash(*it) + "|";
+    crc.Compute(file.c_str(), file.size());
+  }
+  return StringUtils::Format("t%08x", (uint32_t)crc);
+}
+
 void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
 {
   if (pItem->HasArt("thumb"))
@@ -217,9 +236,6 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
         return; // no images in this folder
       }
 
-      // randomize them
-      items.Randomize();
-
       if (items.Size() < 4 || pItem->IsCBR() || pItem->IsCBZ())
       { // less than 4 items, so just grab the first thumb
         items.Sort(SortByLabel, SortOrderAscending);
@@ -230,22 +246,41 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
       }
       else
       {
-        // ok, now we've got the files to get the thumbs from, lets create it...
-        // we basically load the 4 images and combine them
+        // pick 4 random images, seeded by the folder so that the same images are picked
+        // as long as its contents don't change
         std::vector<std::string> files;
-        for (int thumb = 0; thumb < 4; thumb++)
-          files.push_back(items[thumb]->GetPath());
+        for (int i = 0; i < items.Size(); i++)
+          files.push_back(items[i]->GetPath());
+        std::sort(files.begin(), files.end());
+        std::mt19937 mt(Crc32::ComputeFromLowerCase(pItem->GetPath()));
+        std::shuffle(files.begin(), files.end(), mt);
+        files.resize(4);
+
         std::string thumb = CTextureUtils::GetWrappedImageURL(pItem->GetPath(), "picturefolder");
-        std::string relativeCacheFile = CTextureCache::GetCacheFile(thumb) + ".png";
-        if (CPicture::CreateTiledThumb(files, CTextureCache::GetCachedPath(relativeCacheFile)))
-        {
-          CTextureDetails details;
-          details.file = relativeCacheFile;
-          details.width = g_advancedSettings.m_imageRes;
-          details.height = g_advancedSettings.m_imageRes;
-          CTextureCache::GetInstance().AddCachedTexture(thumb, details);
+        std::string hash = GetTiledThumbHash(files);
+        CTextureDetails details;
+        if (db.GetCachedTexture(thumb, details) && details.hash == hash &&
+            CFile::Exists(CTextureCache::GetCachedPath(details.file)))
+        { // the images haven't changed since the thumb was created
           db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
-          pItem->SetArt("thumb", CTextureCache::GetCachedPath(relativeCacheFile));
+          pItem->SetArt("thumb", CTextureCache::GetCachedPath(details.file));
+        }
+        else
+        {
+          // ok, now we've got the files to get the thumbs from, lets create it...
+          // we basically load the 4 images and combine them
+          std::string relativeCacheFile = CTextureCache::GetCacheFile(thumb) + ".png";
+          if (CPicture::CreateTiledThumb(files, CTextureCache::GetCachedPath(relativeCacheFile)))
+          {
+            CTextureDetails tiledDetails;
+            tiledDetails.file = relativeCacheFile;
+            tiledDetails.hash = hash;
+            tiledDetails.width = g_advancedSettings.m_imageRes;
+            tiledDetails.height = g_advancedSettings.m_imageRes;
+            CTextureCache::GetInstance().AddCachedTexture(thumb, tiledDetails);
+            db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
+            pItem->SetArt("thumb", CTextureCache::GetCachedPath(relativeCacheFile));
+          }
         }
       }
     }
@@ -19,6 +19,9 @@
  *
  */
 
+#include <string>
+#include <vector>
+
 #include "utils/JobManager.h"
 #include "ThumbLoader.h"
 
@@ -46,6 +49,12 @@ public:
 protected:
   virtual void OnLoaderFinish();
 
+  /*! \brief Hash of the images of a tiled folder thumb
+   Combines the paths with the size and modification time of each image, so that a cached
+   tiled thumb can be reused as long as it would be created from the same unchanged images.
+   */
+  static std::string GetTiledThumbHash(const std::vector<std::string> &files);
+
 private:
   bool m_regenerateThumbs;
 };
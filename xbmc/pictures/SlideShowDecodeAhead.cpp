@@ -0,0 +1,277 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SlideShowDecodeAhead.h"
+#include "guilib/Texture.h"
+#include "threads/SingleLock.h"
+#include "URL.h"
+#include "utils/log.h"
+
+#include <atomic>
+
+class CSlideShowDecodeJob : public CJob
+{
+public:
+  CSlideShowDecodeJob(const std::string &path, int maxWidth, int maxHeight)
+    : m_path(path), m_maxWidth(maxWidth), m_maxHeight(maxHeight), m_started(false), m_texture(NULL)
+  {
+  }
+
+  virtual ~CSlideShowDecodeJob()
+  {
+    delete m_texture;
+  }
+
+  virtual bool DoWork() override
+  {
+    m_started = true;
+    m_texture = CTexture::LoadFromFile(m_path, m_maxWidth, m_maxHeight);
+    return m_texture != NULL;
+  }
+
+  bool IsStarted() const { return m_started; }
+
+  CBaseTexture *TakeTexture()
+  {
+    CBaseTexture *texture = m_texture;
+    m_texture = NULL;
+    return texture;
+  }
+
+private:
+  std::string m_path;
+  int m_maxWidth;
+  int m_maxHeight;
+  std::atomic<bool> m_started;
+  CBaseTexture *m_texture;
+};
+
+CSlideShowDecodeAhead::CSlideShowDecodeAhead(size_t memory) :
+  CJobQueue(false, 2, CJob::PRIORITY_LOW),
+  m_memory(memory),
+  m_maxWidth(0),
+  m_maxHeight(0),
+  m_decoded(0),
+  m_estimate(0),
+  m_hits(0),
+  m_misses(0)
+{
+}
+
+CSlideShowDecodeAhead::~CSlideShowDecodeAhead()
+{
+  // running decodes finish without calling back and free their picture themselves
+  CancelJobs();
+  Clear();
+  if (m_hits || m_misses)
+    CLog::Log(LOGDEBUG, "CSlideShowDecodeAhead::%s - %u pictures decoded ahead, %u loaded directly",
+              __FUNCTION__, m_hits, m_misses);
+}
+
+void CSlideShowDecodeAhead::Update(const std::vector<Slide> &slides, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_section);
+  if (maxWidth != m_maxWidth || maxHeight != m_maxHeight)
+  {
+    Clear();
+    m_maxWidth = maxWidth;
+    m_maxHeight = maxHeight;
+  }
+
+  // once the window moves the memory is shared out again
+  bool moved = slides.size() != m_wanted.size();
+  for (size_t i = 0; i < slides.size() && !moved; i++)
+    moved = slides[i].number != m_wanted[i].number || slides[i].path != m_wanted[i].path;
+  if (moved)
+  {
+    m_wanted = slides;
+    m_dropped.clear();
+  }
+
+  // drop the pictures of slides no longer wanted
+  for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end();)
+  {
+    bool wanted = false;
+    for (std::vector<Slide>::const_iterator slide = slides.begin(); slide != slides.end() && !wanted; ++slide)
+      wanted = slide->number == it->number && slide->path == it->path;
+    if (wanted)
+      ++it;
+    else
+    {
+      Drop(it);
+      it = m_entries.begin();
+    }
+  }
+
+  // until a picture is decoded assume it fills the whole size
+  size_t estimate = m_estimate ? m_estimate : (size_t)m_maxWidth * m_maxHeight * 4;
+  size_t planned = m_decoded;
+  for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->job)
+      planned += estimate;
+  }
+
+  // queue the nearest missing slides that fit, the nearest one always does
+  for (std::vector<Slide>::const_iterator slide = slides.begin(); slide != slides.end(); ++slide)
+  {
+    if (slide->loading || IsDropped(*slide) || Find(slide->number, slide->path) != m_entries.end())
+      continue;
+    if (planned && planned + estimate > m_memory)
+      break;
+
+    Entry entry;
+    entry.number = slide->number;
+    entry.path = slide->path;
+    entry.job = new CSlideShowDecodeJob(slide->path, m_maxWidth, m_maxHeight);
+    entry.texture = NULL;
+    entry.memory = 0;
+    m_entries.push_back(entry);
+    AddJob(entry.job);
+    planned += estimate;
+  }
+
+  // pictures larger than estimated may exceed the cap, drop the farthest ones
+  for (std::vector<Slide>::const_reverse_iterator slide = slides.rbegin(); slide != slides.rend() && m_decoded > m_memory; ++slide)
+  {
+    std::vector<Entry>::iterator it = Find(slide->number, slide->path);
+    if (it != m_entries.end() && it->texture)
+    {
+      Drop(it);
+      m_dropped.push_back(*slide);
+    }
+  }
+}
+
+CBaseTexture *CSlideShowDecodeAhead::Take(int number, const std::string &path, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_section);
+  while (true)
+  {
+    std::vector<Entry>::iterator it = Find(number, path);
+    if (it == m_entries.end() || maxWidth != m_maxWidth || maxHeight != m_maxHeight)
+    {
+      m_misses++;
+      return NULL;
+    }
+
+    if (!it->job)
+    { // decoded, or failed in which case the caller retries and reports the error
+      CBaseTexture *texture = it->texture;
+      m_decoded -= it->memory;
+      it->texture = NULL;
+      Drop(it);
+      if (texture)
+        m_hits++;
+      else
+        m_misses++;
+      return texture;
+    }
+
+    if (!it->job->IsStarted())
+    { // still queued, loading it directly is quicker than waiting for a worker
+      Drop(it);
+      m_misses++;
+      return NULL;
+    }
+
+    CSingleExit exit(m_section);
+    m_decodedEvent.Wait();
+  }
+}
+
+void CSlideShowDecodeAhead::Clear()
+{
+  CSingleLock lock(m_section);
+  while (!m_entries.empty())
+    Drop(m_entries.begin());
+  m_wanted.clear();
+  m_dropped.clear();
+}
+
+unsigned int CSlideShowDecodeAhead::GetHits() const
+{
+  CSingleLock lock(m_section);
+  return m_hits;
+}
+
+void CSlideShowDecodeAhead::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSlideShowDecodeJob *decode = static_cast<CSlideShowDecodeJob*>(job);
+  {
+    CSingleLock lock(m_section);
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->job != decode)
+        continue;
+
+      it->job = NULL;
+      it->texture = decode->TakeTexture();
+      if (it->texture)
+      {
+        it->memory = (size_t)it->texture->GetPitch() * it->texture->GetRows();
+        m_decoded += it->memory;
+        m_estimate = m_estimate ? (m_estimate + it->memory) / 2 : it->memory;
+      }
+      else
+        CLog::Log(LOGDEBUG, "CSlideShowDecodeAhead::%s - failed to decode %s", __FUNCTION__, CURL::GetRedacted(it->path).c_str());
+      break;
+    }
+  }
+  m_decodedEvent.Set();
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
+
+std::vector<CSlideShowDecodeAhead::Entry>::iterator CSlideShowDecodeAhead::Find(int number, const std::string &path)
+{
+  for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->number == number && it->path == path)
+      return it;
+  }
+  return m_entries.end();
+}
+
+bool CSlideShowDecodeAhead::IsDropped(const Slide &slide) const
+{
+  for (std::vector<Slide>::const_iterator it = m_dropped.begin(); it != m_dropped.end(); ++it)
+  {
+    if (it->number == slide.number && it->path == slide.path)
+      return true;
+  }
+  return false;
+}
+
+void CSlideShowDecodeAhead::Drop(std::vector<Entry>::iterator entry)
+{
+  // a decode that already started runs on and frees its picture when it is done, without
+  // calling back, so wake up a Take() waiting for it
+  if (entry->job)
+  {
+    CancelJob(entry->job);
+    m_decodedEvent.Set();
+  }
+  if (entry->texture)
+  {
+    m_decoded -= entry->memory;
+    delete entry->texture;
+  }
+  m_entries.erase(entry);
+}
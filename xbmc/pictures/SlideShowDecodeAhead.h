@@ -0,0 +1,113 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+class CBaseTexture;
+class CSlideShowDecodeJob;
+
+/*!
+ \ingroup windows
+ \brief Decodes the pictures around the current slide of the slideshow ahead of their display.
+
+ The slideshow tells which slides it may show next, nearest first. These are decoded on job
+ manager workers, a few at once, as long as the decoded pictures fit in the memory cap set
+ with <slideshow><decodeaheadmemory> in advancedsettings. Pictures of slides that are no
+ longer wanted are dropped. The slideshow's background loader takes the decoded pictures
+ instead of loading them itself, so stepping through an album doesn't wait for the decoder.
+ */
+class CSlideShowDecodeAhead : public CJobQueue
+{
+public:
+  struct Slide
+  {
+    int number;
+    std::string path;
+    bool loading;  ///< being loaded by the caller, a decoded picture is kept for it but none is queued
+  };
+
+  /*!
+   \param memory maximum memory in bytes of the decoded pictures.
+   */
+  explicit CSlideShowDecodeAhead(size_t memory);
+  virtual ~CSlideShowDecodeAhead();
+
+  /*!
+   \brief Set the slides to keep decoded.
+   Pictures dropped because they didn't fit in the memory cap aren't decoded again until
+   the wanted slides change.
+   \param slides the slides, nearest to the current slide first.
+   \param maxWidth maximal width the pictures are decoded at, usually the display size.
+   \param maxHeight maximal height the pictures are decoded at.
+   */
+  void Update(const std::vector<Slide> &slides, int maxWidth, int maxHeight);
+
+  /*!
+   \brief Take the decoded picture of a slide, waiting for it if it is being decoded.
+   \return the picture, owned by the caller, or NULL if the caller has to load it itself.
+   */
+  CBaseTexture *Take(int number, const std::string &path, int maxWidth, int maxHeight);
+
+  /*!
+   \brief Drop all decoded pictures and queued decodes.
+   */
+  void Clear();
+
+  /*!
+   \brief Number of pictures taken decoded.
+   */
+  unsigned int GetHits() const;
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+private:
+  struct Entry
+  {
+    int number;
+    std::string path;
+    CSlideShowDecodeJob *job;  ///< the decode, NULL once done
+    CBaseTexture *texture;     ///< the picture, NULL until decoded or if decoding failed
+    size_t memory;
+  };
+
+  std::vector<Entry>::iterator Find(int number, const std::string &path);
+  void Drop(std::vector<Entry>::iterator entry);
+  bool IsDropped(const Slide &slide) const;
+
+  size_t m_memory;
+  int m_maxWidth;
+  int m_maxHeight;
+  std::vector<Entry> m_entries;
+  std::vector<Slide> m_wanted;   ///< the slides of the last update
+  std::vector<Slide> m_dropped;  ///< slides dropped for size since the wanted slides changed
+  size_t m_decoded;      ///< memory of the decoded pictures
+  size_t m_estimate;     ///< expected memory of a picture still being decoded
+  unsigned int m_hits;
+  unsigned int m_misses;
+  mutable CCriticalSection m_section;
+  CEvent m_decodedEvent;
+};
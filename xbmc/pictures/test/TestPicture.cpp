@@ -0,0 +1,218 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "filesystem/File.h"
+#include "guilib/Texture.h"
+#include "pictures/Picture.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+uint32_t *CreateImage(unsigned int width, unsigned int height)
+{
+  uint32_t *pixels = new uint32_t[width * height];
+  for (unsigned int i = 0; i < width * height; i++)
+    pixels[i] = i;
+  return pixels;
+}
+
+// the pixel of the source that ends up at (x, y) for each EXIF orientation - 1
+uint32_t Expected(int orientation, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+  switch (orientation)
+  {
+    case 1: return y * width + (width - 1 - x);                  // flip horizontal
+    case 2: return (height - 1 - y) * width + (width - 1 - x);   // rotate 180
+    case 3: return (height - 1 - y) * width + x;                 // flip vertical
+    case 4: return x * width + y;                                // transpose
+    case 5: return (height - 1 - x) * width + y;                 // rotate 270 ccw
+    case 6: return (height - 1 - x) * width + (width - 1 - y);   // transpose off axis
+    case 7: return x * width + (width - 1 - y);                  // rotate 90 ccw
+  }
+  return 0;
+}
+
+double Seconds(int64_t start)
+{
+  return (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+}
+
+}
+
+class TestPicture : public testing::Test
+{
+protected:
+  static bool ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                         uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch,
+                         CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm)
+  {
+    return CPicture::ScaleImage(in_pixels, in_width, in_height, in_pitch,
+                                out_pixels, out_width, out_height, out_pitch, scalingAlgorithm);
+  }
+
+  static bool OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, int orientation)
+  {
+    return CPicture::OrientateImage(pixels, width, height, orientation);
+  }
+};
+
+TEST_F(TestPicture, OrientateImage)
+{
+  // odd sizes exercise the edges of the tiles and vector blocks
+  const unsigned int sizes[][2] = { { 1, 1 }, { 7, 3 }, { 37, 70 }, { 64, 64 }, { 101, 33 } };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    for (int orientation = 1; orientation <= 7; orientation++)
+    {
+      unsigned int width = sizes[s][0], height = sizes[s][1];
+      uint32_t *pixels = CreateImage(width, height);
+      ASSERT_TRUE(OrientateImage(pixels, width, height, orientation));
+
+      bool rotated = orientation >= 4;
+      EXPECT_EQ(rotated ? sizes[s][1] : sizes[s][0], width);
+      EXPECT_EQ(rotated ? sizes[s][0] : sizes[s][1], height);
+      bool match = true;
+      for (unsigned int y = 0; y < height && match; y++)
+      {
+        for (unsigned int x = 0; x < width && match; x++)
+          match = pixels[y * width + x] == Expected(orientation, sizes[s][0], sizes[s][1], x, y);
+      }
+      EXPECT_TRUE(match) << "orientation " << orientation << ", " << sizes[s][0] << "x" << sizes[s][1];
+      delete[] pixels;
+    }
+  }
+}
+
+TEST_F(TestPicture, ScaleImage)
+{
+  const unsigned int width = 64, height = 48;
+  std::vector<uint32_t> pixels(width * height, 0xff204080);
+  std::vector<uint32_t> scaled(32 * 24);
+
+  // the second call reuses the scaler of the first
+  for (int i = 0; i < 2; i++)
+  {
+    ASSERT_TRUE(ScaleImage((uint8_t *)pixels.data(), width, height, width * 4,
+                                     (uint8_t *)scaled.data(), 32, 24, 32 * 4, CPictureScalingAlgorithm::Bicubic));
+    EXPECT_EQ(0xff204080, scaled[12 * 32 + 16]);
+  }
+
+  // same size copies, honouring the pitch
+  std::vector<uint32_t> copy(width * height + 8 * height);
+  ASSERT_TRUE(ScaleImage((uint8_t *)pixels.data(), width, height, width * 4,
+                                   (uint8_t *)copy.data(), width, height, (width + 8) * 4));
+  EXPECT_EQ(0xff204080, copy[(height - 1) * (width + 8) + width - 1]);
+}
+
+TEST_F(TestPicture, CreateTiledThumb)
+{
+  const uint32_t colours[] = { 0xff102030, 0xff405060, 0xff708090, 0xffa0b0c0 };
+  std::vector<std::string> files;
+  for (unsigned int i = 0; i < 4; i++)
+  {
+    std::vector<uint32_t> pixels(64 * 64, colours[i]);
+    files.push_back(StringUtils::Format("special://temp/TestPicture%u.png", i));
+    ASSERT_TRUE(CPicture::CreateThumbnailFromSurface((unsigned char *)pixels.data(), 64, 64, 64 * 4, files.back()));
+  }
+  // a missing image leaves its tile empty
+  files.push_back("special://temp/TestPictureMissing.png");
+
+  const std::string thumb = "special://temp/TestPictureTiled.png";
+  ASSERT_TRUE(CPicture::CreateTiledThumb(files, thumb));
+  CBaseTexture *texture = CTexture::LoadFromFile(thumb);
+  ASSERT_TRUE(texture != NULL);
+
+  // 5 images are laid out 3 across, 2 down
+  unsigned int size = g_advancedSettings.m_imageRes;
+  ASSERT_EQ(size, texture->GetWidth());
+  ASSERT_EQ(size, texture->GetHeight());
+  unsigned int tileWidth = size / 3, tileHeight = size / 2;
+  for (unsigned int i = 0; i < 5; i++)
+  {
+    unsigned int x = (i % 3) * tileWidth + tileWidth / 2;
+    unsigned int y = (i / 3) * tileHeight + tileHeight / 2;
+    uint32_t pixel = *(uint32_t *)(texture->GetPixels() + y * texture->GetPitch() + x * 4);
+    EXPECT_EQ(i < 4 ? colours[i] : 0, pixel) << "tile " << i;
+  }
+  delete texture;
+
+  for (unsigned int i = 0; i < 4; i++)
+    XFILE::CFile::Delete(files[i]);
+  XFILE::CFile::Delete(thumb);
+}
+
+/* orientation and scaling of photos at common camera resolutions, as done when caching and
+ * in the slideshow. Disabled by default as it allocates about 100 MB per photo, run it with
+ * --gtest_also_run_disabled_tests */
+TEST_F(TestPicture, DISABLED_Benchmark)
+{
+  const unsigned int resolutions[][2] = { { 4000, 3000 }, { 5184, 3456 }, { 6000, 4000 } };
+  for (unsigned int r = 0; r < sizeof(resolutions) / sizeof(resolutions[0]); r++)
+  {
+    unsigned int width = resolutions[r][0], height = resolutions[r][1];
+    uint32_t *pixels = CreateImage(width, height);
+    double megapixels = (double)width * height / 1000000;
+
+    int64_t start = CurrentHostCounter();
+    ASSERT_TRUE(OrientateImage(pixels, width, height, 1));
+    double flip = Seconds(start);
+
+    start = CurrentHostCounter();
+    ASSERT_TRUE(OrientateImage(pixels, width, height, 2));
+    double rotate180 = Seconds(start);
+
+    start = CurrentHostCounter();
+    ASSERT_TRUE(OrientateImage(pixels, width, height, 7));
+    double rotate90 = Seconds(start);
+
+    // scale to the default fanart size, the first call sets up the scaler
+    std::vector<uint32_t> scaled(1920 * 1080);
+    unsigned int out_width = 1920, out_height = 1920 * height / width;
+    if (out_height > 1080)
+    {
+      out_height = 1080;
+      out_width = 1080 * width / height;
+    }
+    double scale[2];
+    for (int i = 0; i < 2; i++)
+    {
+      start = CurrentHostCounter();
+      ASSERT_TRUE(ScaleImage((uint8_t *)pixels, width, height, width * 4,
+                                       (uint8_t *)scaled.data(), out_width, out_height, out_width * 4,
+                                       CPictureScalingAlgorithm::Bicubic));
+      scale[i] = Seconds(start);
+    }
+    delete[] pixels;
+
+    printf("CPicture: %ux%u (%.0f MP), flip %.1f ms, rotate 180 %.1f ms, rotate 90 %.1f ms, scale %.1f ms (first %.1f ms)\n",
+           resolutions[r][0], resolutions[r][1], megapixels, flip * 1000, rotate180 * 1000, rotate90 * 1000,
+           scale[1] * 1000, scale[0] * 1000);
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "guilib/Texture.h"
+#include "pictures/Picture.h"
+#include "pictures/SlideShowDecodeAhead.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestSlideShowDecodeAhead : public testing::Test
+{
+protected:
+  TestSlideShowDecodeAhead()
+  {
+    std::vector<uint32_t> pixels(64 * 48, 0xff336699);
+    for (int i = 0; i < 4; i++)
+    {
+      CSlideShowDecodeAhead::Slide slide = { i, StringUtils::Format("special://temp/TestSlideShowDecodeAhead%d.png", i) };
+      CPicture::CreateThumbnailFromSurface((unsigned char *)pixels.data(), 64, 48, 64 * 4, slide.path);
+      slides.push_back(slide);
+    }
+  }
+
+  ~TestSlideShowDecodeAhead()
+  {
+    for (std::vector<CSlideShowDecodeAhead::Slide>::const_iterator it = slides.begin(); it != slides.end(); ++it)
+      XFILE::CFile::Delete(it->path);
+  }
+
+  std::vector<CSlideShowDecodeAhead::Slide> slides;
+};
+
+TEST_F(TestSlideShowDecodeAhead, TakesDecodedSlides)
+{
+  CSlideShowDecodeAhead decodeAhead(64 * 1024 * 1024);
+  decodeAhead.Update(slides, 1024, 1024);
+
+  // a queued decode is left to the caller, so wait for all of them
+  XbmcThreads::EndTime timeout(10000);
+  while (decodeAhead.IsProcessing() && !timeout.IsTimePast())
+    Sleep(10);
+
+  for (int i = 3; i >= 0; i--)
+  {
+    CBaseTexture *texture = decodeAhead.Take(i, slides[i].path, 1024, 1024);
+    ASSERT_TRUE(texture != NULL);
+    EXPECT_EQ(64U, texture->GetWidth());
+    EXPECT_EQ(48U, texture->GetHeight());
+    delete texture;
+
+    // taken slides are gone, until wanted again
+    EXPECT_TRUE(decodeAhead.Take(i, slides[i].path, 1024, 1024) == NULL);
+  }
+  EXPECT_EQ(4U, decodeAhead.GetHits());
+}
+
+TEST_F(TestSlideShowDecodeAhead, KeepsLoadingSlide)
+{
+  CSlideShowDecodeAhead decodeAhead(64 * 1024 * 1024);
+  decodeAhead.Update(slides, 1024, 1024);
+
+  XbmcThreads::EndTime timeout(10000);
+  while (decodeAhead.IsProcessing() && !timeout.IsTimePast())
+    Sleep(10);
+
+  // the caller started loading slide 0, it is kept until taken
+  std::vector<CSlideShowDecodeAhead::Slide> wanted(slides.begin(), slides.begin() + 2);
+  wanted[0].loading = true;
+  decodeAhead.Update(wanted, 1024, 1024);
+  CBaseTexture *texture = decodeAhead.Take(0, slides[0].path, 1024, 1024);
+  EXPECT_TRUE(texture != NULL);
+  delete texture;
+
+  // but isn't decoded again while it is loading
+  decodeAhead.Update(wanted, 1024, 1024);
+  EXPECT_FALSE(decodeAhead.IsProcessing());
+  EXPECT_TRUE(decodeAhead.Take(0, slides[0].path, 1024, 1024) == NULL);
+}
+
+TEST_F(TestSlideShowDecodeAhead, KeepsSlidesDroppedForSize)
+{
+  CBaseTexture *texture = CTexture::LoadFromFile(slides[0].path, 1024, 1024);
+  ASSERT_TRUE(texture != NULL);
+  size_t small = (size_t)texture->GetPitch() * texture->GetRows();
+  delete texture;
+
+  std::vector<uint32_t> pixels(256 * 192, 0xff996633);
+  CSlideShowDecodeAhead::Slide big = { 4, "special://temp/TestSlideShowDecodeAheadBig.png" };
+  CPicture::CreateThumbnailFromSurface((unsigned char *)pixels.data(), 256, 192, 256 * 4, big.path);
+
+  // room for three small pictures, the estimate then lets the big one in
+  CSlideShowDecodeAhead decodeAhead(3 * small + small / 2);
+  std::vector<CSlideShowDecodeAhead::Slide> wanted(1, slides[0]);
+  decodeAhead.Update(wanted, 1024, 1024);
+  XbmcThreads::EndTime timeout(10000);
+  while (decodeAhead.IsProcessing() && !timeout.IsTimePast())
+    Sleep(10);
+
+  wanted.push_back(big);
+  wanted.push_back(slides[1]);
+  decodeAhead.Update(wanted, 1024, 1024);
+  timeout.Set(10000);
+  while (decodeAhead.IsProcessing() && !timeout.IsTimePast())
+    Sleep(10);
+
+  // over the cap, the farthest pictures are dropped and not decoded again for the same slides
+  decodeAhead.Update(wanted, 1024, 1024);
+  decodeAhead.Update(wanted, 1024, 1024);
+  EXPECT_FALSE(decodeAhead.IsProcessing());
+  EXPECT_TRUE(decodeAhead.Take(1, slides[1].path, 1024, 1024) == NULL);
+
+  // until the wanted slides change
+  wanted.assign(1, slides[1]);
+  decodeAhead.Update(wanted, 1024, 1024);
+  timeout.Set(10000);
+  while (decodeAhead.IsProcessing() && !timeout.IsTimePast())
+    Sleep(10);
+  texture = decodeAhead.Take(1, slides[1].path, 1024, 1024);
+  EXPECT_TRUE(texture != NULL);
+  delete texture;
+
+  XFILE::CFile::Delete(big.path);
+}
+
+TEST_F(TestSlideShowDecodeAhead, DropsUnwantedSlides)
+{
+  CSlideShowDecodeAhead decodeAhead(64 * 1024 * 1024);
+  decodeAhead.Update(slides, 1024, 1024);
+
+  // slides moved or decoded at another size aren't handed out
+  EXPECT_TRUE(decodeAhead.Take(0, slides[1].path, 1024, 1024) == NULL);
+  EXPECT_TRUE(decodeAhead.Take(1, slides[1].path, 512, 512) == NULL);
+
+  std::vector<CSlideShowDecodeAhead::Slide> wanted(1, slides[2]);
+  decodeAhead.Update(wanted, 1024, 1024);
+  EXPECT_TRUE(decodeAhead.Take(3, slides[3].path, 1024, 1024) == NULL);
+
+  decodeAhead.Clear();
+  EXPECT_TRUE(decodeAhead.Take(2, slides[2].path, 1024, 1024) == NULL);
+}
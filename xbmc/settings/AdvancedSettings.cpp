@@ -167,6 +167,7 @@ void CAdvancedSettings::Initialize()
 
   m_audioDefaultPlayer = "paplayer";
   m_audioPlayCountMinimumPercent = 90.0f;
+  m_audioPrefetchTracks = 2;
 
   m_videoSubsDelayRange = 60;
   m_videoAudioDelayRange = 10;
@@ -201,6 +202,8 @@ void CAdvancedSettings::Initialize()
   m_DXVAAllowHqScaling = true;
   m_videoFpsDetect = 1;
   m_videoBusyDialogDelay_ms = 500;
+  m_videoRenderQueueDepth = 0;
+  m_videoRenderQueueMemory = 128;
   m_videoUseDroidProjectionCapture = false;
 
   m_mediacodecForceSoftwareRendring = false;
@@ -220,6 +223,12 @@ void CAdvancedSettings::Initialize()
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
   m_slideshowBlackBarCompensation = 20.0f;
+  m_slideshowDecodeAhead = 2;
+#if defined(TARGET_ANDROID)
+  m_slideshowDecodeAheadMemory = 96;
+#else
+  m_slideshowDecodeAheadMemory = 256;
+#endif
 
   m_songInfoDuration = 10;
 
@@ -304,6 +313,13 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
+  m_imageCacheRaw.clear();
+  m_imagePrefetchMemory = 64;
+#if defined(TARGET_ANDROID)
+  m_textureMemoryBudget = 256;
+#else
+  m_textureMemoryBudget = 0;
+#endif
 
   m_sambaclienttimeout = 30;
   m_sambadoscodepage = "";
@@ -550,6 +566,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "defaultplayer", m_audioDefaultPlayer);
     // 101 on purpose - can be used to never automark as watched
     XMLUtils::GetFloat(pElement, "playcountminimumpercent", m_audioPlayCountMinimumPercent, 0.0f, 101.0f);
+    XMLUtils::GetInt(pElement, "prefetchtracks", m_audioPrefetchTracks, 0, 5);
 
     XMLUtils::GetBoolean(pElement, "usetimeseeking", m_musicUseTimeSeeking);
     XMLUtils::GetInt(pElement, "timeseekforward", m_musicTimeSeekForward, 0, 6000);
@@ -738,6 +755,12 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     // the busy dialog is shown when starting video playback.
     XMLUtils::GetInt(pElement, "busydialogdelayms", m_videoBusyDialogDelay_ms, 0, 1000);
 
+    // depth of the render queue, 0 = chosen by renderer, frame rate and resolution.
+    // deeper queues keep the decoder busy while the renderer holds frames, at the cost
+    // of memory, which is limited by renderqueuememory (MB)
+    XMLUtils::GetInt(pElement, "renderqueuedepth", m_videoRenderQueueDepth, 0, 12);
+    XMLUtils::GetInt(pElement, "renderqueuememory", m_videoRenderQueueMemory, 16, 1024);
+
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
     if (pVideoLatency)
@@ -842,6 +865,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "panamount", m_slideshowPanAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "zoomamount", m_slideshowZoomAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "blackbarcompensation", m_slideshowBlackBarCompensation, 0.0f, 50.0f);
+    XMLUtils::GetUInt(pElement, "decodeahead", m_slideshowDecodeAhead, 0, 10);
+    XMLUtils::GetUInt(pElement, "decodeaheadmemory", m_slideshowDecodeAheadMemory, 0, 2048);
   }
 
   pElement = pRootElement->FirstChildElement("network");
@@ -1076,6 +1101,14 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 1080);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
+  if (XMLUtils::GetString(pRootElement, "imagecacheraw", tmp))
+  {
+    m_imageCacheRaw = StringUtils::Split(tmp, ",");
+    for (std::vector<std::string>::iterator it = m_imageCacheRaw.begin(); it != m_imageCacheRaw.end(); ++it)
+      StringUtils::Trim(*it);
+  }
+  XMLUtils::GetUInt(pRootElement, "imageprefetchmemory", m_imagePrefetchMemory, 0, 1024);
+  XMLUtils::GetUInt(pRootElement, "texturememorybudget", m_textureMemoryBudget, 0, 4096);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
 
@@ -141,6 +141,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler, CJob
     float m_ac3Gain;
     std::string m_audioDefaultPlayer;
     float m_audioPlayCountMinimumPercent;
+    int m_audioPrefetchTracks;
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
@@ -194,6 +195,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler, CJob
     bool m_DXVAAllowHqScaling;
     int  m_videoFpsDetect;
     int  m_videoBusyDialogDelay_ms;
+    int  m_videoRenderQueueDepth;
+    int  m_videoRenderQueueMemory;
     bool m_mediacodecForceSoftwareRendring;
 
     std::string m_videoDefaultPlayer;
@@ -202,6 +205,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler, CJob
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
     float m_slideshowPanAmount;
+    unsigned int m_slideshowDecodeAhead;       ///< \brief number of slides decoded ahead in each direction, 0 to disable
+    unsigned int m_slideshowDecodeAheadMemory; ///< \brief memory in MB for the slides decoded ahead
 
     int m_songInfoDuration;
     int m_logLevel;
@@ -243,6 +248,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler, CJob
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
+    std::vector<std::string> m_imageCacheRaw; ///< \brief kinds of images ("thumb", "fanart", "image", "music") cached as raw pixels rather than jpg/png
+    unsigned int m_imagePrefetchMemory; ///< \brief memory in MB containers may hold in images prefetched ahead of scrolling, 0 disables
+    unsigned int m_textureMemoryBudget; ///< \brief memory in MB for skin and image textures before unused ones are evicted early, 0 is unlimited
 
     int m_sambaclienttimeout;
     std::string m_sambadoscodepage;
@@ -44,6 +44,10 @@
 #include <cstdlib>
 #include <climits>
 
+extern "C" {
+#include "libavformat/avformat.h"
+}
+
 void TestBasicEnvironment::SetUp()
 {
   XFILE::CFile *f;
@@ -79,6 +83,9 @@ void TestBasicEnvironment::SetUp()
   g_powerManager.Initialize();
   CSettings::GetInstance().Initialize();
 
+  /* register the ffmpeg codecs and formats like CApplication::Create does */
+  av_register_all();
+
   /* Create a temporary directory and set it to be used throughout the
    * test suite run.
    */
@@ -0,0 +1,179 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "TextureCache.h"
+#include "TextureCacheJob.h"
+#include "filesystem/Directory.h"
+#include "profiles/ProfilesManager.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/TimeUtils.h"
+
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// holds its worker until released and counts the jobs running at once
+class CBlockingJob : public CJob
+{
+public:
+  CBlockingJob(std::atomic<int> &running, std::atomic<int> &peak, CEvent &release)
+    : m_running(running), m_peak(peak), m_release(release) {}
+
+  virtual bool DoWork() override
+  {
+    int running = ++m_running;
+    int peak = m_peak;
+    while (running > peak && !m_peak.compare_exchange_weak(peak, running))
+      ;
+    m_release.Wait();
+    --m_running;
+    return true;
+  }
+
+  virtual const char* GetType() const override { return "blocking"; }
+
+private:
+  std::atomic<int> &m_running;
+  std::atomic<int> &m_peak;
+  CEvent &m_release;
+};
+
+}
+
+/* the caching stages run side by side, each up to its own number of jobs,
+ * queued the way the stages are */
+TEST(TestTextureCache, StagesOverlap)
+{
+  std::atomic<int> running(0);
+  std::atomic<int> peak(0);
+  CEvent release(true);
+
+  const int stages[] = { CTextureCacheJob::STAGE_FETCH, CTextureCacheJob::STAGE_DECODE, CTextureCacheJob::STAGE_ENCODE };
+  std::vector<std::unique_ptr<CJobQueue>> queues;
+  int total = 0;
+  for (int stage : stages)
+  {
+    unsigned int jobs = CTextureCache::GetStageJobs(stage);
+    ASSERT_GT(jobs, 0U);
+    queues.emplace_back(new CJobQueue(false, jobs, CJob::PRIORITY_DEDICATED));
+    // one more than the stage runs at once, it has to wait
+    for (unsigned int i = 0; i <= jobs; i++)
+      queues.back()->AddJob(new CBlockingJob(running, peak, release));
+    total += jobs;
+  }
+
+  XbmcThreads::EndTime timeout(5000);
+  while (running < total && !timeout.IsTimePast())
+    Sleep(10);
+  // give a job beyond the limits the chance to start
+  Sleep(100);
+  EXPECT_EQ(total, peak);
+  // more than the two workers the job manager allows pausable jobs
+  EXPECT_GT(peak, 2);
+
+  release.Set();
+  timeout.Set(5000);
+  for (const std::unique_ptr<CJobQueue> &queue : queues)
+  {
+    while (queue->IsProcessing() && !timeout.IsTimePast())
+      Sleep(10);
+  }
+  EXPECT_EQ(0, running);
+}
+
+/* caching throughput over the images in the directory given with
+ * --set-texturecache-benchmark-dir, nothing is run without it. The images are
+ * cached once one after the other as the single job queue did and once through
+ * the staged CTextureCache pipeline, then cleared from the cache again. Disabled
+ * by default, run it with --gtest_also_run_disabled_tests */
+TEST(TestTextureCache, DISABLED_Benchmark)
+{
+  const std::string &dir = CXBMCTestUtils::Instance().getTextureCacheBenchmarkDir();
+  if (dir.empty())
+  {
+    printf("CTextureCache: no image directory given, skipping\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(dir, items, g_advancedSettings.m_pictureExtensions, XFILE::DIR_FLAG_NO_FILE_DIRS));
+  std::vector<std::string> images;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (!items[i]->m_bIsFolder)
+      images.push_back(items[i]->GetPath());
+  }
+  ASSERT_FALSE(images.empty());
+
+  // the test environment loads no profiles, only add one if there is none and take it away again
+  bool addProfile = CProfilesManager::GetInstance().GetNumberOfProfiles() == 0;
+  if (addProfile)
+    CProfilesManager::GetInstance().AddProfile(CProfile("special://temp/texturecache/", "benchmark", 0));
+  CProfilesManager::GetInstance().CreateProfileFolders();
+  CTextureCache::GetInstance().Initialize();
+
+  int serial = 0;
+  int64_t start = CurrentHostCounter();
+  for (const std::string &image : images)
+  {
+    CTextureCacheJob job(image);
+    if (job.CacheTexture())
+      serial++;
+  }
+  double serialSeconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  // the serial run doesn't touch the database, so everything is cached again
+  int pipelined = 0;
+  start = CurrentHostCounter();
+  for (const std::string &image : images)
+    CTextureCache::GetInstance().BackgroundCacheImage(image);
+  for (const std::string &image : images)
+  { // waits for images still in the pipeline, the few not yet started are cached right here
+    CTextureDetails details;
+    if (CTextureCache::GetInstance().CacheImage(image, details))
+      pipelined++;
+  }
+  double pipelinedSeconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  for (const std::string &image : images)
+    CTextureCache::GetInstance().ClearCachedImage(image);
+  CTextureCache::GetInstance().Deinitialize();
+  if (addProfile)
+    CProfilesManager::GetInstance().Clear();
+
+  EXPECT_EQ(serial, pipelined);
+  printf("CTextureCache: %d images, serial %.1f images/s, pipelined %.1f images/s\n", (int)images.size(),
+         serialSeconds > 0 ? serial / serialSeconds : 0, pipelinedSeconds > 0 ? pipelined / pipelinedSeconds : 0);
+}
@@ -230,6 +230,16 @@ std::vector<std::string> &CXBMCTestUtils::getGUISettingsFiles()
   return GUISettingsFiles;
 }
 
+std::vector<std::string> &CXBMCTestUtils::getVideoPlayerBenchmarkFiles()
+{
+  return VideoPlayerBenchmarkFiles;
+}
+
+std::string &CXBMCTestUtils::getTextureCacheBenchmarkDir()
+{
+  return TextureCacheBenchmarkDir;
+}
+
 static const char usage[] =
 "XBMC Test Suite\n"
 "Usage: xbmc-test [options]\n"
@@ -267,6 +277,16 @@ static const char usage[] =
 "    Add multiple GUI settings files from a ',' delimited string of\n"
 "    files to be loaded in test cases that use them.\n"
 "\n"
+"  --add-videoplayer-benchmark-file [FILE]\n"
+"    Add a media file to be decoded in the VideoPlayer benchmark tests.\n"
+"\n"
+"  --add-videoplayer-benchmark-files [FILES]\n"
+"    Add multiple media files from a ',' delimited string of files to be\n"
+"    decoded in the VideoPlayer benchmark tests.\n"
+"\n"
+"  --set-texturecache-benchmark-dir [DIR]\n"
+"    Set a directory of images to be cached in the texture cache benchmark.\n"
+"\n"
 "  --set-probability [PROBABILITY]\n"
 "    Set the probability variable used by the file corrupting functions.\n"
 "    The variable should be a double type from 0.0 to 1.0. Values given\n"
@@ -333,6 +353,22 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
       for (it = urls.begin(); it < urls.end(); ++it)
         GUISettingsFiles.push_back(*it);
     }
+    else if (arg == "--add-videoplayer-benchmark-file")
+    {
+      VideoPlayerBenchmarkFiles.push_back(argv[++i]);
+    }
+    else if (arg == "--add-videoplayer-benchmark-files")
+    {
+      arg = argv[++i];
+      std::vector<std::string> files = StringUtils::Split(arg, ",");
+      std::vector<std::string>::iterator it;
+      for (it = files.begin(); it < files.end(); ++it)
+        VideoPlayerBenchmarkFiles.push_back(*it);
+    }
+    else if (arg == "--set-texturecache-benchmark-dir")
+    {
+      TextureCacheBenchmarkDir = argv[++i];
+    }
     else if (arg == "--set-probability")
     {
       probability = atof(argv[++i]);
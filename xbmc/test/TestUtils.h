@@ -76,6 +76,12 @@ public:
   /* Function to get GUI settings files. */
   std::vector<std::string> &getGUISettingsFiles();
 
+  /* Function to get the media files used in the VideoPlayer benchmark tests. */
+  std::vector<std::string> &getVideoPlayerBenchmarkFiles();
+
+  /* Function to get the image directory used in the texture cache benchmark. */
+  std::string &getTextureCacheBenchmarkDir();
+
   /* Function used in creating a corrupted file. The parameters are a URL
    * to the original file to be corrupted and a suffix to append to the
    * path of the newly created file. This will return a XFILE::CFile
@@ -101,6 +107,8 @@ private:
 
   std::vector<std::string> AdvancedSettingsFiles;
   std::vector<std::string> GUISettingsFiles;
+  std::vector<std::string> VideoPlayerBenchmarkFiles;
+  std::string TextureCacheBenchmarkDir;
 
   double probability;
 };
@@ -310,6 +310,8 @@ CBitstreamConverter::CBitstreamConverter()
   m_convert_bitstream = false;
   m_convertBuffer     = NULL;
   m_convertSize       = 0;
+  m_annexbBuffer      = NULL;
+  m_annexbBufferSize  = 0;
   m_inputBuffer       = NULL;
   m_inputSize         = 0;
   m_to_annexb         = false;
@@ -489,10 +491,13 @@ void CBitstreamConverter::Close(void)
   if (m_sps_pps_context.sps_pps_data)
     av_free(m_sps_pps_context.sps_pps_data), m_sps_pps_context.sps_pps_data = NULL;
 
-  if (m_convertBuffer)
-    av_free(m_convertBuffer), m_convertBuffer = NULL;
+  FreeConvertBuffer();
   m_convertSize = 0;
 
+  if (m_annexbBuffer)
+    av_free(m_annexbBuffer), m_annexbBuffer = NULL;
+  m_annexbBufferSize = 0;
+
   if (m_extradata)
     av_free(m_extradata), m_extradata = NULL;
   m_extrasize = 0;
@@ -505,13 +510,17 @@ void CBitstreamConverter::Close(void)
   m_convert_3byteTo4byteNALSize = false;
 }
 
-bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
+void CBitstreamConverter::FreeConvertBuffer()
 {
-  if (m_convertBuffer)
-  {  
+  // the annex b buffer is owned separately and reused for every packet
+  if (m_convertBuffer && m_convertBuffer != m_annexbBuffer)
     av_free(m_convertBuffer);
-    m_convertBuffer = NULL;
-  }
+  m_convertBuffer = NULL;
+}
+
+bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
+{
+  FreeConvertBuffer();
   m_inputSize = 0;
   m_convertSize = 0;
   m_inputBuffer = NULL;
@@ -529,14 +538,11 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
         if (m_convert_bitstream)
         {
           // convert demuxer packet from bitstream to bytestream (AnnexB)
-          int bytestream_size = 0;
-          uint8_t *bytestream_buff = NULL;
-
-          BitstreamConvert(demuxer_content, demuxer_bytes, &bytestream_buff, &bytestream_size);
-          if (bytestream_buff && (bytestream_size > 0))
+          int bytestream_size = BitstreamConvert(demuxer_content, demuxer_bytes);
+          if (bytestream_size > 0)
           {
             m_convertSize   = bytestream_size;
-            m_convertBuffer = bytestream_buff;
+            m_convertBuffer = m_annexbBuffer;
             return true;
           }
           else
@@ -561,11 +567,7 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
   
         if (m_convert_bytestream)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
+          FreeConvertBuffer();
           m_convertSize = 0;
 
           // convert demuxer packet from bytestream (AnnexB) to bitstream
@@ -580,11 +582,7 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
         }
         else if (m_convert_3byteTo4byteNALSize)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
+          FreeConvertBuffer();
           m_convertSize = 0;
 
           // convert demuxer packet from 3 byte NAL sizes to 4 byte
@@ -851,19 +849,51 @@ bool CBitstreamConverter::IsSlice(uint8_t unit_type)
   }
 }
 
-bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size)
+int CBitstreamConverter::BitstreamConvert(const uint8_t *pData, int iSize)
+{
+  // size the output first so the packet is written in one go into a buffer
+  // that is kept across packets, no reallocations in the steady state
+  int outSize = BitstreamConvertPass(pData, iSize, NULL);
+  if (outSize <= 0)
+    return 0;
+
+  if (outSize + FF_INPUT_BUFFER_PADDING_SIZE > m_annexbBufferSize)
+  {
+    // leave some headroom so that slightly larger frames don't trigger a new allocation
+    int size = outSize + outSize / 4 + FF_INPUT_BUFFER_PADDING_SIZE;
+    uint8_t *buffer = (uint8_t*)av_malloc(size);
+    if (!buffer)
+      return 0;
+    if (m_convertBuffer == m_annexbBuffer)
+      m_convertBuffer = NULL;
+    av_free(m_annexbBuffer);
+    m_annexbBuffer = buffer;
+    m_annexbBufferSize = size;
+  }
+
+  BitstreamConvertPass(pData, iSize, m_annexbBuffer);
+  memset(m_annexbBuffer + outSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+  return outSize;
+}
+
+int CBitstreamConverter::BitstreamConvertPass(const uint8_t *pData, int iSize, uint8_t *out)
 {
   // based on h264_mp4toannexb_bsf.c (ffmpeg)
   // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
   // and Licensed GPL 2.1 or greater
 
   int i;
-  uint8_t *buf = pData;
+  const uint8_t *buf = pData;
   uint32_t buf_size = iSize;
   uint8_t  unit_type, nal_sps, nal_pps;
   int32_t  nal_size;
   uint32_t cumul_size = 0;
   const uint8_t *buf_end = buf + buf_size;
+  int out_size = 0;
+
+  // the sizing pass must not change the sps/pps insertion state
+  uint8_t first_idr = m_sps_pps_context.first_idr;
+  uint8_t idr_sps_pps_seen = m_sps_pps_context.idr_sps_pps_seen;
 
   switch (m_codec)
   {
@@ -876,13 +906,13 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
       nal_pps = HEVC_NAL_PPS;
       break;
     default:
-      return false;
+      return -1;
   }
 
   do
   {
     if (buf + m_sps_pps_context.length_size > buf_end)
-      goto fail;
+      return -1;
 
     for (nal_size = 0, i = 0; i < m_sps_pps_context.length_size; i++)
       nal_size = (nal_size << 8) | buf[i];
@@ -898,71 +928,58 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
     }
 
     if (buf + nal_size > buf_end || nal_size <= 0)
-      goto fail;
+      return -1;
 
     // Don't add sps/pps if the unit already contain them
-    if (m_sps_pps_context.first_idr && (unit_type == nal_sps || unit_type == nal_pps))
-      m_sps_pps_context.idr_sps_pps_seen = 1;
+    if (first_idr && (unit_type == nal_sps || unit_type == nal_pps))
+      idr_sps_pps_seen = 1;
 
-      // prepend only to the first access unit of an IDR picture, if no sps/pps already present
-    if (m_sps_pps_context.first_idr && IsIDR(unit_type) && !m_sps_pps_context.idr_sps_pps_seen)
+    // prepend only to the first access unit of an IDR picture, if no sps/pps already present
+    uint32_t sps_pps_size = 0;
+    if (first_idr && IsIDR(unit_type) && !idr_sps_pps_seen)
     {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size,
-        m_sps_pps_context.sps_pps_data, m_sps_pps_context.size, buf, nal_size);
-      m_sps_pps_context.first_idr = 0;
+      sps_pps_size = m_sps_pps_context.size;
+      first_idr = 0;
     }
-    else
+    else if (!first_idr && IsSlice(unit_type))
     {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size, NULL, 0, buf, nal_size);
-      if (!m_sps_pps_context.first_idr && IsSlice(unit_type))
+      first_idr = 1;
+      idr_sps_pps_seen = 0;
+    }
+
+    // 4 byte start code for the first unit of the packet, 3 bytes for the following
+    uint8_t nal_header_size = out_size ? 3 : 4;
+    if (out)
+    {
+      uint8_t *dst = out + out_size;
+      if (sps_pps_size)
+        memcpy(dst, m_sps_pps_context.sps_pps_data, sps_pps_size);
+      dst += sps_pps_size;
+      if (nal_header_size == 4)
+      {
+        BS_WB32(dst, 1);
+      }
+      else
       {
-          m_sps_pps_context.first_idr = 1;
-          m_sps_pps_context.idr_sps_pps_seen = 0;
+        dst[0] = 0;
+        dst[1] = 0;
+        dst[2] = 1;
       }
+      memcpy(dst + nal_header_size, buf, nal_size);
     }
+    out_size += sps_pps_size + nal_header_size + nal_size;
 
     buf += nal_size;
     cumul_size += nal_size + m_sps_pps_context.length_size;
   } while (cumul_size < buf_size);
 
-  return true;
-
-fail:
-  av_free(*poutbuf), *poutbuf = NULL;
-  *poutbuf_size = 0;
-  return false;
-}
-
-void CBitstreamConverter::BitstreamAllocAndCopy( uint8_t **poutbuf, int *poutbuf_size,
-    const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size)
-{
-  // based on h264_mp4toannexb_bsf.c (ffmpeg)
-  // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
-  // and Licensed GPL 2.1 or greater
-
-  uint32_t offset = *poutbuf_size;
-  uint8_t nal_header_size = offset ? 3 : 4;
-  void *tmp;
-
-  *poutbuf_size += sps_pps_size + in_size + nal_header_size;
-  tmp = av_realloc(*poutbuf, *poutbuf_size);
-  if (!tmp)
-    return;
-  *poutbuf = (uint8_t*)tmp;
-  if (sps_pps)
-    memcpy(*poutbuf + offset, sps_pps, sps_pps_size);
-
-  memcpy(*poutbuf + sps_pps_size + nal_header_size + offset, in, in_size);
-  if (!offset)
-  {
-    BS_WB32(*poutbuf + sps_pps_size, 1);
-  }
-  else
+  if (out)
   {
-    (*poutbuf + offset + sps_pps_size)[0] = 0;
-    (*poutbuf + offset + sps_pps_size)[1] = 0;
-    (*poutbuf + offset + sps_pps_size)[2] = 1;
+    m_sps_pps_context.first_idr = first_idr;
+    m_sps_pps_context.idr_sps_pps_seen = idr_sps_pps_seen;
   }
+
+  return out_size;
 }
 
 const int CBitstreamConverter::avc_parse_nal_units(AVIOContext *pb, const uint8_t *buf_in, int size)
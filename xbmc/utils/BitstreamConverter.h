@@ -180,9 +180,9 @@ protected:
   bool              IsSlice(uint8_t unit_type);
   bool              BitstreamConvertInitAVC(void *in_extradata, int in_extrasize);
   bool              BitstreamConvertInitHEVC(void *in_extradata, int in_extrasize);
-  bool              BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size);
-  static void       BitstreamAllocAndCopy(uint8_t **poutbuf, int *poutbuf_size,
-                      const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size);
+  int               BitstreamConvert(const uint8_t *pData, int iSize);
+  int               BitstreamConvertPass(const uint8_t *pData, int iSize, uint8_t *out);
+  void              FreeConvertBuffer();
 
   typedef struct omx_bitstream_ctx {
       uint8_t  length_size;
@@ -194,6 +194,8 @@ protected:
 
   uint8_t          *m_convertBuffer;
   int               m_convertSize;
+  uint8_t          *m_annexbBuffer;
+  int               m_annexbBufferSize;
   uint8_t          *m_inputBuffer;
   int               m_inputSize;
 
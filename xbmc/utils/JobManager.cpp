@@ -186,6 +186,12 @@ CJobManager::CJobManager()
   m_pauseJobs = false;
 }
 
+bool CJobManager::IsPaused() const
+{
+  CSingleLock lock(m_section);
+  return m_pauseJobs;
+}
+
 void CJobManager::Restart()
 {
   CSingleLock lock(m_section);
@@ -290,6 +290,13 @@ public:
    */
   void UnPauseJobs();
 
+  /*!
+   \brief Checks whether jobs with priority PRIORITY_LOW_PAUSABLE are currently paused
+   Lets jobs running at a higher priority hold back work that should follow the pause.
+   \sa PauseJobs()
+   */
+  bool IsPaused() const;
+
   /*!
    \brief Checks to see if any jobs with specific priority are currently processing.
    \param priority to search for
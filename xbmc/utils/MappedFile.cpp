@@ -0,0 +1,133 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MappedFile.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#ifdef TARGET_WINDOWS
+#include "platform/win32/WIN32Util.h"
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CMappedFile::CMappedFile()
+  : m_data(nullptr)
+  , m_size(0)
+#ifdef TARGET_WINDOWS
+  , m_file(INVALID_HANDLE_VALUE)
+  , m_mapping(nullptr)
+#endif
+{
+}
+
+CMappedFile::~CMappedFile()
+{
+  Close();
+}
+
+bool CMappedFile::Open(const std::string &path)
+{
+  Close();
+
+  std::string localPath = CSpecialProtocol::TranslatePath(path);
+  if (URIUtils::IsURL(localPath))
+    return false;
+
+#ifdef TARGET_WINDOWS
+  std::wstring pathW = CWIN32Util::ConvertPathToWin32Form(localPath);
+  // allow the file to be replaced or deleted while it is mapped, like on posix
+  m_file = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m_file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+  {
+    Close();
+    return false;
+  }
+
+  m_mapping = CreateFileMapping(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!m_mapping)
+  {
+    Close();
+    return false;
+  }
+
+  m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data)
+  {
+    Close();
+    return false;
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+#else
+  int fd = open(localPath.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  // the mapping keeps its own reference to the file
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    CLog::Log(LOGDEBUG, "CMappedFile::%s - failed to map %s", __FUNCTION__, localPath.c_str());
+    return false;
+  }
+
+  m_data = static_cast<const uint8_t*>(data);
+  m_size = st.st_size;
+#endif
+
+  return true;
+}
+
+void CMappedFile::Close()
+{
+#ifdef TARGET_WINDOWS
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping)
+    CloseHandle(m_mapping);
+  if (m_file != INVALID_HANDLE_VALUE)
+    CloseHandle(m_file);
+  m_mapping = nullptr;
+  m_file = INVALID_HANDLE_VALUE;
+#else
+  if (m_data)
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/*!
+ \brief Read-only memory mapping of a local file.
+
+ Paths may use the special:// protocol. Files on virtual filesystems (smb, http, ...)
+ can't be mapped and Open() fails for them, callers should fall back to XFILE::CFile.
+ */
+class CMappedFile
+{
+public:
+  CMappedFile();
+  ~CMappedFile();
+
+  bool Open(const std::string &path);
+  void Close();
+
+  bool IsOpen() const { return m_data != nullptr; }
+  const uint8_t *GetData() const { return m_data; }
+  size_t GetSize() const { return m_size; }
+
+private:
+  CMappedFile(const CMappedFile&) = delete;
+  CMappedFile& operator=(const CMappedFile&) = delete;
+
+  const uint8_t *m_data;
+  size_t m_size;
+#ifdef TARGET_WINDOWS
+  void *m_file;
+  void *m_mapping;
+#endif
+};
@@ -0,0 +1,193 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESound.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESoundCache.h"
+#include "filesystem/File.h"
+#include "threads/SystemClock.h"
+
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+
+#define TEST_SAMPLES 100
+
+class CTestSoundCache : public CActiveAESoundCache
+{
+public:
+  using CActiveAESoundCache::GetCachePath;
+};
+
+const SampleConfig g_config = { AV_SAMPLE_FMT_FLTP, AV_CH_LAYOUT_STEREO, 2, 48000, 32, 0 };
+
+void Fill(CActiveAESound &sound, bool orig, float value)
+{
+  uint8_t **data = sound.InitSound(orig, g_config, TEST_SAMPLES);
+  for (int c = 0; c < g_config.channels; c++)
+  {
+    float *plane = reinterpret_cast<float*>(data[c]);
+    for (int i = 0; i < TEST_SAMPLES; i++)
+      plane[i] = value + c;
+  }
+  sound.GetSound(orig)->nb_samples = TEST_SAMPLES;
+}
+
+// entries are written by a job, wait until one can be mapped
+bool WaitForEntry(const std::string &filename, bool orig, const CActiveAESoundCache::Conversion *conversion)
+{
+  XbmcThreads::EndTime timeout(10000);
+  while (!timeout.IsTimePast())
+  {
+    CActiveAESound sound(filename);
+    if (CActiveAESoundCache::Load(sound, orig, &g_config, conversion))
+      return true;
+    Sleep(10);
+  }
+  return false;
+}
+
+}
+
+class TestActiveAESoundCache : public testing::Test
+{
+protected:
+  TestActiveAESoundCache()
+  {
+    static const char source[] = "RIFF";
+    tmpfile = XBMC_CREATETEMPFILE(".wav");
+    tmpfile->Write(source, sizeof(source));
+    tmpfile->Flush();
+    filename = XBMC_TEMPFILEPATH(tmpfile);
+
+    conversion.quality = AE_QUALITY_MID;
+    conversion.boostCenter = 0;
+    conversion.normalize = true;
+  }
+
+  ~TestActiveAESoundCache()
+  {
+    XFILE::CFile::Delete(CTestSoundCache::GetCachePath(filename, true, g_config, conversion));
+    XFILE::CFile::Delete(CTestSoundCache::GetCachePath(filename, false, g_config, conversion));
+    XBMC_DELETETEMPFILE(tmpfile);
+  }
+
+  XFILE::CFile *tmpfile;
+  std::string filename;
+  CActiveAESoundCache::Conversion conversion;
+};
+
+TEST_F(TestActiveAESoundCache, StoreAndLoad)
+{
+  CActiveAESound sound(filename);
+  Fill(sound, true, 0.25f);
+  ASSERT_TRUE(CActiveAESoundCache::Store(sound, true));
+  ASSERT_TRUE(WaitForEntry(filename, true, NULL));
+
+  CActiveAESound cached(filename);
+  ASSERT_TRUE(CActiveAESoundCache::Load(cached, true));
+  CSoundPacket *packet = cached.GetSound(true);
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_TRUE(packet->external);
+  EXPECT_EQ(TEST_SAMPLES, packet->nb_samples);
+  EXPECT_EQ(g_config.channels, packet->config.channels);
+  EXPECT_EQ(0, memcmp(sound.GetSound(true)->data[0], packet->data[0], TEST_SAMPLES * sizeof(float)));
+  EXPECT_EQ(0, memcmp(sound.GetSound(true)->data[1], packet->data[1], TEST_SAMPLES * sizeof(float)));
+
+  // the samples must be aligned for sse mixing
+  EXPECT_EQ(0U, (uintptr_t)packet->data[0] % 16);
+  EXPECT_EQ(0U, (uintptr_t)packet->data[1] % 16);
+}
+
+TEST_F(TestActiveAESoundCache, ConvertedKeyedOnSettings)
+{
+  CActiveAESound sound(filename);
+  Fill(sound, false, 0.5f);
+  ASSERT_TRUE(CActiveAESoundCache::Store(sound, false, &conversion));
+  ASSERT_TRUE(WaitForEntry(filename, false, &conversion));
+
+  // a conversion made with other settings isn't taken
+  CActiveAESoundCache::Conversion other = conversion;
+  other.quality = AE_QUALITY_HIGH;
+  CActiveAESound cached(filename);
+  EXPECT_FALSE(CActiveAESoundCache::Load(cached, false, &g_config, &other));
+  other = conversion;
+  other.boostCenter = 3;
+  EXPECT_FALSE(CActiveAESoundCache::Load(cached, false, &g_config, &other));
+  other = conversion;
+  other.normalize = false;
+  EXPECT_FALSE(CActiveAESoundCache::Load(cached, false, &g_config, &other));
+
+  // nor one of another format
+  SampleConfig config = g_config;
+  config.sample_rate = 44100;
+  EXPECT_FALSE(CActiveAESoundCache::Load(cached, false, &config, &conversion));
+
+  EXPECT_TRUE(CActiveAESoundCache::Load(cached, false, &g_config, &conversion));
+}
+
+TEST_F(TestActiveAESoundCache, ChangedSourceInvalidates)
+{
+  CActiveAESound sound(filename);
+  Fill(sound, true, 0.75f);
+  ASSERT_TRUE(CActiveAESoundCache::Store(sound, true));
+  ASSERT_TRUE(WaitForEntry(filename, true, NULL));
+
+  // the entry records the size of the source
+  static const char more[] = "WAVEfmt ";
+  tmpfile->Write(more, sizeof(more));
+  tmpfile->Flush();
+
+  CActiveAESound cached(filename);
+  EXPECT_FALSE(CActiveAESoundCache::Load(cached, true));
+}
+
+TEST_F(TestActiveAESoundCache, RejectsTruncatedEntry)
+{
+  CActiveAESound sound(filename);
+  Fill(sound, true, 1.0f);
+  ASSERT_TRUE(CActiveAESoundCache::Store(sound, true));
+  ASSERT_TRUE(WaitForEntry(filename, true, NULL));
+
+  // cut the entry off in the middle of the samples
+  std::string path = CTestSoundCache::GetCachePath(filename, true, g_config, conversion);
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(path, false));
+  file.Truncate(file.GetLength() / 2);
+  file.Close();
+
+  CActiveAESound cached(filename);
+  EXPECT_FALSE(CActiveAESoundCache::Load(cached, true));
+}
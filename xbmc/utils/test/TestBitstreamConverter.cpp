@@ -0,0 +1,292 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/BitstreamConverter.h"
+#include "utils/TimeUtils.h"
+
+#include <stdio.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+typedef std::vector<uint8_t> Buffer;
+
+const uint8_t avcSps[] = { 0x67, 0x64, 0x00, 0x1f, 0xac };
+const uint8_t avcPps[] = { 0x68, 0xee, 0x3c, 0x80 };
+
+const uint8_t hevcVps[] = { 0x40, 0x01, 0x0c, 0x01 };
+const uint8_t hevcSps[] = { 0x42, 0x01, 0x01, 0x01, 0x60 };
+const uint8_t hevcPps[] = { 0x44, 0x01, 0xc1, 0x72 };
+
+void Append(Buffer &buf, const uint8_t *data, size_t size)
+{
+  buf.insert(buf.end(), data, data + size);
+}
+
+Buffer MakeAvcC()
+{
+  Buffer avcc = { 1, 0x64, 0x00, 0x1f, 0xff, 0xe1, 0x00, sizeof(avcSps) };
+  Append(avcc, avcSps, sizeof(avcSps));
+  avcc.push_back(1);
+  avcc.push_back(0x00);
+  avcc.push_back(sizeof(avcPps));
+  Append(avcc, avcPps, sizeof(avcPps));
+  return avcc;
+}
+
+Buffer MakeHvcC()
+{
+  Buffer hvcc(21, 0);
+  hvcc[0] = 1;
+  hvcc.push_back(0x0f); // 4 byte nal sizes
+  hvcc.push_back(3);
+  const uint8_t *units[] = { hevcVps, hevcSps, hevcPps };
+  const size_t sizes[] = { sizeof(hevcVps), sizeof(hevcSps), sizeof(hevcPps) };
+  for (int i = 0; i < 3; i++)
+  {
+    hvcc.push_back(32 + i); // VPS, SPS, PPS
+    hvcc.push_back(0x00);
+    hvcc.push_back(1);
+    hvcc.push_back(0x00);
+    hvcc.push_back(sizes[i]);
+    Append(hvcc, units[i], sizes[i]);
+  }
+  return hvcc;
+}
+
+Buffer MakeNal(uint8_t header, size_t size)
+{
+  Buffer nal(size);
+  nal[0] = header;
+  for (size_t i = 1; i < size; i++)
+    nal[i] = (uint8_t)(i * 13 + header);
+  return nal;
+}
+
+// length prefixed access unit
+Buffer MakePacket(const std::vector<Buffer> &nals)
+{
+  Buffer pkt;
+  for (const Buffer &nal : nals)
+  {
+    uint32_t size = nal.size();
+    pkt.push_back(size >> 24);
+    pkt.push_back(size >> 16);
+    pkt.push_back(size >> 8);
+    pkt.push_back(size);
+    Append(pkt, nal.data(), nal.size());
+  }
+  return pkt;
+}
+
+void AppendStartCode(Buffer &buf, bool first)
+{
+  if (first)
+    buf.push_back(0);
+  buf.push_back(0);
+  buf.push_back(0);
+  buf.push_back(1);
+}
+
+Buffer AvcParameterSets()
+{
+  Buffer ps;
+  AppendStartCode(ps, true);
+  Append(ps, avcSps, sizeof(avcSps));
+  AppendStartCode(ps, true);
+  Append(ps, avcPps, sizeof(avcPps));
+  return ps;
+}
+
+Buffer Converted(const CBitstreamConverter &converter)
+{
+  return Buffer(converter.GetConvertBuffer(), converter.GetConvertBuffer() + converter.GetConvertSize());
+}
+
+}
+
+TEST(TestBitstreamConverter, AvcToAnnexB)
+{
+  Buffer avcc = MakeAvcC();
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcc.data(), avcc.size(), true));
+  ASSERT_TRUE(converter.NeedConvert());
+
+  // parameter sets are inserted in front of the first idr slice
+  Buffer sei = MakeNal(0x06, 20);
+  Buffer idr = MakeNal(0x65, 3000);
+  Buffer pkt = MakePacket({ sei, idr });
+  ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+
+  Buffer expected;
+  AppendStartCode(expected, true);
+  Append(expected, sei.data(), sei.size());
+  Buffer ps = AvcParameterSets();
+  Append(expected, ps.data(), ps.size());
+  AppendStartCode(expected, false);
+  Append(expected, idr.data(), idr.size());
+  EXPECT_EQ(expected, Converted(converter));
+
+  // plain slice
+  Buffer slice = MakeNal(0x41, 700);
+  pkt = MakePacket({ slice });
+  ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+  expected.clear();
+  AppendStartCode(expected, true);
+  Append(expected, slice.data(), slice.size());
+  EXPECT_EQ(expected, Converted(converter));
+
+  // in-band parameter sets suppress the insertion
+  Buffer sps(avcSps, avcSps + sizeof(avcSps));
+  Buffer pps(avcPps, avcPps + sizeof(avcPps));
+  pkt = MakePacket({ sps, pps, idr });
+  ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+  expected.clear();
+  AppendStartCode(expected, true);
+  Append(expected, sps.data(), sps.size());
+  AppendStartCode(expected, false);
+  Append(expected, pps.data(), pps.size());
+  AppendStartCode(expected, false);
+  Append(expected, idr.data(), idr.size());
+  EXPECT_EQ(expected, Converted(converter));
+}
+
+TEST(TestBitstreamConverter, AvcInvalidPacket)
+{
+  Buffer avcc = MakeAvcC();
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcc.data(), avcc.size(), true));
+
+  // a truncated idr must neither produce output nor consume the parameter set insertion
+  Buffer idr = MakeNal(0x65, 100);
+  Buffer pkt = MakePacket({ idr });
+  EXPECT_FALSE(converter.Convert(pkt.data(), pkt.size() - 10));
+  EXPECT_EQ(0, converter.GetConvertSize());
+
+  ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+  Buffer expected = AvcParameterSets();
+  AppendStartCode(expected, true);
+  Append(expected, idr.data(), idr.size());
+  EXPECT_EQ(expected, Converted(converter));
+}
+
+TEST(TestBitstreamConverter, HevcToAnnexB)
+{
+  Buffer hvcc = MakeHvcC();
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_HEVC, hvcc.data(), hvcc.size(), true));
+  ASSERT_TRUE(converter.NeedConvert());
+
+  Buffer idr = MakeNal(19 << 1, 2000); // IDR_W_RADL
+  Buffer pkt = MakePacket({ idr });
+  ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+
+  Buffer expected;
+  const uint8_t *units[] = { hevcVps, hevcSps, hevcPps };
+  const size_t sizes[] = { sizeof(hevcVps), sizeof(hevcSps), sizeof(hevcPps) };
+  for (int i = 0; i < 3; i++)
+  {
+    AppendStartCode(expected, true);
+    Append(expected, units[i], sizes[i]);
+  }
+  AppendStartCode(expected, true);
+  Append(expected, idr.data(), idr.size());
+  EXPECT_EQ(expected, Converted(converter));
+}
+
+// a synthetic group of pictures, an idr followed by slices of growing size
+static std::vector<Buffer> MakeGop(uint8_t idrHeader, uint8_t sliceHeader)
+{
+  std::vector<Buffer> gop;
+  gop.push_back(MakePacket({ MakeNal(idrHeader, 60000) }));
+  for (int i = 0; i < 11; i++)
+    gop.push_back(MakePacket({ MakeNal(sliceHeader, 4000 + i * 1500), MakeNal(sliceHeader, 900) }));
+  return gop;
+}
+
+/* once the largest frame of the gop has been seen the output buffer must be
+ * reused for every packet */
+static void CheckSteadyState(AVCodecID codec, const Buffer &extradata,
+                             uint8_t idrHeader, uint8_t sliceHeader)
+{
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(codec, const_cast<uint8_t*>(extradata.data()), extradata.size(), true));
+
+  std::vector<Buffer> gop = MakeGop(idrHeader, sliceHeader);
+  for (Buffer &pkt : gop)
+    ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+
+  const uint8_t *buffer = converter.GetConvertBuffer();
+  for (int n = 0; n < 2; n++)
+  {
+    for (Buffer &pkt : gop)
+    {
+      ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+      EXPECT_EQ(buffer, converter.GetConvertBuffer());
+    }
+  }
+}
+
+static void Benchmark(AVCodecID codec, const Buffer &extradata,
+                      uint8_t idrHeader, uint8_t sliceHeader)
+{
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(codec, const_cast<uint8_t*>(extradata.data()), extradata.size(), true));
+
+  std::vector<Buffer> gop = MakeGop(idrHeader, sliceHeader);
+  for (Buffer &pkt : gop)
+    ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+
+  int64_t bytes = 0;
+  int64_t start = CurrentHostCounter();
+  for (int n = 0; n < 500; n++)
+  {
+    for (Buffer &pkt : gop)
+    {
+      ASSERT_TRUE(converter.Convert(pkt.data(), pkt.size()));
+      bytes += pkt.size();
+    }
+  }
+  double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  printf("CBitstreamConverter %s: %.1f MB/s\n",
+         codec == AV_CODEC_ID_H264 ? "avc" : "hevc",
+         seconds > 0 ? bytes / seconds / (1024 * 1024) : 0);
+}
+
+TEST(TestBitstreamConverter, AvcSteadyState)
+{
+  CheckSteadyState(AV_CODEC_ID_H264, MakeAvcC(), 0x65, 0x41);
+}
+
+TEST(TestBitstreamConverter, HevcSteadyState)
+{
+  CheckSteadyState(AV_CODEC_ID_HEVC, MakeHvcC(), 19 << 1, 1 << 1);
+}
+
+/* throughput numbers, run with --gtest_also_run_disabled_tests */
+TEST(TestBitstreamConverter, DISABLED_Benchmark)
+{
+  Benchmark(AV_CODEC_ID_H264, MakeAvcC(), 0x65, 0x41);
+  Benchmark(AV_CODEC_ID_HEVC, MakeHvcC(), 19 << 1, 1 << 1);
+}
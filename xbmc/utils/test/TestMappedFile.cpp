@@ -0,0 +1,56 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/MappedFile.h"
+#include "filesystem/File.h"
+
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+TEST(TestMappedFile, Open)
+{
+  static const char refdata[] = "abcdefghijklmnopqrstuvwxyz";
+  XFILE::CFile *tmpfile;
+
+  ASSERT_NE(nullptr, (tmpfile = XBMC_CREATETEMPFILE("")));
+  EXPECT_EQ((ssize_t)sizeof(refdata), tmpfile->Write(refdata, sizeof(refdata)));
+  tmpfile->Flush();
+
+  CMappedFile file;
+  ASSERT_TRUE(file.Open(XBMC_TEMPFILEPATH(tmpfile)));
+  EXPECT_TRUE(file.IsOpen());
+  EXPECT_EQ(sizeof(refdata), file.GetSize());
+  EXPECT_EQ(0, memcmp(refdata, file.GetData(), sizeof(refdata)));
+
+  file.Close();
+  EXPECT_FALSE(file.IsOpen());
+  EXPECT_EQ(nullptr, file.GetData());
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(tmpfile));
+}
+
+TEST(TestMappedFile, OpenURL)
+{
+  CMappedFile file;
+  EXPECT_FALSE(file.Open("http://localhost/file.bin"));
+  EXPECT_FALSE(file.IsOpen());
+}
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StreamDetailsProber.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "utils/log.h"
+#include "video/VideoInfoTag.h"
+
+#define PROBE_TIMEOUT_MS 30000
+#define PROBE_WAIT_MS    100
+
+namespace
+{
+
+class CStreamDetailsJob : public CJob
+{
+public:
+  explicit CStreamDetailsJob(const std::string &path) : m_item(path, false) {}
+
+  virtual bool DoWork() override
+  {
+    return CDVDFileInfo::GetFileStreamDetails(&m_item);
+  }
+
+  virtual const char* GetType() const override
+  {
+    return kJobTypeMediaFlags;
+  }
+
+  CFileItem m_item;
+};
+
+}
+
+CStreamDetailsProber::CStreamDetailsProber(unsigned int jobsAtOnce) :
+  CJobQueue(false, jobsAtOnce, CJob::PRIORITY_LOW)
+{
+}
+
+CStreamDetailsProber::~CStreamDetailsProber()
+{
+  CancelJobs();
+}
+
+void CStreamDetailsProber::Probe(const std::string &path)
+{
+  CStreamDetailsJob *job = new CStreamDetailsJob(path);
+  {
+    CSingleLock lock(m_resultSection);
+    if (m_results.find(path) != m_results.end())
+    {
+      delete job;
+      return;
+    }
+    m_results[path].job = job;
+    m_results[path].done = false;
+  }
+  AddJob(job);
+}
+
+bool CStreamDetailsProber::Get(const std::string &path, CStreamDetails &details, const bool &stop)
+{
+  CSingleLock lock(m_resultSection);
+  std::map<std::string, ProbeResult>::iterator it = m_results.find(path);
+  if (it == m_results.end())
+    return false;
+
+  // a probe of a file on an unresponsive share may never return, don't let it hold up the scan
+  XbmcThreads::EndTime timeout(PROBE_TIMEOUT_MS);
+  while (!it->second.done)
+  {
+    // the job can't complete while the lock is held, so it is still valid to cancel
+    if (stop)
+    {
+      CancelJobs();
+      m_results.clear();
+      return false;
+    }
+    if (timeout.IsTimePast())
+    {
+      CLog::Log(LOGWARNING, "CStreamDetailsProber::%s - giving up on %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+      CancelJob(it->second.job);
+      m_results.erase(it);
+      return false;
+    }
+
+    CSingleExit exit(m_resultSection);
+    m_resultEvent.WaitMSec(PROBE_WAIT_MS);
+  }
+
+  if (it->second.success)
+    details = it->second.details;
+  return it->second.success;
+}
+
+void CStreamDetailsProber::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CStreamDetailsJob *probe = static_cast<CStreamDetailsJob*>(job);
+  {
+    CSingleLock lock(m_resultSection);
+    std::map<std::string, ProbeResult>::iterator it = m_results.find(probe->m_item.GetPath());
+    if (it != m_results.end())
+    {
+      it->second.job = NULL;
+      it->second.done = true;
+      it->second.success = success;
+      if (success)
+        it->second.details = probe->m_item.GetVideoInfoTag()->m_streamDetails;
+      else
+        CLog::Log(LOGDEBUG, "CStreamDetailsProber::%s - failed to probe %s", __FUNCTION__, CURL::GetRedacted(probe->m_item.GetPath()).c_str());
+    }
+  }
+  m_resultEvent.Set();
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
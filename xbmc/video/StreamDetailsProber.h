@@ -0,0 +1,76 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+#include "utils/StreamDetails.h"
+
+/*!
+ \ingroup jobs
+ \brief Probes the stream details of a batch of files ahead of their use.
+
+ Paths are probed in the order they are queued, with at most a fixed number of
+ probes running at once on job manager workers. Get() hands out the result of a
+ path, waiting for its probe if it is still running, so a scanner can consume
+ the results in its own order while later files are probed in the background.
+ Results are kept until the prober is destroyed at the end of the scan, files
+ holding several episodes ask for the same path once per episode.
+ */
+class CStreamDetailsProber : public CJobQueue
+{
+public:
+  explicit CStreamDetailsProber(unsigned int jobsAtOnce);
+  virtual ~CStreamDetailsProber();
+
+  /*!
+   \brief Queue a file for probing, duplicates are ignored.
+   */
+  void Probe(const std::string &path);
+
+  /*!
+   \brief Retrieve the stream details of a queued file, blocking until its probe completed.
+   The result stays available for further calls with the same path.
+   A probe that doesn't complete in time is cancelled, as are all probes once stop is set.
+   \param path the path as passed to Probe().
+   \param details receives the stream details on success.
+   \param stop the caller's abort flag, checked while waiting.
+   \return true if the file was queued and probed successfully.
+   */
+  bool Get(const std::string &path, CStreamDetails &details, const bool &stop);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+private:
+  struct ProbeResult
+  {
+    CJob *job;  ///< the probe, NULL once done
+    bool done;
+    bool success;
+    CStreamDetails details;
+  };
+
+  CCriticalSection m_resultSection;
+  CEvent m_resultEvent;
+  std::map<std::string, ProbeResult> m_results;
+};
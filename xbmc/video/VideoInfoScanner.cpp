@@ -53,6 +53,7 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "video/VideoLibraryQueue.h"
+#include "video/StreamDetailsProber.h"
 #include "video/VideoThumbLoader.h"
 #include "VideoInfoDownloader.h"
 
@@ -62,6 +63,9 @@ using namespace KODI::MESSAGING;
 
 using KODI::MESSAGING::HELPERS::DialogResponse;
 
+// concurrent stream details probes, the job manager runs at most three low priority jobs
+#define STREAMDETAILS_PROBE_JOBS 3
+
 namespace VIDEO
 {
 
@@ -115,6 +119,10 @@ namespace VIDEO
 
       m_database.Open();
 
+      // probe stream details of new files in the background while they are scraped
+      if (CSettings::GetInstance().GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS))
+        m_streamDetailsProber.reset(new CStreamDetailsProber(STREAMDETAILS_PROBE_JOBS));
+
       m_bCanInterrupt = true;
 
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Starting scan ..");
@@ -169,6 +177,7 @@ namespace VIDEO
         }
       }
 
+      m_streamDetailsProber.reset();
       g_infoManager.ResetLibraryBools();
       m_database.Close();
 
@@ -178,6 +187,7 @@ namespace VIDEO
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      m_streamDetailsProber.reset();
     }
     
     m_bRunning = false;
@@ -416,6 +426,20 @@ namespace VIDEO
 
     m_database.Open();
 
+    if (m_streamDetailsProber && content != CONTENT_TVSHOWS)
+    {
+      for (int i = 0; i < items.Size(); ++i)
+      {
+        const CFileItemPtr &item = items[i];
+        if (item->m_bIsFolder)
+          continue;
+        if (content == CONTENT_MOVIES ? m_database.HasMovieInfo(item->GetPath())
+                                      : m_database.HasMusicVideoInfo(item->GetPath()))
+          continue;
+        m_streamDetailsProber->Probe(item->GetPath());
+      }
+    }
+
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
     for (int i = 0; i < (int)items.Size(); ++i)
@@ -1216,6 +1240,9 @@ namespace VIDEO
       art["thumb"] = "";
 
     CVideoInfoTag &movieDetails = *pItem->GetVideoInfoTag();
+    if (m_streamDetailsProber && !movieDetails.HasStreamDetails())
+      m_streamDetailsProber->Get(pItem->GetPath(), movieDetails.m_streamDetails, m_bStop);
+
     if (movieDetails.m_basePath.empty())
       movieDetails.m_basePath = pItem->GetBaseMoviePath(videoFolder);
     movieDetails.m_parentPathID = m_database.AddPath(URIUtils::GetParentPath(movieDetails.m_basePath));
@@ -1485,6 +1512,15 @@ namespace VIDEO
     EPISODELIST episodes;
     bool hasEpisodeGuide = false;
 
+    if (m_streamDetailsProber)
+    {
+      for (EPISODELIST::const_iterator file = files.begin(); file != files.end(); ++file)
+      {
+        if (!file->isFolder && m_database.GetEpisodeId(file->strPath, file->iEpisode, file->iSeason) < 0)
+          m_streamDetailsProber->Probe(file->strPath);
+      }
+    }
+
     int iMax = files.size();
     int iCurr = 1;
     for (EPISODELIST::iterator file = files.begin(); file != files.end(); ++file)
@@ -19,6 +19,7 @@
  *
  */
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -28,6 +29,8 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 
+class CStreamDetailsProber;
+
 class CRegExp;
 class CFileItem;
 class CFileItemList;
@@ -254,6 +257,7 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+    std::unique_ptr<CStreamDetailsProber> m_streamDetailsProber;
   };
 }
 
@@ -259,6 +259,21 @@ int64_t CVideoReferenceClock::GetTime(bool interpolated /* = true*/)
   }
 }
 
+//system time of the last vblank, 0 when the clock doesn't run from vblank
+int64_t CVideoReferenceClock::GetVblankTime()
+{
+  CSingleLock SingleLock(m_CritSection);
+
+  if (!m_UseVblank)
+    return 0;
+
+  int64_t Now = CurrentHostCounter();
+  while (Now >= TimeOfNextVblank())
+    UpdateClock(1, false);
+
+  return m_VblankTime;
+}
+
 void CVideoReferenceClock::SetSpeed(double Speed)
 {
   CSingleLock SingleLock(m_CritSection);
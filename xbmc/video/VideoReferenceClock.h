@@ -31,6 +31,7 @@ class CVideoReferenceClock : public CThread
     virtual ~CVideoReferenceClock();
 
     int64_t GetTime(bool interpolated = true);
+    int64_t GetVblankTime();
     void    SetSpeed(double Speed);
     double  GetSpeed();
     double  GetRefreshRate(double* interval = nullptr);
@@ -184,8 +184,12 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+// extraction jobs decode a single keyframe each, run as many of them at once as the
+// job manager grants low pausable jobs
+#define THUMB_EXTRACT_JOBS 2
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, THUMB_EXTRACT_JOBS, CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -209,6 +213,7 @@ void CVideoThumbLoader::OnLoaderFinish()
   m_videoDatabase->Close();
   m_showArt.clear();
   m_seasonArt.clear();
+  CDVDFileInfo::FlushThumbDecoders();
   CThumbLoader::OnLoaderFinish();
 }
 